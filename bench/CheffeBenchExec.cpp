@@ -0,0 +1,466 @@
+#include "Driver/CheffeDriver.h"
+#include "IR/CheffeProgramInfo.h"
+#include "JIT/CheffeJIT.h"
+#include "Utils/CheffeDiagnosticHandler.h"
+#include "Utils/CheffeFileHandler.h"
+#include "Utils/CheffeJSON.h"
+
+#ifdef CHEFFE_ALLOCATION_COUNTING
+#include "CheffeAllocationCounter.h"
+#endif
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+using namespace cheffe;
+
+static void printUsage()
+{
+  // clang-format off
+  std::cout << "OVERVIEW: cheffe execution engine benchmark" << std::endl
+            << std::endl
+            << "usage: cheffe_bench_exec [options]" << std::endl
+            << std::endl
+            << "Runs a microbenchmark for each kind of method step, and "
+               "scaled-up programs" << std::endl
+            << "from the test corpus, and writes the time and heap "
+               "allocations per executed" << std::endl
+            << "method step as JSON." << std::endl
+            << std::endl
+            << "OPTIONS" << std::endl
+            << "  -filter <text>       Only run benchmarks whose name "
+                                       "contains this" << std::endl
+            << "  -scale <n>           Multiply every workload's size by this"
+                                       << std::endl
+            << "                       Default: 1" << std::endl
+            << "  -iterations <n>      Number of timed runs of each; the best "
+                                       "is reported" << std::endl
+            << "                       Default: 5" << std::endl
+            << "  -help                Print usage and exit" << std::endl
+            << std::endl;
+  // clang-format on
+}
+
+namespace
+{
+
+// Swallows everything written to it, without ever touching the heap, so that
+// serving output costs the formatting and nothing else.
+struct NullStreamBuffer : public std::streambuf
+{
+protected:
+  int overflow(int C) override
+  {
+    return C;
+  }
+
+  std::streamsize xsputn(const char *, std::streamsize Count) override
+  {
+    return Count;
+  }
+};
+
+struct Workload
+{
+  std::string Name;
+  std::string Source;
+};
+
+} // end anonymous namespace
+
+// Spells out a number in letters, since identifiers can't contain digits.
+static std::string getLetterName(unsigned Number)
+{
+  std::string Name;
+  do
+  {
+    Name += static_cast<char>('a' + Number % 26);
+    Number /= 26;
+  } while (Number);
+  return Name;
+}
+
+// A program whose main recipe runs Setup once, then Body Rounds times. The
+// main recipe has 'one', 'two' and a liquid 'sink' to fold things into, on
+// top of the given ingredients; any recipes it serves go in Extra.
+static std::string makeLoopProgram(const unsigned Rounds,
+                                   const std::string &Ingredients,
+                                   const std::string &Setup,
+                                   const std::string &Body,
+                                   const std::string &Extra = "",
+                                   const unsigned Serves = 0)
+{
+  std::ostringstream OS;
+  OS << "Benchmark.\n\n"
+     << "Ingredients.\n"
+     << Rounds << " g rounds\n"
+     << "1 g one\n"
+     << "2 g two\n"
+     << "0 ml sink\n"
+     << Ingredients << "\n"
+     << "Method.\n"
+     << Setup << "Sift the rounds.\n"
+     << Body << "Sift the rounds until sifted.\n";
+  if (Serves)
+  {
+    OS << "\nServes " << Serves << ".\n";
+  }
+  if (!Extra.empty())
+  {
+    OS << "\n" << Extra;
+  }
+  return OS.str();
+}
+
+// The ingredient and steps to put Count items into the first mixing bowl.
+static std::string makeFillIngredient(const unsigned Count)
+{
+  return std::to_string(Count) + " g fill\n";
+}
+
+static const char *const FillSteps = "Chop the fill.\n"
+                                     "Put one into the mixing bowl.\n"
+                                     "Chop the fill until chopped.\n";
+
+static std::string repeat(const std::string &Text, const unsigned Count)
+{
+  std::string Result;
+  for (unsigned i = 0; i < Count; ++i)
+  {
+    Result += Text;
+  }
+  return Result;
+}
+
+static void addMicroWorkloads(std::vector<Workload> &Workloads,
+                              const unsigned Scale)
+{
+  const unsigned Rounds = 100000 * Scale;
+
+  Workloads.push_back(
+      {"put_fold",
+       makeLoopProgram(Rounds, "", "",
+                       repeat("Put one into the mixing bowl.\n"
+                              "Fold two into the mixing bowl.\n",
+                              4))});
+
+  // 'two' comes out of each round as it went in: (2 + 1 - 1) * 2 / 2.
+  Workloads.push_back(
+      {"arithmetic", makeLoopProgram(Rounds, "", "",
+                                     "Put two into the mixing bowl.\n"
+                                     "Add one to the mixing bowl.\n"
+                                     "Remove one from the mixing bowl.\n"
+                                     "Combine two into the mixing bowl.\n"
+                                     "Divide two into the mixing bowl.\n"
+                                     "Fold two into the mixing bowl.\n")});
+
+  // Stirring moves the top item down the whole bowl.
+  for (const unsigned Size : {16u, 256u, 4096u})
+  {
+    Workloads.push_back(
+        {"stir_bowl_" + std::to_string(Size),
+         makeLoopProgram(Rounds * 16 / Size, makeFillIngredient(Size),
+                         FillSteps, "Stir the mixing bowl for " +
+                                        std::to_string(Size) + " minutes.\n")});
+  }
+
+  Workloads.push_back(
+      {"stir_ingredient_16",
+       makeLoopProgram(Rounds, makeFillIngredient(16) + "16 g depth\n",
+                       FillSteps, "Stir depth into the mixing bowl.\n")});
+
+  Workloads.push_back(
+      {"pour_64", makeLoopProgram(Rounds / 16, makeFillIngredient(64),
+                                  FillSteps, "Pour contents of the mixing "
+                                             "bowl into the baking dish.\n")});
+
+  Workloads.push_back({"mix_64", makeLoopProgram(Rounds / 16,
+                                                 makeFillIngredient(64),
+                                                 FillSteps,
+                                                 "Mix the mixing bowl well.\n")});
+
+  std::string DryIngredients;
+  for (unsigned i = 0; i < 256; ++i)
+  {
+    DryIngredients += "1 g dry " + getLetterName(i) + "\n";
+  }
+  Workloads.push_back(
+      {"add_dry_256",
+       makeLoopProgram(Rounds / 16, DryIngredients, "",
+                       "Add dry ingredients to the mixing bowl.\n"
+                       "Fold sink into the mixing bowl.\n")});
+
+  // The served recipe gets a copy of the caller's bowls, so the cost of a
+  // Serve grows with what the caller has in them.
+  const std::string EmptyPlate = "Empty Plate.\n\n"
+                                 "Ingredients.\n"
+                                 "1 g crumb\n\n"
+                                 "Method.\n"
+                                 "Clean the mixing bowl.\n";
+  for (const unsigned Size : {0u, 64u, 4096u})
+  {
+    Workloads.push_back(
+        {"serve_bowl_" + std::to_string(Size),
+         makeLoopProgram(Rounds / (1 + Size / 64), makeFillIngredient(Size),
+                         FillSteps, "Serve with Empty Plate.\n",
+                         EmptyPlate)});
+  }
+
+  // Countdown serves itself until the number handed to it reaches zero.
+  const std::string Countdown = "Countdown.\n\n"
+                                "Ingredients.\n"
+                                "1 g one\n"
+                                "0 g n\n\n"
+                                "Method.\n"
+                                "Fold n into the mixing bowl.\n"
+                                "Sift the n.\n"
+                                "Put n into the mixing bowl.\n"
+                                "Remove one from the mixing bowl.\n"
+                                "Serve with Countdown.\n"
+                                "Set aside.\n"
+                                "Sift until sifted.\n"
+                                "Clean the mixing bowl.\n";
+  for (const unsigned Depth : {16u, 256u, 2048u})
+  {
+    Workloads.push_back(
+        {"recursion_" + std::to_string(Depth),
+         makeLoopProgram(Rounds / Depth, std::to_string(Depth) + " g depth\n",
+                         "", "Put depth into the mixing bowl.\n"
+                             "Serve with Countdown.\n"
+                             "Fold sink into the mixing bowl.\n",
+                         Countdown)});
+  }
+
+  // Everything poured into the baking dish is written out when the recipe
+  // finishes.
+  Workloads.push_back(
+      {"serve_output_numbers",
+       makeLoopProgram(Rounds, "1234567 g number\n", "",
+                       "Put number into the mixing bowl.\n"
+                       "Pour contents of the mixing bowl into the baking "
+                       "dish.\n"
+                       "Clean the mixing bowl.\n",
+                       "", 1)});
+  Workloads.push_back(
+      {"serve_output_chars",
+       makeLoopProgram(Rounds, "65 ml letter\n", "",
+                       "Put letter into the mixing bowl.\n"
+                       "Pour contents of the mixing bowl into the baking "
+                       "dish.\n"
+                       "Clean the mixing bowl.\n",
+                       "", 1)});
+}
+
+// Reads a program from the test corpus, replacing one of its ingredient
+// lines to make it do more work.
+static bool addCorpusWorkload(std::vector<Workload> &Workloads,
+                              const std::string &Name, const char *FileName,
+                              const std::vector<std::pair<std::string,
+                                                          std::string>> &Lines)
+{
+  CheffeSourceFile File;
+  if (CheffeFileHandler::readFile(std::string(TEST_ROOT_PATH) +
+                                      "/JITExecution/" + FileName,
+                                  File) != CheffeErrorCode::CHEFFE_SUCCESS)
+  {
+    std::cerr << "Could not read '" << FileName << "'" << std::endl;
+    return false;
+  }
+
+  std::string Source = File.getSource().str();
+  for (const auto &Line : Lines)
+  {
+    const std::size_t Pos = Source.find("\n" + Line.first + "\n");
+    if (Pos == std::string::npos)
+    {
+      std::cerr << "Could not find '" << Line.first << "' in '" << FileName
+                << "'" << std::endl;
+      return false;
+    }
+    Source.replace(Pos + 1, Line.first.size(), Line.second);
+  }
+
+  Workloads.push_back({Name, Source});
+  return true;
+}
+
+static bool addMacroWorkloads(std::vector<Workload> &Workloads,
+                              const unsigned Scale)
+{
+  const std::string Bottles = std::to_string(10000 * Scale);
+  // FizzBuzz works out each remainder by counting down, so it's quadratic.
+  const std::string Numbers = std::to_string(1000 * Scale);
+  const std::string Flour = std::to_string(300000 * Scale);
+
+  // Any sugar but 1 would overflow long before the flour runs out.
+  return addCorpusWorkload(Workloads, "bottles_" + Bottles, "99-bottles.ch",
+                           {{"99 bottles", Bottles + " bottles"}}) &&
+         addCorpusWorkload(Workloads, "fizzbuzz_" + Numbers, "fizzbuzz.ch",
+                           {{"20 l buttermilk", Numbers + " l buttermilk"}}) &&
+         addCorpusWorkload(Workloads, "exp_" + Flour, "exp.ch",
+                           {{"6 kg flour", Flour + " kg flour"},
+                            {"3 g sugar", "1 g sugar"}});
+}
+
+static bool runWorkload(JSONWriter &Writer, const Workload &Work,
+                        const unsigned Iterations)
+{
+  const CheffeSourceFile File(
+      CheffeSourceBuffer::getMemBuffer(Work.Name, Work.Source));
+
+  auto Diagnostics = std::make_shared<CheffeDiagnosticHandler>();
+  Diagnostics->setSourceFile(File);
+
+  CheffeDriver Driver;
+  Driver.setSourceFile(File);
+  Driver.setDiagnosticHandler(Diagnostics);
+
+  std::unique_ptr<CheffeProgramInfo> ProgramInfo;
+  if (Driver.compileProgram(ProgramInfo) != CheffeErrorCode::CHEFFE_SUCCESS)
+  {
+    Diagnostics->flushDiagnostics();
+    std::cerr << "Failed to compile workload '" << Work.Name << "'"
+              << std::endl;
+    return false;
+  }
+
+  CheffeJIT JIT(std::move(ProgramInfo), Diagnostics);
+
+  // One untimed run warms up the JIT's pooled bowls and dishes, as a program
+  // that's run repeatedly would find them. Every run dispatches the same
+  // steps, so they're counted on this one, keeping counting out of the timed
+  // runs.
+  NullStreamBuffer NullBuffer;
+  std::streambuf *OldOutputStream = std::cout.rdbuf(&NullBuffer);
+
+  CheffeWorkCounts Counts;
+  JIT.setWorkCounts(&Counts);
+  bool Success = JIT.executeProgram() == CheffeErrorCode::CHEFFE_SUCCESS;
+  JIT.setWorkCounts(nullptr);
+  const unsigned long long Steps = Counts.getNumStepsDispatched();
+  double BestSeconds = 0.0;
+#ifdef CHEFFE_ALLOCATION_COUNTING
+  std::size_t Allocations = 0;
+#endif
+  for (unsigned Iteration = 0; Success && Iteration < Iterations; ++Iteration)
+  {
+#ifdef CHEFFE_ALLOCATION_COUNTING
+    const std::size_t AllocationsBefore = getAllocationCount();
+#endif
+    const auto Start = std::chrono::steady_clock::now();
+    Success = JIT.executeProgram() == CheffeErrorCode::CHEFFE_SUCCESS;
+    const std::chrono::duration<double> Elapsed =
+        std::chrono::steady_clock::now() - Start;
+#ifdef CHEFFE_ALLOCATION_COUNTING
+    Allocations += getAllocationCount() - AllocationsBefore;
+#endif
+
+    if (Iteration == 0 || Elapsed.count() < BestSeconds)
+    {
+      BestSeconds = Elapsed.count();
+    }
+  }
+
+  std::cout.rdbuf(OldOutputStream);
+  if (!Success)
+  {
+    Diagnostics->flushDiagnostics();
+    std::cerr << "Failed to execute workload '" << Work.Name << "'"
+              << std::endl;
+    return false;
+  }
+
+  Writer.objectBegin();
+  Writer.attribute("name");
+  Writer.value(Work.Name);
+  Writer.attribute("steps");
+  Writer.value(Steps);
+  Writer.attribute("best_ms");
+  Writer.value(BestSeconds * 1000.0);
+  Writer.attribute("ns_per_step");
+  Writer.value(BestSeconds * 1e9 / Steps);
+  Writer.attribute("allocations_per_step");
+#ifdef CHEFFE_ALLOCATION_COUNTING
+  Writer.value(static_cast<double>(Allocations) / Iterations / Steps);
+#else
+  Writer.nullValue();
+#endif
+  Writer.objectEnd();
+  return true;
+}
+
+int main(int argc, char **argv)
+{
+  const char *Filter = "";
+  unsigned Scale = 1;
+  unsigned Iterations = 5;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (!std::strcmp(argv[i], "-help"))
+    {
+      printUsage();
+      return 0;
+    }
+    if (!std::strcmp(argv[i], "-filter") && i != argc - 1)
+    {
+      Filter = argv[++i];
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-scale") && i != argc - 1)
+    {
+      Scale = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-iterations") && i != argc - 1)
+    {
+      Iterations = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    std::cerr << "Unknown option '" << argv[i] << "'" << std::endl;
+    return 1;
+  }
+
+  if (Scale == 0 || Iterations == 0)
+  {
+    std::cerr << "Scale and iteration count must be positive" << std::endl;
+    return 1;
+  }
+
+  std::vector<Workload> Workloads;
+  addMicroWorkloads(Workloads, Scale);
+  if (!addMacroWorkloads(Workloads, Scale))
+  {
+    return 1;
+  }
+
+  JSONWriter Writer(std::cout);
+  Writer.objectBegin();
+  Writer.attribute("benchmark");
+  Writer.value("exec");
+  Writer.attribute("iterations");
+  Writer.value(Iterations);
+  Writer.attribute("results");
+  Writer.arrayBegin();
+  for (const Workload &Work : Workloads)
+  {
+    if (Work.Name.find(Filter) == std::string::npos)
+    {
+      continue;
+    }
+    if (!runWorkload(Writer, Work, Iterations))
+    {
+      return 1;
+    }
+  }
+  Writer.arrayEnd();
+  Writer.objectEnd();
+  std::cout << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,399 @@
+#include "CheffeRecipeGenerator.h"
+#include "Driver/CheffeDriver.h"
+#include "IR/CheffeProgramInfo.h"
+#include "Lexer/CheffeLexer.h"
+#include "Parser/CheffeParser.h"
+#include "Parser/CheffeScopeInfo.h"
+#include "Utils/CheffeDiagnosticHandler.h"
+#include "Utils/CheffeFileHandler.h"
+#include "Utils/CheffeJSON.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace cheffe;
+
+static void printUsage()
+{
+  // clang-format off
+  std::cout << "OVERVIEW: cheffe front-end throughput benchmark" << std::endl
+            << std::endl
+            << "usage: cheffe_bench_frontend [options]" << std::endl
+            << std::endl
+            << "Times the lexer, the parser, the parser's loop fixup and the "
+               "whole of" << std::endl
+            << "compilation, separately, on generated programs, and writes "
+               "the results" << std::endl
+            << "as JSON." << std::endl
+            << std::endl
+            << "OPTIONS" << std::endl
+            << "  -size <n>[K|M]       Size of a program to generate; may be "
+                                       "given more" << std::endl
+            << "                       than once, from 1K to 100M"
+                                       << std::endl
+            << "                       Default: 1K, 64K, 1M and 16M"
+                                       << std::endl
+            << "  -recipes <n>         Number of recipes to split each "
+                                       "program into" << std::endl
+            << "                       Default: one per 4KB" << std::endl
+            << "  -ingredients <n>     Ingredients per recipe" << std::endl
+            << "                       Default: 16" << std::endl
+            << "  -loop-depth <n>      How deeply verb loops are nested"
+                                       << std::endl
+            << "                       Default: 2" << std::endl
+            << "  -seed <n>            Seed for the generator" << std::endl
+            << "                       Default: 0" << std::endl
+            << "  -iterations <n>      Number of samples of each phase"
+                                       << std::endl
+            << "                       Default: 5" << std::endl
+            << "  -help                Print usage and exit" << std::endl
+            << std::endl;
+  // clang-format on
+}
+
+// Parses a byte count, with an optional K or M suffix.
+static bool parseSize(const char *Arg, std::size_t &Size)
+{
+  char *End = nullptr;
+  Size = std::strtoul(Arg, &End, 10);
+  if (End == Arg)
+  {
+    return false;
+  }
+  if (*End == 'K' || *End == 'k')
+  {
+    Size <<= 10;
+    ++End;
+  }
+  else if (*End == 'M' || *End == 'm')
+  {
+    Size <<= 20;
+    ++End;
+  }
+  return *End == '\0' && Size != 0;
+}
+
+namespace
+{
+
+struct PhaseResult
+{
+  const char *Name;
+  double BestSeconds;
+  double MeanSeconds;
+};
+
+// The loop structure of one parsed recipe, replayed onto fresh method steps
+// so that the fixup can be timed on its own.
+struct ScopeReplay
+{
+  std::unique_ptr<CheffeProgramInfo> ProgramInfo;
+  CheffeRecipeInfo *Recipe;
+  CheffeScopeInfo Scopes;
+};
+
+} // end anonymous namespace
+
+// Runs Work Iterations times, in batches of Repeat, and returns the best and
+// mean time that one run took. Small programs are run in batches, so that
+// each sample is long enough to time.
+static PhaseResult timePhase(const char *Name, const unsigned Iterations,
+                             const unsigned Repeat,
+                             const std::function<bool()> &Work)
+{
+  PhaseResult Result = {Name, 0.0, 0.0};
+  for (unsigned Iteration = 0; Iteration < Iterations; ++Iteration)
+  {
+    const auto Start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < Repeat; ++i)
+    {
+      if (!Work())
+      {
+        std::cerr << "The generated program failed in phase '" << Name << "'"
+                  << std::endl;
+        std::exit(1);
+      }
+    }
+    const std::chrono::duration<double> Elapsed =
+        std::chrono::steady_clock::now() - Start;
+    const double Seconds = Elapsed.count() / Repeat;
+
+    if (Iteration == 0 || Seconds < Result.BestSeconds)
+    {
+      Result.BestSeconds = Seconds;
+    }
+    Result.MeanSeconds += Seconds / Iterations;
+  }
+  return Result;
+}
+
+static std::unique_ptr<CheffeProgramInfo>
+parseProgram(const CheffeSourceFile &File)
+{
+  auto Diagnostics = std::make_shared<CheffeDiagnosticHandler>();
+  Diagnostics->setSourceFile(File);
+
+  CheffeParser Parser;
+  Parser.setSourceFile(File);
+  Parser.setDiagnosticHandler(Diagnostics);
+  if (Parser.parseProgram() != CheffeErrorCode::CHEFFE_SUCCESS)
+  {
+    return nullptr;
+  }
+  return Parser.takeProgramInfo();
+}
+
+// Builds, for every recipe in the program, a recipe with method steps of the
+// same kinds and the scopes the parser would have recorded for them.
+static std::vector<ScopeReplay>
+replayScopes(const CheffeProgramInfo &ProgramInfo)
+{
+  std::vector<ScopeReplay> Replays(ProgramInfo.getNumRecipes());
+  for (unsigned i = 0; i < ProgramInfo.getNumRecipes(); ++i)
+  {
+    ScopeReplay &Replay = Replays[i];
+    Replay.ProgramInfo.reset(new CheffeProgramInfo());
+    Replay.Recipe = Replay.ProgramInfo->addRecipe("Replayed Recipe");
+
+    for (const CheffeMethodStep *MS : ProgramInfo.getRecipe(i)->getMethodSteps())
+    {
+      CheffeMethodStep *Step =
+          Replay.Recipe->addNewMethodStep(MS->getMethodStepKind());
+      CheffeScope *Scope = nullptr;
+      switch (MS->getMethodStepKind())
+      {
+      default:
+        break;
+      case MethodStepKind::Verb:
+        Replay.Scopes.addScope("", Step);
+        break;
+      case MethodStepKind::UntilVerbed:
+        Replay.Scopes.popScope(&Scope);
+        Scope->EndScope = Step;
+        break;
+      case MethodStepKind::SetAside:
+        Replay.Scopes.addBreak(Step);
+        break;
+      }
+    }
+  }
+  return Replays;
+}
+
+static void writeResults(JSONWriter &Writer, const GeneratorShape &Shape,
+                         const CheffeSourceFile &File,
+                         const std::size_t TokenCount,
+                         const CheffeProgramInfo &ProgramInfo,
+                         const std::vector<PhaseResult> &Phases)
+{
+  std::size_t MethodStepCount = 0;
+  for (unsigned i = 0; i < ProgramInfo.getNumRecipes(); ++i)
+  {
+    MethodStepCount += ProgramInfo.getRecipe(i)->getMethodSteps().size();
+  }
+
+  const double MegaBytes = static_cast<double>(File.size()) / (1 << 20);
+
+  Writer.objectBegin();
+  Writer.attribute("input");
+  Writer.objectBegin();
+  Writer.attribute("target_bytes");
+  Writer.value(Shape.TargetSize);
+  Writer.attribute("bytes");
+  Writer.value(File.size());
+  Writer.attribute("recipes");
+  Writer.value(ProgramInfo.getNumRecipes());
+  Writer.attribute("ingredients_per_recipe");
+  Writer.value(Shape.IngredientsPerRecipe);
+  Writer.attribute("loop_depth");
+  Writer.value(Shape.LoopDepth);
+  Writer.attribute("seed");
+  Writer.value(Shape.Seed);
+  Writer.attribute("tokens");
+  Writer.value(TokenCount);
+  Writer.attribute("method_steps");
+  Writer.value(MethodStepCount);
+  Writer.objectEnd();
+
+  Writer.attribute("phases");
+  Writer.objectBegin();
+  for (const PhaseResult &Phase : Phases)
+  {
+    Writer.attribute(Phase.Name);
+    Writer.objectBegin();
+    Writer.attribute("best_ms");
+    Writer.value(Phase.BestSeconds * 1000.0);
+    Writer.attribute("mean_ms");
+    Writer.value(Phase.MeanSeconds * 1000.0);
+    Writer.attribute("mb_per_second");
+    Writer.value(MegaBytes / Phase.BestSeconds);
+    Writer.objectEnd();
+  }
+  Writer.objectEnd();
+  Writer.objectEnd();
+}
+
+int main(int argc, char **argv)
+{
+  std::vector<std::size_t> Sizes;
+  GeneratorShape Shape;
+  unsigned Iterations = 5;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (!std::strcmp(argv[i], "-help"))
+    {
+      printUsage();
+      return 0;
+    }
+    if (!std::strcmp(argv[i], "-size") && i != argc - 1)
+    {
+      std::size_t Size = 0;
+      if (!parseSize(argv[++i], Size) || Size > (100u << 20))
+      {
+        std::cerr << "Invalid size '" << argv[i] << "'" << std::endl;
+        return 1;
+      }
+      Sizes.push_back(Size);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-recipes") && i != argc - 1)
+    {
+      Shape.RecipeCount = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-ingredients") && i != argc - 1)
+    {
+      Shape.IngredientsPerRecipe = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-loop-depth") && i != argc - 1)
+    {
+      Shape.LoopDepth = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-seed") && i != argc - 1)
+    {
+      Shape.Seed = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-iterations") && i != argc - 1)
+    {
+      Iterations = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    std::cerr << "Unknown option '" << argv[i] << "'" << std::endl;
+    return 1;
+  }
+
+  if (Iterations == 0 || Shape.IngredientsPerRecipe == 0)
+  {
+    std::cerr << "Iteration and ingredient counts must be positive"
+              << std::endl;
+    return 1;
+  }
+
+  if (Sizes.empty())
+  {
+    Sizes = {1u << 10, 64u << 10, 1u << 20, 16u << 20};
+  }
+
+  JSONWriter Writer(std::cout);
+  Writer.objectBegin();
+  Writer.attribute("benchmark");
+  Writer.value("frontend");
+  Writer.attribute("iterations");
+  Writer.value(Iterations);
+  Writer.attribute("results");
+  Writer.arrayBegin();
+
+  for (const std::size_t Size : Sizes)
+  {
+    Shape.TargetSize = Size;
+    const CheffeSourceFile File(CheffeSourceBuffer::getMemBuffer(
+        "<generated>", generateShapedProgram(Shape)));
+    const unsigned Repeat =
+        static_cast<unsigned>(std::max<std::size_t>(1, (1 << 20) / File.size()));
+
+    std::unique_ptr<CheffeProgramInfo> ProgramInfo = parseProgram(File);
+    if (!ProgramInfo)
+    {
+      std::cerr << "Failed to parse the generated program" << std::endl;
+      return 1;
+    }
+
+    std::vector<PhaseResult> Phases;
+
+    std::size_t TokenCount = 0;
+    Phases.push_back(timePhase("lex", Iterations, Repeat, [&]()
+    {
+      CheffeLexer Lexer;
+      Lexer.setSourceFile(File);
+      TokenCount = 0;
+      while (Lexer.getToken().isNot(TokenKind::EndOfFile))
+      {
+        ++TokenCount;
+      }
+      return true;
+    }));
+
+    Phases.push_back(timePhase("parse", Iterations, Repeat, [&]()
+    {
+      return parseProgram(File) != nullptr;
+    }));
+
+    // Each fixup adds operands to the method steps, so each sample needs
+    // steps of its own. Only the fixup itself is timed.
+    PhaseResult Fixup = {"scope_fixup", 0.0, 0.0};
+    for (unsigned Iteration = 0; Iteration < Iterations; ++Iteration)
+    {
+      std::vector<std::vector<ScopeReplay>> Samples;
+      for (unsigned i = 0; i < Repeat; ++i)
+      {
+        Samples.push_back(replayScopes(*ProgramInfo));
+      }
+
+      const auto Start = std::chrono::steady_clock::now();
+      for (std::vector<ScopeReplay> &Replays : Samples)
+      {
+        for (ScopeReplay &Replay : Replays)
+        {
+          Replay.Scopes.fixupScopeMethodSteps(Replay.Recipe->getMethodSteps());
+        }
+      }
+      const std::chrono::duration<double> Elapsed =
+          std::chrono::steady_clock::now() - Start;
+      const double Seconds = Elapsed.count() / Repeat;
+
+      if (Iteration == 0 || Seconds < Fixup.BestSeconds)
+      {
+        Fixup.BestSeconds = Seconds;
+      }
+      Fixup.MeanSeconds += Seconds / Iterations;
+    }
+    Phases.push_back(Fixup);
+
+    Phases.push_back(timePhase("compile", Iterations, Repeat, [&]()
+    {
+      CheffeDriver Driver;
+      Driver.setSourceFile(File);
+      Driver.setDiagnosticHandler(std::make_shared<CheffeDiagnosticHandler>());
+      std::unique_ptr<CheffeProgramInfo> Compiled;
+      return Driver.compileProgram(Compiled) ==
+             CheffeErrorCode::CHEFFE_SUCCESS;
+    }));
+
+    writeResults(Writer, Shape, File, TokenCount, *ProgramInfo, Phases);
+  }
+
+  Writer.arrayEnd();
+  Writer.objectEnd();
+  std::cout << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,121 @@
+#include "CheffeRecipeGenerator.h"
+#include "Lexer/CheffeLexer.h"
+#include "Utils/CheffeFileHandler.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace cheffe;
+
+static void printUsage()
+{
+  // clang-format off
+  std::cout << "OVERVIEW: cheffe lexer throughput benchmark" << std::endl
+            << std::endl
+            << "usage: cheffe_bench_lexer [options]" << std::endl
+            << std::endl
+            << "OPTIONS" << std::endl
+            << "  -size <MB>           Size of the generated program"
+                                       << std::endl
+            << "                       Default: 16" << std::endl
+            << "  -numbers             Lex a program of ingredient lists, "
+                                       "decoding every number" << std::endl
+            << "  -iterations <n>      Number of times to lex it; the best "
+                                       "time is reported" << std::endl
+            << "                       Default: 5" << std::endl
+            << "  -help                Print usage and exit" << std::endl
+            << std::endl;
+  // clang-format on
+}
+
+int main(int argc, char **argv)
+{
+  std::size_t SizeInMB = 16;
+  unsigned Iterations = 5;
+  bool NumberDense = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (!std::strcmp(argv[i], "-help"))
+    {
+      printUsage();
+      return 0;
+    }
+    if (!std::strcmp(argv[i], "-size") && i != argc - 1)
+    {
+      SizeInMB = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-numbers"))
+    {
+      NumberDense = true;
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-iterations") && i != argc - 1)
+    {
+      Iterations = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    std::cerr << "Unknown option '" << argv[i] << "'" << std::endl;
+    return 1;
+  }
+
+  if (SizeInMB == 0 || Iterations == 0)
+  {
+    std::cerr << "Size and iteration count must be positive" << std::endl;
+    return 1;
+  }
+
+  const CheffeSourceFile File(CheffeSourceBuffer::getMemBuffer(
+      "<generated>", NumberDense ? generateNumberDenseProgram(SizeInMB << 20)
+                                 : generateRecipeProgram(SizeInMB << 20)));
+
+  double BestSeconds = 0.0;
+  std::size_t TokenCount = 0;
+  std::size_t NumberCount = 0;
+  long long NumberSum = 0;
+  for (unsigned Iteration = 0; Iteration < Iterations; ++Iteration)
+  {
+    CheffeLexer Lexer;
+    Lexer.setSourceFile(File);
+
+    TokenCount = 0;
+    NumberCount = 0;
+    NumberSum = 0;
+    const auto Start = std::chrono::steady_clock::now();
+    for (Token Tok = Lexer.getToken(); Tok.isNot(TokenKind::EndOfFile);
+         Tok = Lexer.getToken())
+    {
+      ++TokenCount;
+      // Decoding the numbers is what the parser pays for on top of lexing.
+      if (NumberDense && Tok.is(TokenKind::Number))
+      {
+        long long Value = 0;
+        Tok.getNumVal(Value);
+        NumberSum ^= Value;
+        ++NumberCount;
+      }
+    }
+    const std::chrono::duration<double> Elapsed =
+        std::chrono::steady_clock::now() - Start;
+
+    if (Iteration == 0 || Elapsed.count() < BestSeconds)
+    {
+      BestSeconds = Elapsed.count();
+    }
+  }
+
+  const double MegaBytes = static_cast<double>(File.size()) / (1 << 20);
+  std::cout << "lexed " << MegaBytes << " MB (" << TokenCount << " tokens) in "
+            << BestSeconds * 1000.0 << " ms: " << MegaBytes / BestSeconds
+            << " MB/s" << std::endl;
+  if (NumberDense)
+  {
+    // Printing the checksum keeps the decoding from being optimised away.
+    std::cout << "decoded " << NumberCount << " numbers (checksum "
+              << NumberSum << ")" << std::endl;
+  }
+
+  return 0;
+}
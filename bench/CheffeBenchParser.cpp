@@ -0,0 +1,149 @@
+#include "CheffeRecipeGenerator.h"
+#include "IR/CheffeProgramInfo.h"
+#include "Parser/CheffeParser.h"
+#include "Utils/CheffeDiagnosticHandler.h"
+#include "Utils/CheffeFileHandler.h"
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace cheffe;
+
+static void printUsage()
+{
+  // clang-format off
+  std::cout << "OVERVIEW: cheffe parser benchmark" << std::endl
+            << std::endl
+            << "usage: cheffe_bench_parser [options]" << std::endl
+            << std::endl
+            << "OPTIONS" << std::endl
+            << "  -loops <n>           Number of verb loops in the recipe"
+                                       << std::endl
+            << "                       Default: 50000" << std::endl
+            << "  -size <MB>           Parse a generated program of this "
+                                       "size instead" << std::endl
+            << "  -parse-threads <n>   Number of threads to parse on"
+                                       << std::endl
+            << "                       Default: 1" << std::endl
+            << "  -iterations <n>      Number of times to parse it; the best "
+                                       "time is reported" << std::endl
+            << "                       Default: 5" << std::endl
+            << "  -help                Print usage and exit" << std::endl
+            << std::endl;
+  // clang-format on
+}
+
+int main(int argc, char **argv)
+{
+  unsigned LoopCount = 50000;
+  std::size_t SizeInMB = 0;
+  unsigned ParseThreads = 1;
+  unsigned Iterations = 5;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (!std::strcmp(argv[i], "-help"))
+    {
+      printUsage();
+      return 0;
+    }
+    if (!std::strcmp(argv[i], "-loops") && i != argc - 1)
+    {
+      LoopCount = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-size") && i != argc - 1)
+    {
+      SizeInMB = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-parse-threads") && i != argc - 1)
+    {
+      ParseThreads = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-iterations") && i != argc - 1)
+    {
+      Iterations = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    std::cerr << "Unknown option '" << argv[i] << "'" << std::endl;
+    return 1;
+  }
+
+  if (LoopCount == 0 || Iterations == 0)
+  {
+    std::cerr << "Loop and iteration counts must be positive" << std::endl;
+    return 1;
+  }
+
+  // The looping recipe stresses scope fixup; a sized program is a broad mix of
+  // recipes, and so stresses building and tearing down the IR.
+  const CheffeSourceFile File(CheffeSourceBuffer::getMemBuffer(
+      "<generated>", SizeInMB ? generateRecipeProgram(SizeInMB << 20)
+                              : generateLoopingRecipeProgram(LoopCount)));
+
+  double BestSeconds = 0.0;
+  double BestFreeSeconds = 0.0;
+  std::size_t ArenaMemory = 0;
+  for (unsigned Iteration = 0; Iteration < Iterations; ++Iteration)
+  {
+    auto Diagnostics = std::make_shared<CheffeDiagnosticHandler>();
+    Diagnostics->setSourceFile(File);
+
+    CheffeParser Parser;
+    Parser.setSourceFile(File);
+    Parser.setDiagnosticHandler(Diagnostics);
+    Parser.getOptions()->setParseThreads(ParseThreads);
+
+    const auto Start = std::chrono::steady_clock::now();
+    const CheffeErrorCode Success = Parser.parseProgram();
+    const std::chrono::duration<double> Elapsed =
+        std::chrono::steady_clock::now() - Start;
+
+    if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
+    {
+      std::cerr << "Failed to parse the generated recipe" << std::endl;
+      return 1;
+    }
+
+    auto ProgramInfo = Parser.takeProgramInfo();
+    ArenaMemory = ProgramInfo->getArena().getTotalMemory();
+    const auto FreeStart = std::chrono::steady_clock::now();
+    ProgramInfo.reset();
+    const std::chrono::duration<double> FreeElapsed =
+        std::chrono::steady_clock::now() - FreeStart;
+
+    if (Iteration == 0 || Elapsed.count() < BestSeconds)
+    {
+      BestSeconds = Elapsed.count();
+    }
+    if (Iteration == 0 || FreeElapsed.count() < BestFreeSeconds)
+    {
+      BestFreeSeconds = FreeElapsed.count();
+    }
+  }
+
+  struct rusage Usage;
+  getrusage(RUSAGE_SELF, &Usage);
+
+  const double MegaBytes = static_cast<double>(File.size()) / (1 << 20);
+  if (SizeInMB)
+  {
+    std::cout << "parsed " << MegaBytes << " MB in ";
+  }
+  else
+  {
+    std::cout << "parsed " << LoopCount << " loops (" << MegaBytes
+              << " MB) in ";
+  }
+  std::cout << BestSeconds * 1000.0 << " ms, freed in "
+            << BestFreeSeconds * 1000.0 << " ms, IR arena "
+            << ArenaMemory / (1 << 20) << " MB, peak RSS "
+            << Usage.ru_maxrss / 1024 << " MB" << std::endl;
+
+  return 0;
+}
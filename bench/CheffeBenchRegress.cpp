@@ -0,0 +1,819 @@
+#include "CheffeRecipeGenerator.h"
+#include "CheffeWorkloadGenerator.h"
+#include "Driver/CheffeDriver.h"
+#include "IR/CheffeProgramInfo.h"
+#include "JIT/CheffeJIT.h"
+#include "Utils/CheffeDiagnosticHandler.h"
+#include "Utils/CheffeFileHandler.h"
+#include "Utils/CheffeJSON.h"
+
+#ifdef CHEFFE_ALLOCATION_COUNTING
+#include "CheffeAllocationCounter.h"
+#endif
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+using namespace cheffe;
+
+static void printUsage()
+{
+  // clang-format off
+  std::cout << "OVERVIEW: cheffe performance regression harness" << std::endl
+            << std::endl
+            << "usage: cheffe_bench_regress [options]" << std::endl
+            << std::endl
+            << "Compiles and runs the test corpus and a set of generated "
+               "programs, each in" << std::endl
+            << "a process of its own, and records the wall time, "
+               "instructions retired, peak" << std::endl
+            << "RSS and heap allocations of each. The results are written "
+               "as JSON and" << std::endl
+            << "compared against a baseline, one result per line. If "
+               "instructions retired or" << std::endl
+            << "allocations are worse than the baseline by more than their "
+               "tolerance, the" << std::endl
+            << "exit status is 1." << std::endl
+            << std::endl
+            << "Wall time and peak RSS depend on the machine, so by default "
+               "they are only" << std::endl
+            << "reported as advisories, which don't change the exit status. "
+               "To fail on them" << std::endl
+            << "too with -gate-all, first record a baseline on the same "
+               "machine and build" << std::endl
+            << "with -update-baseline." << std::endl
+            << std::endl
+            << "Metrics that can't be measured, such as instructions retired "
+               "where perf" << std::endl
+            << "events aren't available, are written as null. A gating "
+               "metric that is null," << std::endl
+            << "either in the baseline or in this run, can't be compared, so "
+               "it's reported" << std::endl
+            << "as unchecked, and the exit status is 1; -update-baseline "
+               "refuses to write" << std::endl
+            << "a baseline missing one. Both only warn with -allow-unchecked."
+            << std::endl
+            << std::endl
+            << "OPTIONS" << std::endl
+            << "  -baseline <file>         Baseline to compare against"
+                                           << std::endl
+            << "                           Default: the checked-in "
+                                           "bench/regress-baseline.json"
+                                           << std::endl
+            << "  -update-baseline         Write the results to the "
+                                           "baseline instead of" << std::endl
+            << "                           comparing against it" << std::endl
+            << "  -filter <text>           Only run workloads whose name "
+                                           "contains this" << std::endl
+            << "  -iterations <n>          Number of timed runs of each; the "
+                                           "best is kept" << std::endl
+            << "                           Default: 5" << std::endl
+            << "  -wall-tolerance <n>      Percentage by which wall time may "
+                                           "grow" << std::endl
+            << "                           Default: 20" << std::endl
+            << "  -instructions-tolerance <n>" << std::endl
+            << "                           Percentage by which instructions "
+                                           "retired may grow" << std::endl
+            << "                           Default: 3" << std::endl
+            << "  -rss-tolerance <n>       Percentage by which peak RSS may "
+                                           "grow" << std::endl
+            << "                           Default: 10" << std::endl
+            << "  -allocations-tolerance <n>" << std::endl
+            << "                           Percentage by which heap "
+                                           "allocations may grow" << std::endl
+            << "                           Default: 5" << std::endl
+            << "  -gate-all                Fail on wall time and peak RSS "
+                                           "too, not just" << std::endl
+            << "                           report them" << std::endl
+            << "  -allow-unchecked         Only warn about gating metrics "
+                                           "that can't be" << std::endl
+            << "                           compared, rather than failing"
+                                           << std::endl
+            << "  -help                    Print usage and exit" << std::endl
+            << std::endl;
+  // clang-format on
+}
+
+namespace
+{
+
+// Swallows everything written to it, so that the workloads' output costs the
+// formatting and nothing else.
+struct NullStreamBuffer : public std::streambuf
+{
+protected:
+  int overflow(int C) override
+  {
+    return C;
+  }
+
+  std::streamsize xsputn(const char *, std::streamsize Count) override
+  {
+    return Count;
+  }
+};
+
+struct Workload
+{
+  std::string Name;
+  // Only the programs of the workload being run are ever generated, and only
+  // in the process that runs them, so that they don't count towards any other
+  // workload's peak RSS.
+  std::function<bool(std::vector<GeneratedWorkload> &)> Generate;
+  // Whether the programs are run, or only compiled.
+  bool Execute;
+};
+
+// A metric that isn't available is negative.
+struct Measurement
+{
+  double WallMilliseconds = -1;
+  double Instructions = -1;
+  double PeakRSSKilobytes = -1;
+  double Allocations = -1;
+};
+
+struct MetricInfo
+{
+  const char *Name;
+  double Measurement::*Value;
+  double Tolerance;
+  // Whether growing past the tolerance fails the run, or is only reported.
+  bool Gating;
+};
+
+// Counts the instructions retired in user space by this process, where the
+// kernel and the hardware allow it.
+class InstructionCounter
+{
+public:
+  InstructionCounter() : FD(-1)
+  {
+    perf_event_attr Attr;
+    std::memset(&Attr, 0, sizeof(Attr));
+    Attr.type = PERF_TYPE_HARDWARE;
+    Attr.size = sizeof(Attr);
+    Attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    Attr.disabled = 1;
+    Attr.exclude_kernel = 1;
+    Attr.exclude_hv = 1;
+    FD = static_cast<int>(syscall(__NR_perf_event_open, &Attr, 0, -1, -1, 0));
+  }
+
+  ~InstructionCounter()
+  {
+    if (FD >= 0)
+    {
+      close(FD);
+    }
+  }
+
+  bool isAvailable() const
+  {
+    return FD >= 0;
+  }
+
+  void start()
+  {
+    ioctl(FD, PERF_EVENT_IOC_RESET, 0);
+    ioctl(FD, PERF_EVENT_IOC_ENABLE, 0);
+  }
+
+  // Returns the instructions retired since start, or -1 if they couldn't be
+  // read.
+  double stop()
+  {
+    ioctl(FD, PERF_EVENT_IOC_DISABLE, 0);
+    long long Count = 0;
+    if (read(FD, &Count, sizeof(Count)) != sizeof(Count))
+    {
+      return -1;
+    }
+    return static_cast<double>(Count);
+  }
+
+private:
+  int FD;
+};
+
+} // end anonymous namespace
+
+// Every program in the JITExecution corpus that runs successfully;
+// lazy-parsing-1.ch is left out, since it's meant to fail.
+static const char *const CorpusFileNames[] = {
+    "99-bottles.ch",              "add-1.ch",
+    "add-2.ch",                   "adddry-1.ch",
+    "clean-bowl-1.ch",            "clean-bowl-2.ch",
+    "clean-bowl-3.ch",            "combine-1.ch",
+    "combine-2.ch",               "control-flow-1.ch",
+    "control-flow-2.ch",          "control-flow-3.ch",
+    "control-flow-4.ch",          "divide-1.ch",
+    "divide-2.ch",                "exp.ch",
+    "fizzbuzz.ch",                "fold-1.ch",
+    "fold-2.ch",                  "hello-cake.ch",
+    "hello-full.ch",              "hello.ch",
+    "large-numbers.ch",           "liquefy-ingr-1.ch",
+    "liquefy-ingr-2.ch",          "loops.ch",
+    "mix-bowl-1.ch",              "multi-table.ch",
+    "nothing-1.ch",               "nothing-2.ch",
+    "pour-1.ch",                  "put-1.ch",
+    "put-2.ch",                   "put-3.ch",
+    "put-4.ch",                   "put-5.ch",
+    "put-6.ch",                   "refrigerate-1.ch",
+    "refrigerate-2.ch",           "refrigerate-3.ch",
+    "remove-1.ch",                "remove-2.ch",
+    "reset-ingredient-values.ch", "serve-1.ch",
+    "serve-2.ch",                 "step-count.ch",
+    "stir-bowl-1.ch",             "stir-bowl-2.ch",
+    "stir-bowl-3.ch",             "stir-bowl-4.ch",
+    "stir-bowl-5.ch",             "stir-bowl-6.ch",
+    "stir-bowl-7.ch",             "stir-ingr-1.ch"};
+
+// The corpus is gone through several times over, since one pass takes too
+// little time to measure reliably.
+static bool readCorpus(std::vector<GeneratedWorkload> &Programs)
+{
+  const unsigned NumPasses = 10;
+  for (const char *FileName : CorpusFileNames)
+  {
+    CheffeSourceFile File;
+    if (CheffeFileHandler::readFile(std::string(TEST_ROOT_PATH) +
+                                        "/JITExecution/" + FileName,
+                                    File) != CheffeErrorCode::CHEFFE_SUCCESS)
+    {
+      std::cerr << "Could not read '" << FileName << "'" << std::endl;
+      return false;
+    }
+    Programs.push_back({File.getSource().str(), std::string()});
+  }
+  const std::size_t NumFiles = Programs.size();
+  for (unsigned i = 1; i < NumPasses; ++i)
+  {
+    for (std::size_t j = 0; j < NumFiles; ++j)
+    {
+      Programs.push_back(Programs[j]);
+    }
+  }
+  return true;
+}
+
+static void addGeneratedWorkload(std::vector<Workload> &Workloads,
+                                 const std::string &Name,
+                                 const WorkloadShape &Shape)
+{
+  Workloads.push_back({Name,
+                       [Shape](std::vector<GeneratedWorkload> &Programs) {
+                         Programs.push_back(generateWorkload(Shape));
+                         return true;
+                       },
+                       true});
+}
+
+static std::vector<Workload> getWorkloads()
+{
+  std::vector<Workload> Workloads;
+  Workloads.push_back({"corpus", readCorpus, true});
+
+  Workloads.push_back({"compile_shaped_4M",
+                       [](std::vector<GeneratedWorkload> &Programs) {
+                         GeneratorShape Shape;
+                         Shape.TargetSize = 4 << 20;
+                         Programs.push_back(
+                             {generateShapedProgram(Shape), std::string()});
+                         return true;
+                       },
+                       false});
+
+  WorkloadShape Shape;
+  Shape.RecipeCount = 8;
+  Shape.LoopDepth = 3;
+  Shape.LoopIterations = 6;
+  addGeneratedWorkload(Workloads, "fan_out", Shape);
+
+  Shape = WorkloadShape();
+  Shape.RecipeCount = 3;
+  Shape.LoopIterations = 6;
+  Shape.Serving = ServePattern::Chain;
+  addGeneratedWorkload(Workloads, "chain", Shape);
+
+  Shape = WorkloadShape();
+  Shape.RecipeCount = 1;
+  Shape.LoopDepth = 1;
+  Shape.LoopIterations = 20;
+  Shape.RecursionDepth = 2000;
+  addGeneratedWorkload(Workloads, "recursion", Shape);
+
+  Shape = WorkloadShape();
+  Shape.RecipeCount = 2;
+  Shape.LoopIterations = 16;
+  Shape.BowlSpread = 100;
+  addGeneratedWorkload(Workloads, "bowl_spread", Shape);
+
+  Shape = WorkloadShape();
+  Shape.RecipeCount = 1;
+  Shape.LoopDepth = 0;
+  Shape.OutputValues = 200000;
+  addGeneratedWorkload(Workloads, "output", Shape);
+
+  Shape = WorkloadShape();
+  Shape.RecipeCount = 1;
+  Shape.LoopIterations = 32;
+  Shape.TakeCount = 4;
+  addGeneratedWorkload(Workloads, "take", Shape);
+
+  return Workloads;
+}
+
+static bool compileAndRun(const GeneratedWorkload &Program,
+                          const bool Execute)
+{
+  const CheffeSourceFile File(
+      CheffeSourceBuffer::getMemBuffer("<generated>", Program.Program));
+
+  auto Diagnostics = std::make_shared<CheffeDiagnosticHandler>();
+  Diagnostics->setSourceFile(File);
+
+  CheffeDriver Driver;
+  Driver.setSourceFile(File);
+  Driver.setDiagnosticHandler(Diagnostics);
+
+  std::unique_ptr<CheffeProgramInfo> ProgramInfo;
+  if (Driver.compileProgram(ProgramInfo) != CheffeErrorCode::CHEFFE_SUCCESS)
+  {
+    Diagnostics->flushDiagnostics();
+    return false;
+  }
+  if (!Execute)
+  {
+    return true;
+  }
+
+  std::istringstream Input(Program.Input);
+  std::streambuf *OldInputStream = std::cin.rdbuf(Input.rdbuf());
+  CheffeJIT JIT(std::move(ProgramInfo), Diagnostics);
+  const CheffeErrorCode Success = JIT.executeProgram();
+  std::cin.rdbuf(OldInputStream);
+
+  if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
+  {
+    Diagnostics->flushDiagnostics();
+    return false;
+  }
+  return true;
+}
+
+// Runs the workload in the current process, which is about to exit, and
+// writes what was measured to FD.
+static bool runWorkload(const Workload &Work, const unsigned Iterations,
+                        const int FD)
+{
+  std::vector<GeneratedWorkload> Programs;
+  if (!Work.Generate(Programs))
+  {
+    return false;
+  }
+
+  NullStreamBuffer NullBuffer;
+  std::cout.rdbuf(&NullBuffer);
+
+  InstructionCounter Counter;
+  Measurement Result;
+  for (unsigned Iteration = 0; Iteration < Iterations; ++Iteration)
+  {
+#ifdef CHEFFE_ALLOCATION_COUNTING
+    const std::size_t AllocationsBefore = getAllocationCount();
+#endif
+    if (Counter.isAvailable())
+    {
+      Counter.start();
+    }
+    const auto Start = std::chrono::steady_clock::now();
+    for (const GeneratedWorkload &Program : Programs)
+    {
+      if (!compileAndRun(Program, Work.Execute))
+      {
+        std::cerr << "Failed to run workload '" << Work.Name << "'"
+                  << std::endl;
+        return false;
+      }
+    }
+    const std::chrono::duration<double, std::milli> Elapsed =
+        std::chrono::steady_clock::now() - Start;
+    const double Instructions = Counter.isAvailable() ? Counter.stop() : -1;
+#ifdef CHEFFE_ALLOCATION_COUNTING
+    Result.Allocations =
+        static_cast<double>(getAllocationCount() - AllocationsBefore);
+#endif
+
+    // The fastest run is the one with the least noise in it.
+    if (Iteration == 0 || Elapsed.count() < Result.WallMilliseconds)
+    {
+      Result.WallMilliseconds = Elapsed.count();
+    }
+    if (Iteration == 0 || Instructions < Result.Instructions)
+    {
+      Result.Instructions = Instructions;
+    }
+  }
+
+  std::ostringstream OS;
+  OS.precision(17);
+  OS << Result.WallMilliseconds << " " << Result.Instructions << " "
+     << Result.Allocations;
+  const std::string Text = OS.str();
+  return write(FD, Text.data(), Text.size()) ==
+         static_cast<ssize_t>(Text.size());
+}
+
+// Runs the workload in a child process of its own, so that its peak RSS is
+// its own.
+static bool measureWorkload(const Workload &Work, const unsigned Iterations,
+                            Measurement &Result)
+{
+  int Pipe[2];
+  if (pipe(Pipe))
+  {
+    std::cerr << "Could not create a pipe" << std::endl;
+    return false;
+  }
+
+  // Anything left in the buffers would otherwise be written by both
+  // processes.
+  std::cout.flush();
+  std::cerr.flush();
+
+  const pid_t Child = fork();
+  if (Child < 0)
+  {
+    std::cerr << "Could not start a process for '" << Work.Name << "'"
+              << std::endl;
+    return false;
+  }
+  if (Child == 0)
+  {
+    close(Pipe[0]);
+    const bool Success = runWorkload(Work, Iterations, Pipe[1]);
+    close(Pipe[1]);
+    std::cerr.flush();
+    _exit(Success ? 0 : 1);
+  }
+
+  close(Pipe[1]);
+  std::string Text;
+  char Buffer[256];
+  ssize_t Count = 0;
+  while ((Count = read(Pipe[0], Buffer, sizeof(Buffer))) > 0)
+  {
+    Text.append(Buffer, Count);
+  }
+  close(Pipe[0]);
+
+  int Status = 0;
+  rusage Usage;
+  if (wait4(Child, &Status, 0, &Usage) != Child || !WIFEXITED(Status) ||
+      WEXITSTATUS(Status) != 0)
+  {
+    return false;
+  }
+
+  std::istringstream IS(Text);
+  if (!(IS >> Result.WallMilliseconds >> Result.Instructions >>
+        Result.Allocations))
+  {
+    return false;
+  }
+  // Linux reports the peak RSS in kilobytes.
+  Result.PeakRSSKilobytes = static_cast<double>(Usage.ru_maxrss);
+  return true;
+}
+
+static void writeMetric(JSONWriter &Writer, const char *Name,
+                        const double Value)
+{
+  Writer.attribute(Name);
+  if (Value < 0)
+  {
+    Writer.nullValue();
+  }
+  else
+  {
+    Writer.value(Value);
+  }
+}
+
+// Compares Current against the workload's entry in Baseline, if it has one,
+// and writes out the metrics that have grown by more than their tolerance:
+// gating metrics as regressions, and the rest as advisories. Gating metrics
+// that are missing on either side are written out as unchecked, and counted
+// in NumUnchecked. Returns true if there were any regressions.
+static bool compareWorkload(JSONWriter &Writer, const std::string &Name,
+                            const Measurement &Current,
+                            const JSONValue &Baseline,
+                            const std::vector<MetricInfo> &Metrics,
+                            std::size_t &NumUnchecked)
+{
+  const JSONValue *Expected = nullptr;
+  if (const JSONValue *Results = Baseline.get("results"))
+  {
+    for (const JSONValue &Result : Results->getArray())
+    {
+      const JSONValue *ResultName = Result.get("name");
+      if (ResultName && ResultName->getKind() == JSONValue::Kind::String &&
+          ResultName->getString() == Name)
+      {
+        Expected = &Result;
+      }
+    }
+  }
+
+  std::vector<const char *> Regressions;
+  std::vector<const char *> Advisories;
+  std::vector<const char *> Unchecked;
+  for (const MetricInfo &Metric : Metrics)
+  {
+    const JSONValue *ExpectedValue =
+        Expected ? Expected->get(Metric.Name) : nullptr;
+    const double Value = Current.*Metric.Value;
+    const bool HasExpectedValue =
+        ExpectedValue && ExpectedValue->getKind() == JSONValue::Kind::Number;
+    if (!HasExpectedValue || Value < 0)
+    {
+      if (Metric.Gating)
+      {
+        Unchecked.push_back(Metric.Name);
+        std::cerr << "Warning: " << Metric.Name << " in '" << Name
+                  << "' is not checked, since "
+                  << (HasExpectedValue ? "it couldn't be measured"
+                                       : "the baseline has no value for it")
+                  << std::endl;
+      }
+      continue;
+    }
+
+    const double Limit =
+        ExpectedValue->getNumber() * (1.0 + Metric.Tolerance / 100.0);
+    if (Value <= Limit)
+    {
+      continue;
+    }
+
+    (Metric.Gating ? Regressions : Advisories).push_back(Metric.Name);
+    std::cerr << (Metric.Gating ? "Regression" : "Advisory") << " in '"
+              << Name << "': " << Metric.Name << " is " << Value
+              << " against a baseline of " << ExpectedValue->getNumber()
+              << " (tolerance " << Metric.Tolerance << "%)" << std::endl;
+  }
+
+  Writer.attribute("regressions");
+  Writer.arrayBegin();
+  for (const char *Metric : Regressions)
+  {
+    Writer.value(Metric);
+  }
+  Writer.arrayEnd();
+  Writer.attribute("advisories");
+  Writer.arrayBegin();
+  for (const char *Metric : Advisories)
+  {
+    Writer.value(Metric);
+  }
+  Writer.arrayEnd();
+  Writer.attribute("unchecked");
+  Writer.arrayBegin();
+  for (const char *Metric : Unchecked)
+  {
+    Writer.value(Metric);
+  }
+  Writer.arrayEnd();
+  NumUnchecked += Unchecked.size();
+  return !Regressions.empty();
+}
+
+static bool readBaseline(const std::string &FileName, JSONValue &Baseline)
+{
+  CheffeSourceFile File;
+  if (CheffeFileHandler::readFile(FileName, File) !=
+      CheffeErrorCode::CHEFFE_SUCCESS)
+  {
+    std::cerr << "Could not read the baseline '" << FileName << "'"
+              << std::endl;
+    return false;
+  }
+
+  std::string Error;
+  if (!JSONValue::parse(File.getSource().str(), Baseline, Error))
+  {
+    std::cerr << "Invalid baseline '" << FileName << "': " << Error
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char **argv)
+{
+  std::string BaselineFileName = BASELINE_PATH;
+  bool UpdateBaseline = false;
+  bool AllowUnchecked = false;
+  const char *Filter = "";
+  unsigned Iterations = 5;
+  // Instructions retired and allocations come out much the same on any
+  // machine, so only they fail the run by default. Allocations are given a
+  // little slack for differences between standard library versions.
+  std::vector<MetricInfo> Metrics = {
+      {"wall_ms", &Measurement::WallMilliseconds, 20, false},
+      {"instructions", &Measurement::Instructions, 3, true},
+      {"peak_rss_kb", &Measurement::PeakRSSKilobytes, 10, false},
+      {"allocations", &Measurement::Allocations, 5, true}};
+  const char *ToleranceOptions[] = {
+      "-wall-tolerance", "-instructions-tolerance", "-rss-tolerance",
+      "-allocations-tolerance"};
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (!std::strcmp(argv[i], "-help"))
+    {
+      printUsage();
+      return 0;
+    }
+    if (!std::strcmp(argv[i], "-baseline") && i != argc - 1)
+    {
+      BaselineFileName = argv[++i];
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-update-baseline"))
+    {
+      UpdateBaseline = true;
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-gate-all"))
+    {
+      for (MetricInfo &Metric : Metrics)
+      {
+        Metric.Gating = true;
+      }
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-allow-unchecked"))
+    {
+      AllowUnchecked = true;
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-filter") && i != argc - 1)
+    {
+      Filter = argv[++i];
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-iterations") && i != argc - 1)
+    {
+      Iterations = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    bool IsTolerance = false;
+    for (std::size_t j = 0; j < Metrics.size(); ++j)
+    {
+      if (!std::strcmp(argv[i], ToleranceOptions[j]) && i != argc - 1)
+      {
+        Metrics[j].Tolerance = std::strtod(argv[++i], nullptr);
+        IsTolerance = true;
+      }
+    }
+    if (IsTolerance)
+    {
+      continue;
+    }
+    std::cerr << "Unknown option '" << argv[i] << "'" << std::endl;
+    return 2;
+  }
+
+  if (Iterations == 0)
+  {
+    std::cerr << "Iteration count must be positive" << std::endl;
+    return 2;
+  }
+  for (const MetricInfo &Metric : Metrics)
+  {
+    if (!(Metric.Tolerance >= 0))
+    {
+      std::cerr << "Tolerances must not be negative" << std::endl;
+      return 2;
+    }
+  }
+
+  JSONValue Baseline;
+  if (!UpdateBaseline && !readBaseline(BaselineFileName, Baseline))
+  {
+    return 2;
+  }
+
+  // Each result is written on a line of its own, so that a change to the
+  // checked-in baseline can be reviewed in a diff.
+  std::vector<std::string> ResultLines;
+  bool Regressed = false;
+  std::size_t NumUnchecked = 0;
+  for (const Workload &Work : getWorkloads())
+  {
+    if (Work.Name.find(Filter) == std::string::npos)
+    {
+      continue;
+    }
+
+    Measurement Result;
+    if (!measureWorkload(Work, Iterations, Result))
+    {
+      std::cerr << "Failed to measure workload '" << Work.Name << "'"
+                << std::endl;
+      return 2;
+    }
+
+    std::ostringstream Line;
+    JSONWriter Writer(Line);
+    Writer.objectBegin();
+    Writer.attribute("name");
+    Writer.value(Work.Name);
+    for (const MetricInfo &Metric : Metrics)
+    {
+      writeMetric(Writer, Metric.Name, Result.*Metric.Value);
+      // A baseline without a gating metric would leave it unchecked on every
+      // later run.
+      if (UpdateBaseline && Metric.Gating && Result.*Metric.Value < 0)
+      {
+        std::cerr << "Warning: " << Metric.Name << " in '" << Work.Name
+                  << "' couldn't be measured" << std::endl;
+        ++NumUnchecked;
+      }
+    }
+    if (!UpdateBaseline)
+    {
+      Regressed |= compareWorkload(Writer, Work.Name, Result, Baseline,
+                                   Metrics, NumUnchecked);
+    }
+    Writer.objectEnd();
+    ResultLines.push_back(Line.str());
+  }
+
+  std::ostringstream Results;
+  Results << "{\"benchmark\":\"regress\",\"iterations\":" << Iterations
+          << ",\"results\":[\n";
+  for (std::size_t i = 0; i < ResultLines.size(); ++i)
+  {
+    Results << "  " << ResultLines[i]
+            << (i + 1 != ResultLines.size() ? ",\n" : "\n");
+  }
+  Results << "]";
+  if (!UpdateBaseline)
+  {
+    Results << ",\"regressed\":" << (Regressed ? "true" : "false");
+  }
+  Results << ",\"unchecked\":" << NumUnchecked << "}\n";
+
+  const bool FailUnchecked = NumUnchecked != 0 && !AllowUnchecked;
+  if (NumUnchecked != 0)
+  {
+    std::cerr << std::endl
+              << "WARNING: " << NumUnchecked
+              << " gating metric(s) could not be "
+              << (UpdateBaseline ? "recorded" : "checked")
+              << "; see the warnings above. Record the baseline where perf "
+                 "events are available."
+              << std::endl;
+    if (FailUnchecked)
+    {
+      std::cerr << "Pass -allow-unchecked to "
+                << (UpdateBaseline ? "write the baseline anyway."
+                                   : "only warn about this.")
+                << std::endl;
+    }
+  }
+
+  if (UpdateBaseline && !FailUnchecked)
+  {
+    std::ofstream File(BaselineFileName, std::ios::binary);
+    File << Results.str();
+    File.close();
+    if (!File)
+    {
+      std::cerr << "Could not write the baseline '" << BaselineFileName
+                << "'" << std::endl;
+      return 2;
+    }
+  }
+
+  std::cout << Results.str();
+  return Regressed || FailUnchecked ? 1 : 0;
+}
@@ -0,0 +1,203 @@
+#include "CheffeWorkloadGenerator.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace cheffe;
+
+static void printUsage()
+{
+  // clang-format off
+  std::cout << "OVERVIEW: cheffe synthetic workload generator" << std::endl
+            << std::endl
+            << "usage: cheffe_generate_workload [options]" << std::endl
+            << std::endl
+            << "Writes a Chef program of the given shape that always parses "
+               "and runs to" << std::endl
+            << "completion, along with the input its Take steps read."
+            << std::endl
+            << std::endl
+            << "OPTIONS" << std::endl
+            << "  -o <file>              Where to write the program"
+                                         << std::endl
+            << "                         Default: standard output"
+                                         << std::endl
+            << "  -input <file>          Where to write the program's input"
+                                         << std::endl
+            << "                         Default: nowhere; required with "
+                                         "-takes" << std::endl
+            << "  -recipes <n>           Number of recipes, including the "
+                                         "main one" << std::endl
+            << "                         Default: 4" << std::endl
+            << "  -ingredients <n>       Ingredients per recipe" << std::endl
+            << "                         Default: 8" << std::endl
+            << "  -statements <n>        Groups of steps in each innermost "
+                                         "loop" << std::endl
+            << "                         Default: 8" << std::endl
+            << "  -loop-depth <n>        How deeply verb loops are nested"
+                                         << std::endl
+            << "                         Default: 2" << std::endl
+            << "  -loop-iterations <n>   How many times each loop goes round"
+                                         << std::endl
+            << "                         Default: 4" << std::endl
+            << "  -serve <pattern>       'fan-out', where the main recipe "
+                                         "serves the others," << std::endl
+            << "                         or 'chain', where each recipe "
+                                         "serves the next" << std::endl
+            << "                         Default: fan-out" << std::endl
+            << "  -recursion-depth <n>   How many times a recursive recipe "
+                                         "serves itself" << std::endl
+            << "                         Default: 0, for no recursive recipe"
+                                         << std::endl
+            << "  -bowls <n>             Number of mixing bowls to spread "
+                                         "steps over" << std::endl
+            << "                         Default: 2" << std::endl
+            << "  -outputs <n>           Number of values to print"
+                                         << std::endl
+            << "                         Default: 16" << std::endl
+            << "  -takes <n>             Take steps in the main recipe's "
+                                         "innermost loop" << std::endl
+            << "                         Default: 0" << std::endl
+            << "  -seed <n>              Seed for the generator" << std::endl
+            << "                         Default: 0" << std::endl
+            << "  -help                  Print usage and exit" << std::endl
+            << std::endl;
+  // clang-format on
+}
+
+static bool writeFile(const std::string &FileName, const std::string &Text)
+{
+  std::ofstream File(FileName, std::ios::binary);
+  File << Text;
+  File.close();
+  if (!File)
+  {
+    std::cerr << "Could not write '" << FileName << "'" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char **argv)
+{
+  WorkloadShape Shape;
+  std::string OutputFileName;
+  std::string InputFileName;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (!std::strcmp(argv[i], "-help"))
+    {
+      printUsage();
+      return 0;
+    }
+    if (!std::strcmp(argv[i], "-o") && i != argc - 1)
+    {
+      OutputFileName = argv[++i];
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-input") && i != argc - 1)
+    {
+      InputFileName = argv[++i];
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-recipes") && i != argc - 1)
+    {
+      Shape.RecipeCount = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-ingredients") && i != argc - 1)
+    {
+      Shape.IngredientsPerRecipe = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-statements") && i != argc - 1)
+    {
+      Shape.StatementsPerLoop = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-loop-depth") && i != argc - 1)
+    {
+      Shape.LoopDepth = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-loop-iterations") && i != argc - 1)
+    {
+      Shape.LoopIterations = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-serve") && i != argc - 1)
+    {
+      ++i;
+      if (!std::strcmp(argv[i], "fan-out"))
+      {
+        Shape.Serving = ServePattern::FanOut;
+      }
+      else if (!std::strcmp(argv[i], "chain"))
+      {
+        Shape.Serving = ServePattern::Chain;
+      }
+      else
+      {
+        std::cerr << "Invalid serve pattern '" << argv[i] << "'" << std::endl;
+        return 1;
+      }
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-recursion-depth") && i != argc - 1)
+    {
+      Shape.RecursionDepth = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-bowls") && i != argc - 1)
+    {
+      Shape.BowlSpread = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-outputs") && i != argc - 1)
+    {
+      Shape.OutputValues = std::strtoull(argv[++i], nullptr, 10);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-takes") && i != argc - 1)
+    {
+      Shape.TakeCount = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-seed") && i != argc - 1)
+    {
+      Shape.Seed = std::strtoul(argv[++i], nullptr, 10);
+      continue;
+    }
+    std::cerr << "Unknown option '" << argv[i] << "'" << std::endl;
+    return 1;
+  }
+
+  // Without its input, a program that takes from the refrigerator would wait
+  // forever for it.
+  if (Shape.TakeCount && InputFileName.empty())
+  {
+    std::cerr << "Programs with Take steps need an -input file" << std::endl;
+    return 1;
+  }
+
+  const GeneratedWorkload Workload = generateWorkload(Shape);
+
+  if (OutputFileName.empty())
+  {
+    std::cout << Workload.Program;
+  }
+  else if (!writeFile(OutputFileName, Workload.Program))
+  {
+    return 1;
+  }
+
+  if (!InputFileName.empty() && !writeFile(InputFileName, Workload.Input))
+  {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,83 @@
+#include "CheffeGeneratorUtils.h"
+
+#include <cctype>
+#include <cstring>
+#include <vector>
+
+namespace cheffe
+{
+
+std::string getSafeName(unsigned Number)
+{
+  const char Consonants[] = "bcdfghjklmnpqrstvwxz";
+  const unsigned NumConsonants = sizeof(Consonants) - 1;
+  std::string Name;
+  do
+  {
+    Name += Consonants[Number % NumConsonants];
+    Number /= NumConsonants;
+  } while (Number);
+  return Name;
+}
+
+static std::string getOrdinal(const unsigned Number)
+{
+  const char *Suffix = "th";
+  if (Number % 100 < 11 || Number % 100 > 13)
+  {
+    switch (Number % 10)
+    {
+    case 1:
+      Suffix = "st";
+      break;
+    case 2:
+      Suffix = "nd";
+      break;
+    case 3:
+      Suffix = "rd";
+      break;
+    }
+  }
+  return std::to_string(Number) + Suffix;
+}
+
+std::string getMixingBowl(const unsigned MixingBowlNo)
+{
+  return MixingBowlNo == 1 ? std::string("the mixing bowl")
+                           : "the " + getOrdinal(MixingBowlNo) + " mixing bowl";
+}
+
+const char *pickMeasure(const bool IsDry, std::mt19937 &Random)
+{
+  std::vector<const char *> Measures;
+  for (const MeasureKeyword &Measure : MeasureKeywordEntries)
+  {
+    if ((Measure.Kind != MeasureKindTy::Wet) == IsDry)
+    {
+      Measures.push_back(Measure.Name);
+    }
+  }
+  return Measures[Random() % Measures.size()];
+}
+
+std::string getMinutes(const unsigned Number)
+{
+  for (const TimeUnitKeyword &TimeUnit : TimeUnitKeywordEntries)
+  {
+    if (!std::strcmp(TimeUnit.Name, "minute"))
+    {
+      return std::to_string(Number) + " " +
+             (Number == 1 ? TimeUnit.Singular : TimeUnit.Plural);
+    }
+  }
+  return std::string();
+}
+
+std::string getLoopEnd(const VerbKeyword &Verb)
+{
+  std::string PastTense = Verb.PastTense;
+  PastTense[0] = static_cast<char>(std::tolower(PastTense[0]));
+  return PastTense;
+}
+
+} // end namespace cheffe
@@ -0,0 +1,40 @@
+#ifndef CHEFFE_GENERATOR_UTILS
+#define CHEFFE_GENERATOR_UTILS
+
+#include "Parser/CheffeKeywords.h"
+
+#include <random>
+#include <string>
+
+namespace cheffe
+{
+
+// The words the program generators write. Every keyword is drawn from the
+// parser's own tables, so that whatever they generate always parses.
+
+// Spells out a number in consonants, since identifiers can't contain digits
+// and a name with a vowel in it could turn out to be a word like 'into'.
+std::string getSafeName(unsigned Number);
+
+// Names a mixing bowl, leaving out the ordinal for the first.
+std::string getMixingBowl(const unsigned MixingBowlNo);
+
+template <typename EntryTy, std::size_t NumEntries>
+const EntryTy &pickEntry(const EntryTy (&Entries)[NumEntries],
+                         std::mt19937 &Random)
+{
+  return Entries[Random() % NumEntries];
+}
+
+// Picks a measure of the given kind. Unspecified measures count as dry.
+const char *pickMeasure(const bool IsDry, std::mt19937 &Random);
+
+// Spells out a number of minutes, such as '1 minute'.
+std::string getMinutes(const unsigned Number);
+
+// The past tense of a verb as it's written to close its loop.
+std::string getLoopEnd(const VerbKeyword &Verb);
+
+} // end namespace cheffe
+
+#endif // CHEFFE_GENERATOR_UTILS
@@ -0,0 +1,227 @@
+#include "CheffeRecipeGenerator.h"
+#include "CheffeGeneratorUtils.h"
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+namespace cheffe
+{
+
+static void generateIngredients(std::ostream &OS, const std::string &Title,
+                                const unsigned IngredientCount,
+                                std::mt19937 &Random)
+{
+  OS << Title << ".\n\n"
+     << "A generated recipe, of no culinary merit whatsoever.\n\n"
+     << "Ingredients.\n";
+  for (unsigned i = 0; i < IngredientCount; ++i)
+  {
+    OS << (Random() % 200 + 1) << " "
+       << pickEntry(MeasureKeywordEntries, Random).Name << " "
+       << "ingredient " << getSafeName(i) << "\n";
+  }
+}
+
+static void generateMethodStep(std::ostream &OS, const unsigned IngredientCount,
+                               std::mt19937 &Random)
+{
+  const std::string Ingredient =
+      "ingredient " + getSafeName(Random() % IngredientCount);
+  const std::string Bowl = getMixingBowl(Random() % 3 + 1);
+  switch (Random() % 6)
+  {
+  case 0:
+  case 1:
+    OS << "Put " << Ingredient << " into " << Bowl << ".\n";
+    break;
+  case 2:
+    OS << "Add " << Ingredient << " to " << Bowl << ".\n";
+    break;
+  case 3:
+    OS << "Combine " << Ingredient << " into " << Bowl << ".\n";
+    break;
+  case 4:
+    OS << "Fold " << Ingredient << " into " << Bowl << ".\n";
+    break;
+  case 5:
+    OS << "Stir " << Bowl << " for " << getMinutes(Random() % 4 + 2) << ".\n";
+    break;
+  }
+}
+
+static void generateRecipe(std::ostream &OS, const std::string &Title,
+                           const unsigned IngredientCount,
+                           const unsigned StepCount, std::mt19937 &Random)
+{
+  generateIngredients(OS, Title, IngredientCount, Random);
+
+  OS << "\nMethod.\n";
+  for (unsigned i = 0; i < StepCount; ++i)
+  {
+    generateMethodStep(OS, IngredientCount, Random);
+  }
+  OS << "Pour contents of the mixing bowl into the baking dish.\n";
+}
+
+// Writes a block of method steps wrapped in Depth nested verb loops, with a
+// 'Set aside' in the innermost one.
+static void generateLoopNest(std::ostream &OS, const unsigned Depth,
+                             const unsigned IngredientCount,
+                             std::mt19937 &Random)
+{
+  std::vector<const VerbKeyword *> Verbs;
+  std::vector<std::string> Ingredients;
+  for (unsigned i = 0; i < Depth; ++i)
+  {
+    Verbs.push_back(&pickEntry(VerbKeywordEntries, Random));
+    Ingredients.push_back("ingredient " +
+                          getSafeName(Random() % IngredientCount));
+    OS << Verbs.back()->Name << " " << Ingredients.back() << ".\n";
+  }
+  for (unsigned i = 0; i < 4; ++i)
+  {
+    generateMethodStep(OS, IngredientCount, Random);
+  }
+  if (Depth)
+  {
+    OS << "Set aside.\n";
+  }
+  for (unsigned i = Depth; i-- > 0;)
+  {
+    OS << Verbs[i]->Name << " " << Ingredients[i] << " until "
+       << getLoopEnd(*Verbs[i]) << ".\n";
+  }
+}
+
+std::string generateRecipeProgram(const std::size_t TargetSize,
+                                  const unsigned Seed)
+{
+  std::mt19937 Random(Seed);
+  std::ostringstream OS;
+
+  generateRecipe(OS, "Generated Main Course", 16, 64, Random);
+  OS << "\nServes 1.\n";
+
+  for (unsigned i = 0; static_cast<std::size_t>(OS.tellp()) < TargetSize; ++i)
+  {
+    OS << "\n";
+    generateRecipe(OS, "Generated Side Dish " + getSafeName(i), 16, 64,
+                   Random);
+  }
+
+  return OS.str();
+}
+
+std::string generateShapedProgram(const GeneratorShape &Shape)
+{
+  const unsigned IngredientCount = std::max(Shape.IngredientsPerRecipe, 1u);
+  std::mt19937 Random(Shape.Seed);
+  std::ostringstream OS;
+
+  // Recipes are filled out with loop nests until they're their share of the
+  // target size; without a recipe count, that share is about 4KB.
+  const std::size_t TargetRecipeSize =
+      Shape.RecipeCount
+          ? std::max<std::size_t>(Shape.TargetSize / Shape.RecipeCount, 1)
+          : 4096;
+  for (unsigned i = 0; Shape.RecipeCount
+                           ? i < Shape.RecipeCount
+                           : i == 0 || static_cast<std::size_t>(OS.tellp()) <
+                                           Shape.TargetSize;
+       ++i)
+  {
+    const std::size_t RecipeBegin = OS.tellp();
+    OS << (i ? "\n" : "");
+    generateIngredients(OS, i ? "Generated Side Dish " + getSafeName(i)
+                              : std::string("Generated Main Course"),
+                        IngredientCount, Random);
+    OS << "\nMethod.\n";
+    do
+    {
+      generateLoopNest(OS, Shape.LoopDepth, IngredientCount, Random);
+    } while (static_cast<std::size_t>(OS.tellp()) - RecipeBegin <
+                 TargetRecipeSize &&
+             static_cast<std::size_t>(OS.tellp()) < Shape.TargetSize);
+    OS << "Pour contents of the mixing bowl into the baking dish.\n";
+    if (!i)
+    {
+      OS << "\nServes 1.\n";
+    }
+  }
+
+  return OS.str();
+}
+
+std::string generateNumberDenseProgram(const std::size_t TargetSize,
+                                       const unsigned Seed)
+{
+  const unsigned IngredientCount = 256;
+  std::mt19937_64 Random(Seed);
+  std::mt19937 WordRandom(Seed);
+  std::ostringstream OS;
+
+  for (unsigned i = 0; static_cast<std::size_t>(OS.tellp()) < TargetSize; ++i)
+  {
+    OS << (i ? "\n" : "") << "Generated Larder " << getSafeName(i)
+       << ".\n\nIngredients.\n";
+    for (unsigned j = 0; j < IngredientCount; ++j)
+    {
+      // Shifting away a random number of bits spreads the values evenly over
+      // their lengths in digits, rather than making almost all of them long.
+      const unsigned long long Value =
+          (Random() >> 1) >> (Random() % 63);
+      OS << Value << " " << pickEntry(MeasureKeywordEntries, WordRandom).Name
+         << " ingredient " << getSafeName(j) << "\n";
+    }
+    OS << "\nMethod.\n"
+       << "Put ingredient " << getSafeName(0) << " into the mixing bowl.\n"
+       << "Pour contents of the mixing bowl into the baking dish.\n";
+    if (!i)
+    {
+      OS << "\nServes 1.\n";
+    }
+  }
+
+  return OS.str();
+}
+
+std::string generateLoopingRecipeProgram(const unsigned LoopCount)
+{
+  const std::size_t NumVerbs =
+      sizeof(VerbKeywordEntries) / sizeof(VerbKeywordEntries[0]);
+  const unsigned IngredientCount = 8;
+
+  std::ostringstream OS;
+  OS << "Looping Recipe.\n\n"
+     << "Ingredients.\n";
+  for (unsigned i = 0; i < IngredientCount; ++i)
+  {
+    OS << "1 g ingredient " << getSafeName(i) << "\n";
+  }
+
+  OS << "\nMethod.\n";
+  for (unsigned i = 0; i < LoopCount; i += 2)
+  {
+    const VerbKeyword &Outer = VerbKeywordEntries[i % NumVerbs];
+    const VerbKeyword &Inner = VerbKeywordEntries[(i + 1) % NumVerbs];
+    const std::string Ingredient =
+        "ingredient " + getSafeName(i % IngredientCount);
+
+    OS << Outer.Name << " " << Ingredient << ".\n"
+       << "Put " << Ingredient << " into the mixing bowl.\n";
+    if (i + 1 < LoopCount)
+    {
+      OS << Inner.Name << " " << Ingredient << ".\n"
+         << "Set aside.\n"
+         << Inner.Name << " until " << getLoopEnd(Inner) << ".\n";
+    }
+    OS << Outer.Name << " until " << getLoopEnd(Outer) << ".\n";
+  }
+  OS << "Pour contents of the mixing bowl into the baking dish.\n\n"
+     << "Serves 1.\n";
+
+  return OS.str();
+}
+
+} // end namespace cheffe
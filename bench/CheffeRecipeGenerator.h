@@ -0,0 +1,50 @@
+#ifndef CHEFFE_RECIPE_GENERATOR
+#define CHEFFE_RECIPE_GENERATOR
+
+#include <cstddef>
+#include <string>
+
+namespace cheffe
+{
+
+// Generates a valid Chef program of roughly the given size, for feeding the
+// benchmarks. Like generateWorkload, the generators here draw their keywords
+// from the parser's own tables. The same size and seed always produce the
+// same program.
+std::string generateRecipeProgram(const std::size_t TargetSize,
+                                  const unsigned Seed = 0);
+
+// The shape of a program for generateShapedProgram to generate.
+struct GeneratorShape
+{
+  // Roughly how many bytes of source to generate.
+  std::size_t TargetSize = 1 << 20;
+  // How many recipes to split it between, or zero for as many ~4KB recipes as
+  // it takes. A recipe always has at least one loop nest, so a large count
+  // can take the program past its target size.
+  unsigned RecipeCount = 0;
+  unsigned IngredientsPerRecipe = 16;
+  // How deeply the verb loops in each recipe's method are nested.
+  unsigned LoopDepth = 2;
+  unsigned Seed = 0;
+};
+
+// Generates a valid Chef program of the given shape. Every recipe's method is
+// a run of loop nests, each around a few of the same steps that
+// generateRecipeProgram uses.
+std::string generateShapedProgram(const GeneratorShape &Shape);
+
+// Generates a program of roughly the given size that is almost all ingredient
+// lists, with initial values of every length up to 19 digits, for stressing
+// the lexing and decoding of numbers.
+std::string generateNumberDenseProgram(const std::size_t TargetSize,
+                                       const unsigned Seed = 0);
+
+// Generates a program whose single recipe contains LoopCount verb loops,
+// nested two deep and broken out of with 'Set aside', for stressing the
+// parser's scope handling. It is meant to be parsed, not executed.
+std::string generateLoopingRecipeProgram(const unsigned LoopCount);
+
+} // end namespace cheffe
+
+#endif // CHEFFE_RECIPE_GENERATOR
@@ -0,0 +1,337 @@
+#include "CheffeWorkloadGenerator.h"
+#include "CheffeGeneratorUtils.h"
+
+#include <algorithm>
+#include <functional>
+#include <sstream>
+#include <vector>
+
+namespace cheffe
+{
+
+namespace
+{
+
+// The ingredients a generated recipe's steps work with. Constants are dry,
+// between one and nine, and never change, so that they're safe to divide by
+// and to stir with; everything else is liquid, so that adding the dry
+// ingredients always gives the same sum.
+struct RecipeIngredients
+{
+  std::vector<std::string> Constants;
+  std::vector<std::string> Scratch;
+  std::vector<std::string> Counters;
+};
+
+class WorkloadWriter
+{
+public:
+  WorkloadWriter(const WorkloadShape &Shape)
+      : Shape(Shape), Random(Shape.Seed),
+        IngredientCount(std::max(Shape.IngredientsPerRecipe, 2u)),
+        BowlSpread(std::max(Shape.BowlSpread, 1u))
+  {
+  }
+
+  GeneratedWorkload generate();
+
+private:
+  const WorkloadShape &Shape;
+  std::mt19937 Random;
+  const unsigned IngredientCount;
+  const unsigned BowlSpread;
+  std::ostringstream OS;
+
+  static std::string getSideDishTitle(const unsigned Index)
+  {
+    return "Workload Side Dish " + getSafeName(Index);
+  }
+
+  RecipeIngredients writeIngredients(const std::string &Title);
+  void writeStatementGroup(const RecipeIngredients &Ingredients);
+  void writeLoopNest(const RecipeIngredients &Ingredients, const unsigned Level,
+                     const std::function<void()> &WriteBody);
+  void writeVerbLoop(const std::string &Ingredient,
+                     const std::function<void()> &WriteBody);
+
+  void writeMainRecipe();
+  void writeSideRecipe(const unsigned Index);
+  void writeRecursiveRecipe();
+};
+
+} // end anonymous namespace
+
+RecipeIngredients WorkloadWriter::writeIngredients(const std::string &Title)
+{
+  RecipeIngredients Ingredients;
+
+  OS << Title << ".\n\n"
+     << "A generated workload, of no culinary merit whatsoever.\n\n"
+     << "Ingredients.\n";
+
+  const unsigned ConstantCount = IngredientCount / 2;
+  for (unsigned i = 0; i < IngredientCount; ++i)
+  {
+    if (i < ConstantCount)
+    {
+      Ingredients.Constants.push_back("constant " + getSafeName(i));
+      OS << (Random() % 9 + 1) << " ";
+      if (!(Random() % 4))
+      {
+        OS << pickEntry(MeasureTypeKeywordEntries, Random).Name << " ";
+      }
+      OS << pickMeasure(true, Random) << " " << Ingredients.Constants.back()
+         << "\n";
+    }
+    else
+    {
+      Ingredients.Scratch.push_back("scratch " + getSafeName(i));
+      OS << (Random() % 10) << " " << pickMeasure(false, Random) << " "
+         << Ingredients.Scratch.back() << "\n";
+    }
+  }
+
+  OS << Shape.LoopIterations << " " << pickMeasure(false, Random)
+     << " trips\n";
+  for (unsigned i = 0; i < Shape.LoopDepth; ++i)
+  {
+    Ingredients.Counters.push_back("counter " + getSafeName(i));
+    OS << "0 " << pickMeasure(false, Random) << " "
+       << Ingredients.Counters.back() << "\n";
+  }
+
+  return Ingredients;
+}
+
+void WorkloadWriter::writeStatementGroup(const RecipeIngredients &Ingredients)
+{
+  const std::string &Constant =
+      Ingredients.Constants[Random() % Ingredients.Constants.size()];
+  const std::string &Scratch =
+      Ingredients.Scratch[Random() % Ingredients.Scratch.size()];
+  const std::vector<std::string> &Operands =
+      Random() % 2 ? Ingredients.Constants : Ingredients.Scratch;
+  const std::string &Operand = Operands[Random() % Operands.size()];
+  const std::string Bowl = getMixingBowl(Random() % BowlSpread + 1);
+
+  switch (Random() % 8)
+  {
+  case 0:
+    OS << "Put " << Operand << " into " << Bowl << ".\n"
+       << "Add " << Constant << " to " << Bowl << ".\n"
+       << "Fold " << Scratch << " into " << Bowl << ".\n";
+    break;
+  case 1:
+    OS << "Put " << Operand << " into " << Bowl << ".\n"
+       << "Remove " << Constant << " from " << Bowl << ".\n"
+       << "Fold " << Scratch << " into " << Bowl << ".\n";
+    break;
+  case 2:
+    OS << "Put " << Operand << " into " << Bowl << ".\n"
+       << "Combine " << Constant << " into " << Bowl << ".\n"
+       << "Divide " << Constant << " into " << Bowl << ".\n"
+       << "Fold " << Scratch << " into " << Bowl << ".\n";
+    break;
+  case 3:
+    OS << "Put " << Operand << " into " << Bowl << ".\n"
+       << "Put " << Constant << " into " << Bowl << ".\n"
+       << "Stir " << Bowl << " for " << getMinutes(Random() % 3 + 1) << ".\n"
+       << "Fold " << Scratch << " into " << Bowl << ".\n"
+       << "Fold " << Scratch << " into " << Bowl << ".\n";
+    break;
+  case 4:
+    OS << "Put " << Operand << " into " << Bowl << ".\n"
+       << "Put " << Constant << " into " << Bowl << ".\n"
+       << "Stir " << Constant << " into " << Bowl << ".\n"
+       << "Fold " << Scratch << " into " << Bowl << ".\n"
+       << "Fold " << Scratch << " into " << Bowl << ".\n";
+    break;
+  case 5:
+    OS << "Put " << Operand << " into " << Bowl << ".\n"
+       << "Put " << Constant << " into " << Bowl << ".\n"
+       << "Mix " << Bowl << " well.\n"
+       << "Fold " << Scratch << " into " << Bowl << ".\n"
+       << "Fold " << Scratch << " into " << Bowl << ".\n";
+    break;
+  case 6:
+    OS << "Add dry ingredients to " << Bowl << ".\n"
+       << "Fold " << Scratch << " into " << Bowl << ".\n";
+    break;
+  case 7:
+    OS << "Put " << Operand << " into " << Bowl << ".\n"
+       << "Liquefy contents of " << Bowl << ".\n"
+       << "Clean " << Bowl << ".\n";
+    break;
+  }
+}
+
+void WorkloadWriter::writeVerbLoop(const std::string &Ingredient,
+                                   const std::function<void()> &WriteBody)
+{
+  const VerbKeyword &Verb = pickEntry(VerbKeywordEntries, Random);
+
+  OS << Verb.Name << " the " << Ingredient << ".\n";
+  WriteBody();
+  OS << Verb.Name << " the " << Ingredient << " until " << getLoopEnd(Verb)
+     << ".\n";
+}
+
+// Every loop's counter is reset from 'trips' just before the loop, so that
+// inner loops go round the full number of times on every pass of the outer
+// ones.
+void WorkloadWriter::writeLoopNest(const RecipeIngredients &Ingredients,
+                                   const unsigned Level,
+                                   const std::function<void()> &WriteBody)
+{
+  if (Level == Ingredients.Counters.size())
+  {
+    WriteBody();
+    return;
+  }
+
+  const std::string &Counter = Ingredients.Counters[Level];
+  OS << "Put trips into the mixing bowl.\n"
+     << "Fold " << Counter << " into the mixing bowl.\n";
+  writeVerbLoop(Counter, [&]() {
+    writeLoopNest(Ingredients, Level + 1, WriteBody);
+  });
+}
+
+void WorkloadWriter::writeMainRecipe()
+{
+  const RecipeIngredients Ingredients =
+      writeIngredients("Generated Workload");
+  if (Shape.RecursionDepth)
+  {
+    OS << Shape.RecursionDepth << " " << pickMeasure(false, Random)
+       << " recursion depth\n";
+  }
+  if (Shape.OutputValues)
+  {
+    OS << Shape.OutputValues << " " << pickMeasure(false, Random)
+       << " outputs\n";
+  }
+
+  OS << "\nMethod.\n";
+  writeLoopNest(Ingredients, 0, [&]() {
+    for (unsigned i = 0; i < Shape.TakeCount; ++i)
+    {
+      OS << "Take "
+         << Ingredients.Scratch[Random() % Ingredients.Scratch.size()]
+         << " from the refrigerator.\n";
+    }
+    for (unsigned i = 0; i < Shape.StatementsPerLoop; ++i)
+    {
+      writeStatementGroup(Ingredients);
+    }
+    for (unsigned i = 1; i < Shape.RecipeCount; ++i)
+    {
+      OS << "Serve with " << getSideDishTitle(i) << ".\n";
+      if (Shape.Serving == ServePattern::Chain)
+      {
+        break;
+      }
+    }
+    if (Shape.RecursionDepth)
+    {
+      OS << "Put recursion depth into the mixing bowl.\n"
+         << "Serve with Workload Recursion.\n"
+         << "Clean the mixing bowl.\n";
+    }
+  });
+
+  if (Shape.OutputValues)
+  {
+    const std::string &Constant =
+        Ingredients.Constants[Random() % Ingredients.Constants.size()];
+    writeVerbLoop("outputs", [&]() {
+      OS << "Put " << Constant << " into the mixing bowl.\n"
+         << "Pour contents of the mixing bowl into the baking dish.\n"
+         << "Clean the mixing bowl.\n";
+    });
+    OS << "\nServes 1.\n";
+  }
+}
+
+void WorkloadWriter::writeSideRecipe(const unsigned Index)
+{
+  const RecipeIngredients Ingredients =
+      writeIngredients(getSideDishTitle(Index));
+
+  OS << "\nMethod.\n";
+  writeLoopNest(Ingredients, 0, [&]() {
+    for (unsigned i = 0; i < Shape.StatementsPerLoop; ++i)
+    {
+      writeStatementGroup(Ingredients);
+    }
+    if (Shape.Serving == ServePattern::Chain && Index + 1 < Shape.RecipeCount)
+    {
+      OS << "Serve with " << getSideDishTitle(Index + 1) << ".\n";
+    }
+  });
+}
+
+// The recursive recipe takes the depth left from the top of the caller's
+// mixing bowl, and serves itself with one less until there's none left.
+void WorkloadWriter::writeRecursiveRecipe()
+{
+  const RecipeIngredients Ingredients = writeIngredients("Workload Recursion");
+  OS << "0 " << pickMeasure(false, Random) << " remaining depth\n"
+     << "1 " << pickMeasure(true, Random) << " decrement\n";
+
+  OS << "\nMethod.\n"
+     << "Fold remaining depth into the mixing bowl.\n";
+  writeVerbLoop("remaining depth", [&]() {
+    for (unsigned i = 0; i < Shape.StatementsPerLoop; ++i)
+    {
+      writeStatementGroup(Ingredients);
+    }
+    OS << "Put remaining depth into the mixing bowl.\n"
+       << "Remove decrement from the mixing bowl.\n"
+       << "Serve with Workload Recursion.\n"
+       << "Set aside.\n";
+  });
+  OS << "Clean the mixing bowl.\n";
+}
+
+GeneratedWorkload WorkloadWriter::generate()
+{
+  writeMainRecipe();
+  for (unsigned i = 1; i < Shape.RecipeCount; ++i)
+  {
+    OS << "\n";
+    writeSideRecipe(i);
+  }
+  if (Shape.RecursionDepth)
+  {
+    OS << "\n";
+    writeRecursiveRecipe();
+  }
+
+  GeneratedWorkload Workload;
+  Workload.Program = OS.str();
+
+  // The main recipe's innermost loop, and so its Take steps, runs once for
+  // every combination of its loop counters.
+  unsigned long long TakesRun = Shape.TakeCount;
+  for (unsigned i = 0; i < Shape.LoopDepth; ++i)
+  {
+    TakesRun *= Shape.LoopIterations;
+  }
+  std::ostringstream Input;
+  for (unsigned long long i = 0; i < TakesRun; ++i)
+  {
+    Input << (Random() % 100) << "\n";
+  }
+  Workload.Input = Input.str();
+
+  return Workload;
+}
+
+GeneratedWorkload generateWorkload(const WorkloadShape &Shape)
+{
+  WorkloadWriter Writer(Shape);
+  return Writer.generate();
+}
+
+} // end namespace cheffe
@@ -0,0 +1,69 @@
+#ifndef CHEFFE_WORKLOAD_GENERATOR
+#define CHEFFE_WORKLOAD_GENERATOR
+
+#include <string>
+
+namespace cheffe
+{
+
+// How the side recipes of a generated workload are served.
+enum class ServePattern
+{
+  // The main recipe serves every side recipe from its innermost loop.
+  FanOut,
+  // The main recipe serves the first side recipe, which serves the second,
+  // and so on, each from its innermost loop.
+  Chain
+};
+
+// The shape of a workload for generateWorkload to generate. Unlike the
+// programs generateShapedProgram writes, which are only meant to be parsed,
+// a workload is meant to be run: it always terminates, never fails at run
+// time and prints exactly OutputValues numbers.
+struct WorkloadShape
+{
+  // How many recipes to generate, including the main recipe, but not counting
+  // the recursive recipe.
+  unsigned RecipeCount = 4;
+  // How many constant and scratch ingredients each recipe has, on top of the
+  // ones that count its loops.
+  unsigned IngredientsPerRecipe = 8;
+  // How many groups of steps go in each recipe's innermost loop. Every group
+  // leaves the mixing bowls as it found them.
+  unsigned StatementsPerLoop = 8;
+  // How deeply the verb loops in each recipe are nested, and how many times
+  // each of them goes round. The innermost loop of a recipe is run
+  // LoopIterations^LoopDepth times each time the recipe is.
+  unsigned LoopDepth = 2;
+  unsigned LoopIterations = 4;
+  ServePattern Serving = ServePattern::FanOut;
+  // If non-zero, the main recipe's innermost loop also serves a recipe which
+  // serves itself this many times over.
+  unsigned RecursionDepth = 0;
+  // How many mixing bowls the steps are spread over.
+  unsigned BowlSpread = 2;
+  // How many numbers the program prints, from a loop at the end of the main
+  // recipe.
+  unsigned long long OutputValues = 16;
+  // How many ingredients the main recipe's innermost loop takes from the
+  // refrigerator each time round.
+  unsigned TakeCount = 0;
+  unsigned Seed = 0;
+};
+
+// A generated program, along with the standard input it reads.
+struct GeneratedWorkload
+{
+  std::string Program;
+  // One number per line, for each of the program's Take steps to read.
+  std::string Input;
+};
+
+// Generates a workload of the given shape. The verbs, measures and time units
+// it uses come from the parser's own keyword tables, so the program always
+// parses. The same shape always produces the same workload.
+GeneratedWorkload generateWorkload(const WorkloadShape &Shape);
+
+} // end namespace cheffe
+
+#endif // CHEFFE_WORKLOAD_GENERATOR
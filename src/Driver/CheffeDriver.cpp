@@ -1,9 +1,59 @@
 #include "Driver/CheffeDriver.h"
 #include "Parser/CheffeParser.h"
+#include "Linker/CheffeLinker.h"
 #include "JIT/CheffeJIT.h"
 
 namespace cheffe
 {
+
+// Loads a lazily-parsed recipe by parsing its source range with a parser of
+// its own, then linking it into the program.
+class CheffeLazyRecipeLoader : public CheffeRecipeLoader
+{
+public:
+  CheffeLazyRecipeLoader(const CheffeSourceFile &SrcFile,
+                         std::shared_ptr<CheffeParserOptions> Opts,
+                         std::shared_ptr<CheffeDiagnosticHandler> Diags,
+                         CheffePhaseTimings *PhaseTimings)
+      : File(SrcFile), Options(Opts), Diagnostics(Diags),
+        Timings(PhaseTimings)
+  {
+  }
+
+  CheffeErrorCode loadRecipe(CheffeProgramInfo &ProgramInfo,
+                             const unsigned RecipeIdx) override
+  {
+    CheffeParser Parser;
+    Parser.setSourceFile(File);
+    Parser.setOptions(Options);
+    Parser.setDiagnosticHandler(Diagnostics);
+    Parser.setPhaseTimings(Timings);
+
+    CheffeRecipeInfo *Recipe = nullptr;
+    const SourceLocation Range =
+        ProgramInfo.getRecipe(RecipeIdx)->getSourceRange();
+    if (Parser.parseRecipeInRange(Range, Recipe) !=
+        CheffeErrorCode::CHEFFE_SUCCESS)
+    {
+      return CheffeErrorCode::CHEFFE_ERROR;
+    }
+
+    std::unique_ptr<CheffeProgramInfo> Owner = Parser.takeProgramInfo();
+    ProgramInfo.replaceRecipe(RecipeIdx, Recipe, *Owner);
+    ProgramInfo.getArena().adopt(Owner->getArena());
+
+    CheffeLinker Linker(Diagnostics);
+    Linker.setPhaseTimings(Timings);
+    return Linker.linkRecipe(ProgramInfo, *Recipe);
+  }
+
+private:
+  CheffeSourceFile File;
+  std::shared_ptr<CheffeParserOptions> Options;
+  std::shared_ptr<CheffeDiagnosticHandler> Diagnostics;
+  CheffePhaseTimings *Timings;
+};
+
 void CheffeDriver::setSourceFile(const CheffeSourceFile &SrcFile)
 {
   File = SrcFile;
@@ -24,7 +74,7 @@ std::shared_ptr<CheffeParserOptions> CheffeDriver::getParserOptions() const
 CheffeErrorCode
 CheffeDriver::compileProgram(std::unique_ptr<CheffeProgramInfo> &ProgramInfo)
 {
-  if (File.Source.empty())
+  if (File.empty())
   {
     return CheffeErrorCode::CHEFFE_ERROR;
   }
@@ -51,6 +101,57 @@ CheffeDriver::compileProgram(std::unique_ptr<CheffeProgramInfo> &ProgramInfo)
     return CheffeErrorCode::CHEFFE_ERROR;
   }
 
+  const std::shared_ptr<CheffeParserOptions> Options = Parser.getOptions();
+  if (Options->getLazyParsing())
+  {
+    return loadProgramLazily(*ProgramInfo, Options->getVerifyAll());
+  }
+
+  CheffeLinker Linker(Diagnostics);
+  Linker.setPhaseTimings(Timings);
+  Success = Linker.linkProgram(*ProgramInfo);
+
+  return Success;
+}
+
+// Recipes are linked as they're loaded, so only the entry point is loaded now;
+// the rest wait until they're served. With VerifyAll, every recipe is loaded
+// now instead, carrying on past failures so that they're all reported.
+CheffeErrorCode CheffeDriver::loadProgramLazily(CheffeProgramInfo &ProgramInfo,
+                                                const bool VerifyAll)
+{
+  ProgramInfo.setRecipeLoader(std::unique_ptr<CheffeRecipeLoader>(
+      new CheffeLazyRecipeLoader(File, Parser.getOptions(), Diagnostics,
+                                 Timings)));
+
+  if (!ProgramInfo.getNumRecipes())
+  {
+    return CheffeErrorCode::CHEFFE_ERROR;
+  }
+
+  // A program the parser couldn't index, it parsed in full instead, so
+  // there's nothing left to load.
+  if (ProgramInfo.getRecipe(0u)->isLoaded())
+  {
+    CheffeLinker Linker(Diagnostics);
+    Linker.setPhaseTimings(Timings);
+    return Linker.linkProgram(ProgramInfo);
+  }
+
+  if (!VerifyAll)
+  {
+    return ProgramInfo.loadRecipe(0);
+  }
+
+  CheffeErrorCode Success = CheffeErrorCode::CHEFFE_SUCCESS;
+  for (unsigned i = 0, e = ProgramInfo.getNumRecipes(); i != e; ++i)
+  {
+    if (ProgramInfo.loadRecipe(i) != CheffeErrorCode::CHEFFE_SUCCESS)
+    {
+      Success = CheffeErrorCode::CHEFFE_ERROR;
+    }
+  }
+
   return Success;
 }
 
@@ -58,6 +159,8 @@ CheffeErrorCode
 CheffeDriver::executeProgram(std::unique_ptr<CheffeProgramInfo> &ProgramInfo)
 {
   CheffeJIT JIT(std::move(ProgramInfo), Diagnostics);
+  JIT.setWorkCounts(WorkCounts);
+  JIT.setPhaseTimings(Timings);
 
   return JIT.executeProgram();
 }
@@ -4,7 +4,9 @@
 #include "cheffe.h"
 #include "Parser/CheffeParser.h"
 #include "IR/CheffeProgramInfo.h"
+#include "JIT/CheffeWorkCounts.h"
 #include "Utils/CheffeDiagnosticHandler.h"
+#include "Utils/CheffePhaseTimings.h"
 
 #include <vector>
 #include <memory>
@@ -14,7 +16,7 @@ namespace cheffe
 class CheffeDriver
 {
 public:
-  CheffeDriver()
+  CheffeDriver() : WorkCounts(nullptr), Timings(nullptr)
   {
   }
 
@@ -29,10 +31,29 @@ public:
 
   std::shared_ptr<CheffeParserOptions> getParserOptions() const;
 
+  // Has executeProgram count the work it does into Counts, if it isn't null.
+  void setWorkCounts(CheffeWorkCounts *Counts)
+  {
+    WorkCounts = Counts;
+  }
+
+  // Has compileProgram and executeProgram record the time spent in each of
+  // their phases, recipe by recipe, into Timings, if it isn't null.
+  void setPhaseTimings(CheffePhaseTimings *PhaseTimings)
+  {
+    Timings = PhaseTimings;
+    Parser.setPhaseTimings(PhaseTimings);
+  }
+
 private:
   CheffeParser Parser;
   CheffeSourceFile File;
   std::shared_ptr<CheffeDiagnosticHandler> Diagnostics;
+  CheffeWorkCounts *WorkCounts;
+  CheffePhaseTimings *Timings;
+
+  CheffeErrorCode loadProgramLazily(CheffeProgramInfo &ProgramInfo,
+                                    const bool VerifyAll);
 };
 }; // end namespace cheffe
 
@@ -0,0 +1,265 @@
+#include "Driver/CheffeIncrementalDriver.h"
+#include "Linker/CheffeLinker.h"
+#include "IR/CheffeRecipeInfo.h"
+#include "Utils/CheffeSourceBuffer.h"
+
+#include <unordered_map>
+
+namespace cheffe
+{
+
+// Replaced recipes aren't freed until the whole program is rebuilt, which
+// happens once there are more of them than this, and more of them than live
+// recipes. That keeps the arena at most a few times the size it needs to be.
+static const unsigned MinDeadRecipesForRebuild = 64;
+
+CheffeIncrementalDriver::CheffeIncrementalDriver()
+    : Options(new CheffeParserOptions()),
+      ProgramInfo(new CheffeProgramInfo()), NumRecipesParsed(0),
+      NumDeadRecipes(0)
+{
+}
+
+void CheffeIncrementalDriver::openDocument(const std::string &Name,
+                                           const std::string &NewText)
+{
+  Text = NewText;
+  updateSourceFile(Name);
+  parseAllSegments();
+  linkProgram();
+}
+
+CheffeErrorCode CheffeIncrementalDriver::applyEdit(const std::size_t Offset,
+                                                   const std::size_t Length,
+                                                   const std::string &NewText)
+{
+  if (Offset > Text.size() || Length > Text.size() - Offset ||
+      Text.size() - Length + NewText.size() > CheffeSourceBuffer::MaxBufferSize)
+  {
+    return CheffeErrorCode::CHEFFE_ERROR;
+  }
+
+  Text.replace(Offset, Length, NewText);
+  updateSourceFile(File.getName());
+
+  // Anything wholly before the edit hasn't moved, and anything wholly after it
+  // has moved by the same amount. A recipe whose range is exactly where it
+  // was, give or take that move, has exactly the same text, so it parses
+  // exactly as it did before.
+  const std::size_t OldEditEnd = Offset + Length;
+  const std::size_t NewEditEnd = Offset + NewText.size();
+  std::unordered_map<std::size_t, std::size_t> OldSegmentsByBegin;
+  for (std::size_t i = 0; i < Segments.size(); ++i)
+  {
+    OldSegmentsByBegin[Segments[i].Range.getBegin()] = i;
+  }
+
+  std::vector<RecipeSegment> OldSegments;
+  OldSegments.swap(Segments);
+  std::vector<bool> Reused(OldSegments.size(), false);
+  NumRecipesParsed = 0;
+
+  for (const SourceLocation &Range : CheffeParser::findRecipeRanges(Text))
+  {
+    std::size_t OldBegin = Range.getBegin();
+    std::size_t OldEnd = Range.getEnd();
+    bool CanReuse = Range.getEnd() <= Offset;
+    if (Range.getBegin() >= NewEditEnd)
+    {
+      OldBegin = Range.getBegin() - NewEditEnd + OldEditEnd;
+      OldEnd = Range.getEnd() - NewEditEnd + OldEditEnd;
+      CanReuse = true;
+    }
+
+    auto OldSegment = OldSegmentsByBegin.find(OldBegin);
+    if (CanReuse && OldSegment != std::end(OldSegmentsByBegin) &&
+        OldSegments[OldSegment->second].Range.getEnd() == OldEnd)
+    {
+      Reused[OldSegment->second] = true;
+      Segments.push_back(std::move(OldSegments[OldSegment->second]));
+      Segments.back().Range = Range;
+      continue;
+    }
+
+    Segments.emplace_back(Range);
+    parseSegment(Segments.back());
+  }
+
+  for (std::size_t i = 0; i < OldSegments.size(); ++i)
+  {
+    if (!Reused[i] && OldSegments[i].Recipe)
+    {
+      ++NumDeadRecipes;
+    }
+  }
+
+  if (NumDeadRecipes >= MinDeadRecipesForRebuild &&
+      NumDeadRecipes > Segments.size())
+  {
+    parseAllSegments();
+  }
+
+  linkProgram();
+  return CheffeErrorCode::CHEFFE_SUCCESS;
+}
+
+const std::string &CheffeIncrementalDriver::getText() const
+{
+  return Text;
+}
+
+const CheffeSourceFile &CheffeIncrementalDriver::getSourceFile() const
+{
+  return File;
+}
+
+std::vector<CheffeDiagnostic> CheffeIncrementalDriver::getDiagnostics() const
+{
+  std::vector<CheffeDiagnostic> Diagnostics;
+  for (const RecipeSegment &Segment : Segments)
+  {
+    const std::size_t ParsedBegin = Segment.ParsedRange.getBegin();
+    const std::size_t Begin = Segment.Range.getBegin();
+    for (const std::vector<CheffeDiagnostic> *SegmentDiagnostics :
+         {&Segment.ParseDiagnostics, &Segment.ProgramDiagnostics})
+    {
+      for (CheffeDiagnostic Diagnostic : *SegmentDiagnostics)
+      {
+        const SourceLocation Loc = Diagnostic.SourceLoc;
+        // Diagnostics about the recipe as a whole have no location of their
+        // own, so are put at the start of the recipe.
+        if (!Loc.getBegin() && !Loc.getLength())
+        {
+          Diagnostic.SourceLoc = SourceLocation(Begin, Begin);
+        }
+        else
+        {
+          Diagnostic.SourceLoc =
+              SourceLocation(Loc.getBegin() - ParsedBegin + Begin,
+                             Loc.getEnd() - ParsedBegin + Begin);
+        }
+        Diagnostics.push_back(Diagnostic);
+      }
+    }
+  }
+  return Diagnostics;
+}
+
+const CheffeProgramInfo &CheffeIncrementalDriver::getProgramInfo() const
+{
+  return *ProgramInfo;
+}
+
+std::shared_ptr<CheffeParserOptions>
+CheffeIncrementalDriver::getParserOptions() const
+{
+  return Options;
+}
+
+unsigned CheffeIncrementalDriver::getNumRecipeRanges() const
+{
+  return Segments.size();
+}
+
+unsigned CheffeIncrementalDriver::getNumRecipesParsed() const
+{
+  return NumRecipesParsed;
+}
+
+void CheffeIncrementalDriver::updateSourceFile(const std::string &Name)
+{
+  File = CheffeSourceFile(CheffeSourceBuffer::getMemBuffer(Name, Text));
+}
+
+// Starts again with a fresh program, parsing every recipe range in it.
+void CheffeIncrementalDriver::parseAllSegments()
+{
+  ProgramInfo.reset(new CheffeProgramInfo());
+  Segments.clear();
+  NumRecipesParsed = 0;
+  NumDeadRecipes = 0;
+
+  for (const SourceLocation &Range : CheffeParser::findRecipeRanges(Text))
+  {
+    Segments.emplace_back(Range);
+    parseSegment(Segments.back());
+  }
+}
+
+// Parses the segment's range with a parser of its own, then moves whatever
+// recipe came of it into the program. A recipe that didn't parse cleanly is
+// kept unloaded, so that Serve steps naming it still resolve.
+void CheffeIncrementalDriver::parseSegment(RecipeSegment &Segment)
+{
+  ++NumRecipesParsed;
+
+  auto Diagnostics = std::make_shared<CheffeDiagnosticHandler>();
+  CheffeParser Parser;
+  Parser.setSourceFile(File);
+  Parser.setOptions(Options);
+  Parser.setDiagnosticHandler(Diagnostics);
+
+  CheffeRecipeInfo *Recipe = nullptr;
+  if (Parser.parseRecipeInRange(Segment.Range, Recipe) !=
+          CheffeErrorCode::CHEFFE_SUCCESS &&
+      Recipe)
+  {
+    Recipe->setUnloaded(Segment.Range);
+  }
+
+  if (Recipe)
+  {
+    std::unique_ptr<CheffeProgramInfo> Owner = Parser.takeProgramInfo();
+    Recipe->moveToProgram(ProgramInfo->getArena(), Owner->getSymbolTable(),
+                          ProgramInfo->getSymbolTable());
+    ProgramInfo->getArena().adopt(Owner->getArena());
+  }
+
+  Segment.ParsedRange = Segment.Range;
+  Segment.Recipe = Recipe;
+  Segment.ParseDiagnostics = Diagnostics->getDiagnostics();
+}
+
+// Puts the program back together from the segments' recipes, in source
+// order, then links every recipe that parsed. Linking is cheap next to
+// parsing, and any change to the recipe titles can change what every Serve
+// step refers to, so everything is linked again each time.
+void CheffeIncrementalDriver::linkProgram()
+{
+  auto Diagnostics = std::make_shared<CheffeDiagnosticHandler>();
+  CheffeLinker Linker(Diagnostics);
+
+  ProgramInfo->clearRecipes();
+  std::vector<bool> IsDuplicate(Segments.size(), false);
+  for (std::size_t i = 0; i < Segments.size(); ++i)
+  {
+    CheffeRecipeInfo *Recipe = Segments[i].Recipe;
+    if (Recipe && !ProgramInfo->insertRecipe(Recipe))
+    {
+      IsDuplicate[i] = true;
+    }
+  }
+
+  for (std::size_t i = 0; i < Segments.size(); ++i)
+  {
+    RecipeSegment &Segment = Segments[i];
+    const std::size_t Begin = Diagnostics->getDiagnostics().size();
+
+    if (IsDuplicate[i])
+    {
+      Diagnostics->report(Segment.Recipe->getTitleLoc(),
+                          diag::err_duplicate_recipe)
+          << Segment.Recipe->getRecipeTitle();
+    }
+    else if (Segment.Recipe && Segment.Recipe->isLoaded())
+    {
+      Linker.linkRecipe(*ProgramInfo, *Segment.Recipe);
+    }
+
+    const auto &AllDiagnostics = Diagnostics->getDiagnostics();
+    Segment.ProgramDiagnostics.assign(std::begin(AllDiagnostics) + Begin,
+                                      std::end(AllDiagnostics));
+  }
+}
+
+} // end namespace cheffe
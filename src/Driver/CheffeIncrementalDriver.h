@@ -0,0 +1,95 @@
+#ifndef CHEFFE_INCREMENTAL_DRIVER
+#define CHEFFE_INCREMENTAL_DRIVER
+
+#include "cheffe.h"
+#include "Parser/CheffeParser.h"
+#include "IR/CheffeProgramInfo.h"
+#include "Utils/CheffeDiagnosticHandler.h"
+#include "Utils/CheffeFileHandler.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cheffe
+{
+
+// Keeps a program checked as its source is edited, for long-lived processes
+// such as editor integrations. Each recipe range found by the pre-scan is
+// parsed on its own; after an edit, only the ranges the edit touched are
+// parsed again. Every other recipe, along with its diagnostics, is reused as
+// it was, having only moved in the source.
+//
+// As each recipe is checked on its own, an error in one recipe doesn't stop
+// the rest from being checked. Source locations inside a reused recipe still
+// point to where the recipe was when it was parsed; only the diagnostics
+// handed out by getDiagnostics are moved along with the text.
+class CheffeIncrementalDriver
+{
+public:
+  CheffeIncrementalDriver();
+
+  // Parses all of Text from scratch, replacing any previous document.
+  void openDocument(const std::string &Name, const std::string &Text);
+
+  // Replaces the Length bytes at Offset with Text, and reparses whichever
+  // recipes that changed. Does nothing, returning an error, if the range
+  // isn't inside the document.
+  CheffeErrorCode applyEdit(const std::size_t Offset, const std::size_t Length,
+                            const std::string &Text);
+
+  const std::string &getText() const;
+  const CheffeSourceFile &getSourceFile() const;
+
+  // The diagnostics for the document as it is now, recipe by recipe.
+  std::vector<CheffeDiagnostic> getDiagnostics() const;
+
+  // Recipes whose title could be parsed, in source order. Those that didn't
+  // parse cleanly are left unloaded, and duplicates are left out entirely.
+  const CheffeProgramInfo &getProgramInfo() const;
+
+  std::shared_ptr<CheffeParserOptions> getParserOptions() const;
+
+  // The number of recipe ranges in the document, and how many of them the
+  // last open or edit had to parse.
+  unsigned getNumRecipeRanges() const;
+  unsigned getNumRecipesParsed() const;
+
+private:
+  struct RecipeSegment
+  {
+    RecipeSegment(const SourceLocation Range)
+        : ParsedRange(Range), Range(Range), Recipe(nullptr)
+    {
+    }
+
+    // Where the recipe was when it was parsed, which is what its recipe and
+    // diagnostics refer to, and where it is now.
+    SourceLocation ParsedRange;
+    SourceLocation Range;
+    CheffeRecipeInfo *Recipe;
+    std::vector<CheffeDiagnostic> ParseDiagnostics;
+    // Duplicate titles and unresolved Serve steps, which depend on the other
+    // recipes, so are worked out again after every change.
+    std::vector<CheffeDiagnostic> ProgramDiagnostics;
+  };
+
+  std::string Text;
+  CheffeSourceFile File;
+  std::shared_ptr<CheffeParserOptions> Options;
+  std::unique_ptr<CheffeProgramInfo> ProgramInfo;
+  std::vector<RecipeSegment> Segments;
+  unsigned NumRecipesParsed;
+  // Recipes that were replaced, but are still taking up space in the
+  // program's arena.
+  unsigned NumDeadRecipes;
+
+  void updateSourceFile(const std::string &Name);
+  void parseAllSegments();
+  void parseSegment(RecipeSegment &Segment);
+  void linkProgram();
+};
+
+} // end namespace cheffe
+
+#endif // CHEFFE_INCREMENTAL_DRIVER
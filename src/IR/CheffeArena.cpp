@@ -0,0 +1,113 @@
+#include "IR/CheffeArena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+
+namespace cheffe
+{
+
+// Slabs start small, so that tiny programs stay tiny, and double in size up
+// to a limit as the program grows.
+static const std::size_t InitialSlabSize = 4096;
+static const std::size_t MaxSlabSize = 1 << 20;
+
+CheffeArena::~CheffeArena()
+{
+  for (DestructorNode *Node = Destructors; Node; Node = Node->Next)
+  {
+    Node->Destroy(Node->Object);
+  }
+  for (auto &Slab : Slabs)
+  {
+    std::free(Slab.first);
+  }
+}
+
+void *CheffeArena::allocate(const std::size_t Size,
+                            const std::size_t Alignment)
+{
+  assert(Alignment && !(Alignment & (Alignment - 1)) &&
+         "Alignment must be a power of two");
+
+  std::uintptr_t Ptr = reinterpret_cast<std::uintptr_t>(CurPtr);
+  std::uintptr_t Aligned = (Ptr + Alignment - 1) & ~(Alignment - 1);
+  if (!CurPtr || Aligned + Size > reinterpret_cast<std::uintptr_t>(End))
+  {
+    startNewSlab(Size + Alignment - 1);
+    Ptr = reinterpret_cast<std::uintptr_t>(CurPtr);
+    Aligned = (Ptr + Alignment - 1) & ~(Alignment - 1);
+  }
+
+  CurPtr = reinterpret_cast<char *>(Aligned + Size);
+  BytesAllocated += Size;
+  return reinterpret_cast<void *>(Aligned);
+}
+
+void CheffeArena::startNewSlab(const std::size_t MinSize)
+{
+  const std::size_t NumSlabs = std::min<std::size_t>(Slabs.size(), 8);
+  const std::size_t SlabSize =
+      std::max(std::min(InitialSlabSize << NumSlabs, MaxSlabSize), MinSize);
+
+  char *Slab = static_cast<char *>(std::malloc(SlabSize));
+  if (!Slab)
+  {
+    throw std::bad_alloc();
+  }
+
+  Slabs.emplace_back(Slab, SlabSize);
+  CurPtr = Slab;
+  End = Slab + SlabSize;
+}
+
+void CheffeArena::addDestructor(void *Object, void (*Destroy)(void *))
+{
+  auto *Node = static_cast<DestructorNode *>(
+      allocate(sizeof(DestructorNode), alignof(DestructorNode)));
+  Node->Destroy = Destroy;
+  Node->Object = Object;
+  Node->Next = Destructors;
+  Destructors = Node;
+}
+
+void CheffeArena::adopt(CheffeArena &Other)
+{
+  Slabs.insert(std::end(Slabs), std::begin(Other.Slabs),
+               std::end(Other.Slabs));
+  BytesAllocated += Other.BytesAllocated;
+
+  if (Other.Destructors)
+  {
+    DestructorNode *Tail = Other.Destructors;
+    while (Tail->Next)
+    {
+      Tail = Tail->Next;
+    }
+    Tail->Next = Destructors;
+    Destructors = Other.Destructors;
+  }
+
+  Other.Slabs.clear();
+  Other.CurPtr = Other.End = nullptr;
+  Other.BytesAllocated = 0;
+  Other.Destructors = nullptr;
+}
+
+std::size_t CheffeArena::getBytesAllocated() const
+{
+  return BytesAllocated;
+}
+
+std::size_t CheffeArena::getTotalMemory() const
+{
+  std::size_t Total = 0;
+  for (auto &Slab : Slabs)
+  {
+    Total += Slab.second;
+  }
+  return Total;
+}
+
+} // end namespace cheffe
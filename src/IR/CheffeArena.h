@@ -0,0 +1,76 @@
+#ifndef CHEFFE_ARENA
+#define CHEFFE_ARENA
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cheffe
+{
+
+// A bump-pointer allocator for the program's IR. Objects are carved out of
+// large slabs one after another, and are all destroyed and freed together
+// when the arena goes away; nothing can be freed individually.
+class CheffeArena
+{
+public:
+  CheffeArena() : CurPtr(nullptr), End(nullptr), BytesAllocated(0),
+                  Destructors(nullptr)
+  {
+  }
+
+  ~CheffeArena();
+
+  CheffeArena(const CheffeArena &) = delete;
+  CheffeArena &operator=(const CheffeArena &) = delete;
+
+  void *allocate(const std::size_t Size, const std::size_t Alignment);
+
+  // Constructs a T in the arena. Its destructor, if it has one that does
+  // anything, is run when the arena is destroyed.
+  template <typename T, typename... ArgTys> T *create(ArgTys &&... Args)
+  {
+    void *Mem = allocate(sizeof(T), alignof(T));
+    T *Object = new (Mem) T(std::forward<ArgTys>(Args)...);
+    if (!std::is_trivially_destructible<T>::value)
+    {
+      addDestructor(Object, [](void *Ptr)
+                    {
+        static_cast<T *>(Ptr)->~T();
+      });
+    }
+    return Object;
+  }
+
+  // Takes over everything allocated from Other, which is left empty. The
+  // objects themselves don't move, so pointers to them stay valid.
+  void adopt(CheffeArena &Other);
+
+  // The bytes handed out, and the bytes reserved from the system for them.
+  std::size_t getBytesAllocated() const;
+  std::size_t getTotalMemory() const;
+
+private:
+  struct DestructorNode
+  {
+    void (*Destroy)(void *);
+    void *Object;
+    DestructorNode *Next;
+  };
+
+  char *CurPtr;
+  char *End;
+  std::size_t BytesAllocated;
+  std::vector<std::pair<char *, std::size_t>> Slabs;
+  // Run in the reverse order to construction.
+  DestructorNode *Destructors;
+
+  void addDestructor(void *Object, void (*Destroy)(void *));
+  void startNewSlab(const std::size_t MinSize);
+};
+
+} // end namespace cheffe
+
+#endif // CHEFFE_ARENA
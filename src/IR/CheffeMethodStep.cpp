@@ -4,7 +4,7 @@
 namespace cheffe
 {
 
-static std::string getMethodStepKindAsString(const MethodStepKind Kind)
+std::string getMethodStepKindAsString(const MethodStepKind Kind)
 {
   switch (Kind)
   {
@@ -53,89 +53,123 @@ static std::string getMethodStepKindAsString(const MethodStepKind Kind)
   }
 }
 
-void MethodOp::dump(std::ostream &OS) const
-{
-  (void)OS;
-}
-
-CheffeIngredient *IngredientOp::getIngredient() const
-{
-  return Ingredient;
-}
-
-SourceLocation IngredientOp::getSourceLoc() const
+MethodOp MethodOp::createIngredient(CheffeIngredient *Ingredient,
+                                   const SourceLocation SourceLoc)
 {
-  return SourceLoc;
+  MethodOp Op;
+  Op.Kind = MethodOpKind::Ingredient;
+  Op.SourceLoc = SourceLoc;
+  Op.Ingredient = Ingredient;
+  return Op;
 }
 
-void IngredientOp::dump(std::ostream &OS) const
+MethodOp MethodOp::createMixingBowl(const unsigned MixingBowlNo)
 {
-  OS << "(Ingredient ";
-  if (Ingredient)
-  {
-    OS << *Ingredient;
-  }
-  else
-  {
-    OS << "<undef>";
-  }
-  OS << ")";
+  MethodOp Op;
+  Op.Kind = MethodOpKind::MixingBowl;
+  Op.MixingBowlNo = MixingBowlNo;
+  return Op;
 }
 
-unsigned MixingBowlOp::getMixingBowlNo() const
+MethodOp MethodOp::createBakingDish(const unsigned BakingDishNo)
 {
-  return MixingBowlNo;
+  MethodOp Op;
+  Op.Kind = MethodOpKind::BakingDish;
+  Op.BakingDishNo = BakingDishNo;
+  return Op;
 }
 
-void MixingBowlOp::dump(std::ostream &OS) const
+MethodOp MethodOp::createNumber(const long long NumberValue)
 {
-  OS << "(MixingBowl " << MixingBowlNo << ")";
+  MethodOp Op;
+  Op.Kind = MethodOpKind::Number;
+  Op.NumberValue = NumberValue;
+  return Op;
 }
 
-unsigned BakingDishOp::getBakingDishNo() const
+MethodOp MethodOp::createRecipe(const std::string *RecipeName,
+                                const SourceLocation SourceLoc)
 {
-  return BakingDishNo;
+  assert(RecipeName && "Invalid recipe name");
+  MethodOp Op;
+  Op.Kind = MethodOpKind::Recipe;
+  Op.SourceLoc = SourceLoc;
+  Op.RecipeName = RecipeName;
+  return Op;
 }
 
-void BakingDishOp::dump(std::ostream &OS) const
+void MethodOp::setRecipeIndex(const unsigned Idx)
 {
-  OS << "(BakingDish " << BakingDishNo << ")";
+  assert(Kind == MethodOpKind::Recipe && "Not a recipe operand!");
+  IsResolved = true;
+  RecipeIdx = Idx;
 }
 
-long long NumberOp::getNumberValue() const
+void MethodOp::clearRecipeIndex()
 {
-  return NumberValue;
+  assert(Kind == MethodOpKind::Recipe && "Not a recipe operand!");
+  IsResolved = false;
+  RecipeIdx = 0;
 }
 
-void NumberOp::dump(std::ostream &OS) const
-{
-  OS << "(Number " << NumberValue << ")";
-}
-
-SourceLocation RecipeOp::getSourceLoc() const
+void MethodOp::dump(std::ostream &OS) const
 {
-  return SourceLoc;
+  switch (Kind)
+  {
+  case MethodOpKind::Ingredient:
+    OS << "(Ingredient ";
+    if (Ingredient)
+    {
+      OS << *Ingredient;
+    }
+    else
+    {
+      OS << "<undef>";
+    }
+    OS << ")";
+    break;
+  case MethodOpKind::MixingBowl:
+    OS << "(MixingBowl " << MixingBowlNo << ")";
+    break;
+  case MethodOpKind::BakingDish:
+    OS << "(BakingDish " << BakingDishNo << ")";
+    break;
+  case MethodOpKind::Number:
+    OS << "(Number " << NumberValue << ")";
+    break;
+  case MethodOpKind::Recipe:
+    OS << "(Recipe '" << *RecipeName << "'";
+    if (IsResolved)
+    {
+      OS << " #" << RecipeIdx;
+    }
+    OS << ")";
+    break;
+  case MethodOpKind::Invalid:
+    break;
+  }
 }
 
-std::string RecipeOp::getRecipeName() const
+const MethodOp &CheffeMethodStep::getOperand(const unsigned Idx) const
 {
-  return RecipeName;
+  assert(Idx < NumOperands && "Invalid operand access!");
+  return MethodOps[Idx];
 }
 
-void RecipeOp::dump(std::ostream &OS) const
+MethodOp &CheffeMethodStep::getOperand(const unsigned Idx)
 {
-  OS << "(Recipe '" << RecipeName << "')";
+  assert(Idx < NumOperands && "Invalid operand access!");
+  return MethodOps[Idx];
 }
 
-MethodOp *CheffeMethodStep::getOperand(const unsigned Idx) const
+MethodStepKind CheffeMethodStep::getMethodStepKind() const
 {
-  assert(Idx < MethodOps.size() && "Invalid operand access!");
-  return MethodOps[Idx].get();
+  return Kind;
 }
 
-MethodStepKind CheffeMethodStep::getMethodStepKind() const
+unsigned CheffeMethodStep::getIndex() const
 {
-  return Kind;
+  return Index;
 }
 
 SourceLocation CheffeMethodStep::getSourceLoc() const
@@ -148,46 +182,53 @@ void CheffeMethodStep::setSourceLoc(const SourceLocation Loc)
   SourceLoc = Loc;
 }
 
+void CheffeMethodStep::addOperand(const MethodOp &Op)
+{
+  assert(NumOperands < MaxOperands && "Too many operands!");
+  MethodOps[NumOperands++] = Op;
+}
+
 void CheffeMethodStep::addIngredient(CheffeIngredient *Ingredient,
                                      const SourceLocation SourceLoc)
 {
-  MethodOps.push_back(std::make_unique<IngredientOp>(Ingredient, SourceLoc));
+  addOperand(MethodOp::createIngredient(Ingredient, SourceLoc));
 }
 
-void CheffeMethodStep::addIngredient(IngredientOp *IngredientOp)
+void CheffeMethodStep::addIngredient(const MethodOp &IngredientOp)
 {
-  assert(IngredientOp != nullptr && "Invalid ingredient information");
-  addIngredient(IngredientOp->getIngredient(), IngredientOp->getSourceLoc());
+  assert(IngredientOp.getKind() == MethodOpKind::Ingredient &&
+         "Invalid ingredient information");
+  addOperand(IngredientOp);
 }
 
 void CheffeMethodStep::addMixingBowl(const unsigned MixingBowlNo)
 {
-  MethodOps.push_back(std::make_unique<MixingBowlOp>(MixingBowlNo));
+  addOperand(MethodOp::createMixingBowl(MixingBowlNo));
 }
 
 void CheffeMethodStep::addBakingDish(const unsigned BakingDishNo)
 {
-  MethodOps.push_back(std::make_unique<BakingDishOp>(BakingDishNo));
+  addOperand(MethodOp::createBakingDish(BakingDishNo));
 }
 
 void CheffeMethodStep::addNumber(const long long NumberValue)
 {
-  MethodOps.push_back(std::make_unique<NumberOp>(NumberValue));
+  addOperand(MethodOp::createNumber(NumberValue));
 }
 
-void CheffeMethodStep::addRecipe(const std::string &RecipeName,
+void CheffeMethodStep::addRecipe(const std::string *RecipeName,
                                  const SourceLocation SourceLoc)
 {
-  MethodOps.push_back(std::make_unique<RecipeOp>(RecipeName, SourceLoc));
+  addOperand(MethodOp::createRecipe(RecipeName, SourceLoc));
 }
 
 std::ostream &operator<<(std::ostream &OS, const CheffeMethodStep &MethodStep)
 {
   OS << getMethodStepKindAsString(MethodStep.Kind);
-  for (auto &Op : MethodStep.MethodOps)
+  for (unsigned i = 0; i < MethodStep.NumOperands; ++i)
   {
     OS << ", ";
-    Op->dump(OS);
+    MethodStep.MethodOps[i].dump(OS);
   }
   OS << std::endl;
   return OS;
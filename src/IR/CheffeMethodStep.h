@@ -4,9 +4,8 @@
 #include "Lexer/CheffeToken.h"
 #include "IR/CheffeIngredient.h"
 
-#include <vector>
+#include <string>
 #include <ostream>
-#include <memory>
 #include <cassert>
 
 namespace cheffe
@@ -37,145 +36,163 @@ enum class MethodStepKind
   Invalid
 };
 
-class MethodOp
-{
-public:
-  MethodOp()
-  {
-  }
+// The upper-case name of the kind, as debug output prints it.
+std::string getMethodStepKindAsString(const MethodStepKind Kind);
 
-  virtual ~MethodOp()
-  {
-  }
-
-  virtual void dump(std::ostream &OS) const;
+enum class MethodOpKind : unsigned char
+{
+  Ingredient,
+  MixingBowl,
+  BakingDish,
+  Number,
+  Recipe,
+  Invalid
 };
 
-class IngredientOp : public MethodOp
+// An operand of a method step: a small tagged value, stored inline in its
+// method step. The accessors for each kind of operand assert that the operand
+// is of that kind.
+class MethodOp
 {
 public:
-  IngredientOp() : MethodOp(), Ingredient(nullptr)
-  {
-  }
-
-  ~IngredientOp() override
+  MethodOp()
+      : Kind(MethodOpKind::Invalid), IsResolved(false), RecipeIdx(0),
+        NumberValue(0)
   {
   }
 
-  IngredientOp(CheffeIngredient *Ingredient, const SourceLocation SourceLoc)
-      : MethodOp(), Ingredient(Ingredient), SourceLoc(SourceLoc)
-  {
-  }
+  static MethodOp createIngredient(CheffeIngredient *Ingredient,
+                                   const SourceLocation SourceLoc);
+  static MethodOp createMixingBowl(const unsigned MixingBowlNo);
+  static MethodOp createBakingDish(const unsigned BakingDishNo);
+  static MethodOp createNumber(const long long NumberValue);
+  // The recipe name must outlive the operand.
+  static MethodOp createRecipe(const std::string *RecipeName,
+                               const SourceLocation SourceLoc);
 
-  CheffeIngredient *getIngredient() const;
+  MethodOpKind getKind() const;
 
+  // Only ingredient and recipe operands have a location.
   SourceLocation getSourceLoc() const;
 
-  void dump(std::ostream &OS) const override;
-
-private:
-  CheffeIngredient *Ingredient;
-  SourceLocation SourceLoc;
-};
-
-class MixingBowlOp : public MethodOp
-{
-public:
-  MixingBowlOp() : MethodOp(), MixingBowlNo(1)
-  {
-  }
-
-  MixingBowlOp(const unsigned MixingBowl) : MethodOp(), MixingBowlNo(MixingBowl)
-  {
-  }
+  CheffeIngredient *getIngredient() const;
 
   unsigned getMixingBowlNo() const;
 
-  void dump(std::ostream &OS) const override;
-
-private:
-  unsigned MixingBowlNo;
-};
+  unsigned getBakingDishNo() const;
 
-class BakingDishOp : public MethodOp
-{
-public:
-  BakingDishOp() : MethodOp(), BakingDishNo(1)
-  {
-  }
+  long long getNumberValue() const;
 
-  BakingDishOp(const unsigned BakingDish) : MethodOp(), BakingDishNo(BakingDish)
-  {
-  }
+  const std::string &getRecipeName() const;
 
-  unsigned getBakingDishNo() const;
+  // Set by the linker once the recipe name has been bound to a recipe.
+  bool isResolved() const;
+  unsigned getRecipeIndex() const;
+  void setRecipeIndex(const unsigned Idx);
+  void clearRecipeIndex();
 
-  void dump(std::ostream &OS) const override;
+  void dump(std::ostream &OS) const;
 
 private:
-  unsigned BakingDishNo = 1;
-};
-
-class NumberOp : public MethodOp
-{
-public:
-  NumberOp() : MethodOp(), NumberValue(0)
+  MethodOpKind Kind;
+  bool IsResolved;
+  unsigned RecipeIdx;
+  SourceLocation SourceLoc;
+  union
   {
-  }
+    CheffeIngredient *Ingredient;
+    unsigned MixingBowlNo;
+    unsigned BakingDishNo;
+    long long NumberValue;
+    const std::string *RecipeName;
+  };
+};
 
-  NumberOp(const long long Value) : MethodOp(), NumberValue(Value)
-  {
-  }
+static_assert(sizeof(MethodOp) == 24, "MethodOp should stay small");
 
-  long long getNumberValue() const;
+inline MethodOpKind MethodOp::getKind() const
+{
+  return Kind;
+}
 
-  void dump(std::ostream &OS) const override;
+inline SourceLocation MethodOp::getSourceLoc() const
+{
+  assert((Kind == MethodOpKind::Ingredient || Kind == MethodOpKind::Recipe) &&
+         "Operand has no source location!");
+  return SourceLoc;
+}
 
-private:
-  long long NumberValue = 0;
-};
+inline CheffeIngredient *MethodOp::getIngredient() const
+{
+  assert(Kind == MethodOpKind::Ingredient && "Not an ingredient operand!");
+  return Ingredient;
+}
 
-class RecipeOp : public MethodOp
+inline unsigned MethodOp::getMixingBowlNo() const
 {
-public:
-  RecipeOp() : MethodOp(), RecipeName("")
-  {
-  }
+  assert(Kind == MethodOpKind::MixingBowl && "Not a mixing bowl operand!");
+  return MixingBowlNo;
+}
 
-  RecipeOp(const std::string &Recipe, const SourceLocation SourceLoc)
-      : MethodOp(), RecipeName(Recipe), SourceLoc(SourceLoc)
-  {
-  }
+inline unsigned MethodOp::getBakingDishNo() const
+{
+  assert(Kind == MethodOpKind::BakingDish && "Not a baking dish operand!");
+  return BakingDishNo;
+}
 
-  std::string getRecipeName() const;
+inline long long MethodOp::getNumberValue() const
+{
+  assert(Kind == MethodOpKind::Number && "Not a number operand!");
+  return NumberValue;
+}
 
-  SourceLocation getSourceLoc() const;
+inline const std::string &MethodOp::getRecipeName() const
+{
+  assert(Kind == MethodOpKind::Recipe && "Not a recipe operand!");
+  return *RecipeName;
+}
 
-  void dump(std::ostream &OS) const override;
+inline bool MethodOp::isResolved() const
+{
+  assert(Kind == MethodOpKind::Recipe && "Not a recipe operand!");
+  return IsResolved;
+}
 
-private:
-  std::string RecipeName = "";
-  SourceLocation SourceLoc;
-};
+inline unsigned MethodOp::getRecipeIndex() const
+{
+  assert(Kind == MethodOpKind::Recipe && "Not a recipe operand!");
+  assert(IsResolved && "Recipe operand hasn't been linked!");
+  return RecipeIdx;
+}
 
+// Method steps live in the program's arena, and are freed along with the rest
+// of the program.
 class CheffeMethodStep
 {
 public:
-  CheffeMethodStep(const MethodStepKind Kind) : Kind(Kind)
+  CheffeMethodStep(const MethodStepKind Kind, const unsigned Index)
+      : Kind(Kind), Index(Index)
   {
   }
 
+  CheffeMethodStep(const CheffeMethodStep &) = delete;
+  CheffeMethodStep &operator=(const CheffeMethodStep &) = delete;
+
   MethodStepKind getMethodStepKind() const;
 
+  // The position of this method step within its recipe's method.
+  unsigned getIndex() const;
+
   SourceLocation getSourceLoc() const;
   void setSourceLoc(const SourceLocation Loc);
 
-  MethodOp *getOperand(const unsigned Idx) const;
+  const MethodOp &getOperand(const unsigned Idx) const;
+  MethodOp &getOperand(const unsigned Idx);
 
   void addIngredient(CheffeIngredient *IngredientInfo,
                      const SourceLocation SourceLoc);
 
-  void addIngredient(IngredientOp *IngredientOp);
+  void addIngredient(const MethodOp &IngredientOp);
 
   void addMixingBowl(const unsigned MixingBowlNo);
 
@@ -183,15 +200,23 @@ public:
 
   void addNumber(const long long NumberValue);
 
-  void addRecipe(const std::string &RecipeName, const SourceLocation SourceLoc);
+  // The recipe name must outlive the method step.
+  void addRecipe(const std::string *RecipeName, const SourceLocation SourceLoc);
 
   friend std::ostream &operator<<(std::ostream &OS,
                                   const CheffeMethodStep &MethodStep);
 
+  // No method step takes more operands than this.
+  static const unsigned MaxOperands = 3;
+
 private:
   MethodStepKind Kind;
+  unsigned Index;
   SourceLocation SourceLoc;
-  std::vector<std::unique_ptr<MethodOp>> MethodOps;
+  unsigned NumOperands = 0;
+  MethodOp MethodOps[MaxOperands];
+
+  void addOperand(const MethodOp &Op);
 };
 
 } // end namespace cheffe
@@ -1,39 +1,154 @@
-#include "Utils/CheffeUtils.h"
 #include "IR/CheffeProgramInfo.h"
 
+#include <cassert>
+#include <cctype>
+
 namespace cheffe
 {
 
-std::shared_ptr<CheffeRecipeInfo>
-CheffeProgramInfo::getRecipe(const std::string &RecipeTitle) const
+// FNV-1a over the lower-cased title.
+std::size_t
+CheffeProgramInfo::TitleHash::operator()(const StringRef Title) const
+{
+  std::size_t Hash = static_cast<std::size_t>(14695981039346656037ULL);
+  for (const char C : Title)
+  {
+    Hash ^= static_cast<unsigned char>(
+        std::tolower(static_cast<unsigned char>(C)));
+    Hash *= static_cast<std::size_t>(1099511628211ULL);
+  }
+  return Hash;
+}
+
+CheffeRecipeInfo *
+CheffeProgramInfo::getRecipe(const StringRef RecipeTitle) const
+{
+  unsigned RecipeIdx = 0;
+  if (!getRecipeIndex(RecipeTitle, RecipeIdx))
+  {
+    return nullptr;
+  }
+  return getRecipe(RecipeIdx);
+}
+
+CheffeRecipeInfo *CheffeProgramInfo::getRecipe(const unsigned RecipeIdx) const
+{
+  assert(RecipeIdx < Recipes.size() && "Invalid recipe index!");
+  return Recipes[RecipeIdx];
+}
+
+bool CheffeProgramInfo::getRecipeIndex(const StringRef RecipeTitle,
+                                       unsigned &RecipeIdx) const
+{
+  auto RecipeIter = RecipeInfo.find(RecipeTitle);
+  if (RecipeIter == std::end(RecipeInfo))
+  {
+    return false;
+  }
+  RecipeIdx = RecipeIter->second;
+  return true;
+}
+
+unsigned CheffeProgramInfo::getNumRecipes() const
+{
+  return Recipes.size();
+}
+
+CheffeRecipeInfo *CheffeProgramInfo::getEntryPointRecipe() const
+{
+  return Recipes.empty() ? nullptr : Recipes.front();
+}
+
+CheffeSymbolTable &CheffeProgramInfo::getSymbolTable()
+{
+  return Symbols;
+}
+
+const CheffeSymbolTable &CheffeProgramInfo::getSymbolTable() const
 {
-  auto RecipeIter =
-      std::find_if(std::begin(RecipeInfo), std::end(RecipeInfo),
-                   [&RecipeTitle](const decltype(RecipeInfo)::value_type Recipe)
-                   {
-        return AreLowerCasedStringsEqual(RecipeTitle, Recipe.first);
-      });
-  return RecipeIter == std::end(RecipeInfo) ? nullptr : RecipeIter->second;
+  return Symbols;
 }
 
-std::shared_ptr<CheffeRecipeInfo> CheffeProgramInfo::getEntryPointRecipe()
+CheffeRecipeInfo *CheffeProgramInfo::addRecipe(const std::string &RecipeTitle)
 {
-  return getRecipe(EntryPointRecipeTitle);
+  if (getRecipe(RecipeTitle))
+  {
+    return nullptr;
+  }
+  CheffeRecipeInfo *Recipe = Arena.create<CheffeRecipeInfo>(RecipeTitle, Arena);
+  insertRecipe(Recipe);
+  return Recipe;
+}
+
+bool CheffeProgramInfo::adoptRecipe(CheffeRecipeInfo *Recipe,
+                                    const CheffeProgramInfo &Owner)
+{
+  if (getRecipe(Recipe->getRecipeTitle()))
+  {
+    return false;
+  }
+  Recipe->moveToProgram(Arena, Owner.getSymbolTable(), Symbols);
+  return insertRecipe(Recipe);
 }
 
-void CheffeProgramInfo::addRecipe(const std::string &RecipeTitle,
-                                  std::shared_ptr<CheffeRecipeInfo> Recipe)
+void CheffeProgramInfo::clearRecipes()
 {
-  RecipeInfo.insert(std::make_pair(RecipeTitle, Recipe));
+  RecipeInfo.clear();
+  Recipes.clear();
 }
 
-void CheffeProgramInfo::setEntryPointRecipeTitleIfNone(
-    const std::string &RecipeTitle)
+bool CheffeProgramInfo::insertRecipe(CheffeRecipeInfo *Recipe)
 {
-  if (EntryPointRecipeTitle.empty())
+  if (!RecipeInfo.insert(std::make_pair(StringRef(Recipe->getRecipeTitle()),
+                                        Recipes.size())).second)
   {
-    EntryPointRecipeTitle = RecipeTitle;
+    return false;
   }
+  Recipes.push_back(Recipe);
+  return true;
+}
+
+void CheffeProgramInfo::replaceRecipe(const unsigned RecipeIdx,
+                                      CheffeRecipeInfo *Recipe,
+                                      const CheffeProgramInfo &Owner)
+{
+  assert(!getRecipe(RecipeIdx)->isLoaded() && "Replacing a loaded recipe!");
+  assert(StringRef(getRecipe(RecipeIdx)->getRecipeTitle())
+             .equalsLower(Recipe->getRecipeTitle()) &&
+         "Replacing a recipe with a different one!");
+  Recipe->moveToProgram(Arena, Owner.getSymbolTable(), Symbols);
+
+  // The key has to refer to the title of the recipe that's now indexed.
+  RecipeInfo.erase(getRecipe(RecipeIdx)->getRecipeTitle());
+  RecipeInfo.insert(
+      std::make_pair(StringRef(Recipe->getRecipeTitle()), RecipeIdx));
+  Recipes[RecipeIdx] = Recipe;
+}
+
+void CheffeProgramInfo::setRecipeLoader(
+    std::unique_ptr<CheffeRecipeLoader> Loader)
+{
+  RecipeLoader = std::move(Loader);
+}
+
+CheffeErrorCode CheffeProgramInfo::loadRecipe(const unsigned RecipeIdx)
+{
+  if (getRecipe(RecipeIdx)->isLoaded())
+  {
+    return CheffeErrorCode::CHEFFE_SUCCESS;
+  }
+
+  if (!RecipeLoader)
+  {
+    return CheffeErrorCode::CHEFFE_ERROR;
+  }
+
+  return RecipeLoader->loadRecipe(*this, RecipeIdx);
+}
+
+CheffeArena &CheffeProgramInfo::getArena()
+{
+  return Arena;
 }
 
 } // end namespace cheffe
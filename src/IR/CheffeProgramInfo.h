@@ -1,33 +1,118 @@
 #ifndef CHEFFE_PROGRAM_INFO
 #define CHEFFE_PROGRAM_INFO
 
+#include "cheffe.h"
+#include "IR/CheffeArena.h"
 #include "IR/CheffeRecipeInfo.h"
+#include "IR/CheffeSymbolTable.h"
+#include "Utils/CheffeStringRef.h"
 
-#include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace cheffe
 {
 
+class CheffeProgramInfo;
+
+// Parses recipes that have only been indexed so far, on behalf of the program
+// they belong to.
+class CheffeRecipeLoader
+{
+public:
+  virtual ~CheffeRecipeLoader()
+  {
+  }
+
+  // Parses the recipe at RecipeIdx, which isn't loaded yet, and replaces it in
+  // the program with the result.
+  virtual CheffeErrorCode loadRecipe(CheffeProgramInfo &ProgramInfo,
+                                     const unsigned RecipeIdx) = 0;
+};
+
 class CheffeProgramInfo
 {
 private:
-  typedef std::map<std::string, std::shared_ptr<CheffeRecipeInfo>> RecipeMapTy;
+  // Recipe titles are case-insensitive, so they're hashed and compared
+  // without regard to case. That way a lookup never has to fold a copy of the
+  // title it's given.
+  struct TitleHash
+  {
+    std::size_t operator()(const StringRef Title) const;
+  };
+  struct TitleEqual
+  {
+    bool operator()(const StringRef LHS, const StringRef RHS) const
+    {
+      return LHS.equalsLower(RHS);
+    }
+  };
+
+  // Each key refers to the title held by the recipe it indexes, as written.
+  typedef std::unordered_map<StringRef, unsigned, TitleHash, TitleEqual>
+      RecipeMapTy;
 
 public:
-  std::shared_ptr<CheffeRecipeInfo>
-  getRecipe(const std::string &RecipeTitle) const;
+  CheffeRecipeInfo *getRecipe(const StringRef RecipeTitle) const;
+
+  // Recipes are numbered in the order they're defined in, so that resolved
+  // Serve steps can refer to them without a name lookup.
+  CheffeRecipeInfo *getRecipe(const unsigned RecipeIdx) const;
+  bool getRecipeIndex(const StringRef RecipeTitle, unsigned &RecipeIdx) const;
+  unsigned getNumRecipes() const;
+
+  // The first recipe in the program is the one that gets executed.
+  CheffeRecipeInfo *getEntryPointRecipe() const;
+
+  // The names of every ingredient in the program, across all recipes.
+  CheffeSymbolTable &getSymbolTable();
+  const CheffeSymbolTable &getSymbolTable() const;
+
+  // Creates a new, empty recipe. Returns nullptr if a recipe with the same
+  // title already exists.
+  CheffeRecipeInfo *addRecipe(const std::string &RecipeTitle);
+
+  // Takes a recipe parsed into another program, which must still own it. The
+  // recipe only belongs to this program once that program's arena has been
+  // adopted too. Returns false if a recipe with the same title already exists.
+  bool adoptRecipe(CheffeRecipeInfo *Recipe, const CheffeProgramInfo &Owner);
+
+  // As adoptRecipe, but the recipe takes the place of the unloaded recipe at
+  // RecipeIdx, which must have the same title.
+  void replaceRecipe(const unsigned RecipeIdx, CheffeRecipeInfo *Recipe,
+                     const CheffeProgramInfo &Owner);
+
+  // Forgets every recipe, so that the program can be put back together from
+  // recipes it already owns with insertRecipe. The recipes themselves aren't
+  // freed until the program is.
+  void clearRecipes();
+
+  // Adds a recipe that already belongs to this program, such as one it had
+  // before clearRecipes. Returns false if a recipe with the same title
+  // already exists.
+  bool insertRecipe(CheffeRecipeInfo *Recipe);
 
-  std::shared_ptr<CheffeRecipeInfo> getEntryPointRecipe();
+  // Recipes that haven't been loaded yet are loaded by Loader when they're
+  // first asked for through loadRecipe.
+  void setRecipeLoader(std::unique_ptr<CheffeRecipeLoader> Loader);
 
-  void addRecipe(const std::string &RecipeTitle,
-                 std::shared_ptr<CheffeRecipeInfo> Recipe);
+  // Makes sure the recipe at RecipeIdx has been loaded, loading it now if it
+  // hasn't. Any pointer to the recipe taken beforehand is stale afterwards.
+  CheffeErrorCode loadRecipe(const unsigned RecipeIdx);
 
-  void setEntryPointRecipeTitleIfNone(const std::string &RecipeTitle);
+  // Every recipe, along with everything they contain, is allocated from this
+  // arena, and is freed in one go when the program is destroyed.
+  CheffeArena &getArena();
 
 private:
+  // Declared first, so that it outlives everything pointing into it.
+  CheffeArena Arena;
   RecipeMapTy RecipeInfo;
-  std::string EntryPointRecipeTitle;
+  std::vector<CheffeRecipeInfo *> Recipes;
+  CheffeSymbolTable Symbols;
+  std::unique_ptr<CheffeRecipeLoader> RecipeLoader;
 };
 
 } // end namespace cheffe
@@ -14,54 +14,79 @@ unsigned CheffeRecipeInfo::getServesNo() const
   return ServesNo;
 }
 
-std::string CheffeRecipeInfo::getRecipeTitle() const
+const std::string &CheffeRecipeInfo::getRecipeTitle() const
 {
   return RecipeTitle;
 }
 
+SourceLocation CheffeRecipeInfo::getTitleLoc() const
+{
+  return TitleLoc;
+}
+
+void CheffeRecipeInfo::setTitleLoc(const SourceLocation Loc)
+{
+  TitleLoc = Loc;
+}
+
+bool CheffeRecipeInfo::isLoaded() const
+{
+  return IsLoaded;
+}
+
+SourceLocation CheffeRecipeInfo::getSourceRange() const
+{
+  return SourceRange;
+}
+
+void CheffeRecipeInfo::setUnloaded(const SourceLocation Range)
+{
+  IsLoaded = false;
+  SourceRange = Range;
+}
+
 void CheffeRecipeInfo::addIngredientDefinition(
-    const CheffeIngredient &Ingredient)
+    const CheffeSymbol IngredientName, const CheffeIngredient &Ingredient)
 {
   // It's alright to overwrite an existing ingredient; it's in the spec
-  auto IngredientInfo = std::make_unique<CheffeIngredient>(Ingredient);
-  Ingredients[IngredientInfo->Name] = std::move(IngredientInfo);
+  CheffeIngredient *&Existing = Ingredients[IngredientName];
+  if (Existing)
+  {
+    *Existing = Ingredient;
+    return;
+  }
+  Existing = Arena->create<CheffeIngredient>(Ingredient);
+  IngredientOrder.push_back(IngredientName);
 }
 
 CheffeIngredient *
-CheffeRecipeInfo::getIngredient(const std::string &IngredientName) const
+CheffeRecipeInfo::getIngredient(const CheffeSymbol IngredientName) const
 {
   auto Ingredient = Ingredients.find(IngredientName);
   if (Ingredient == std::end(Ingredients))
   {
     return nullptr;
   }
-  return Ingredient->second.get();
+  return Ingredient->second;
 }
 
-std::vector<CheffeIngredient *> CheffeRecipeInfo::getDryIngredients() const
+const CheffeRecipeInfo::IngredientMapTy &
+CheffeRecipeInfo::getIngredients() const
 {
-  std::vector<CheffeIngredient *> DryIngredients;
-  for (auto &Ingredient : Ingredients)
-  {
-    if (Ingredient.second->RuntimeValueData.IsDry)
-    {
-      DryIngredients.push_back(Ingredient.second.get());
-    }
-  }
-
-  return DryIngredients;
+  return Ingredients;
 }
 
 CheffeMethodStep *CheffeRecipeInfo::addNewMethodStep(const MethodStepKind Kind)
 {
-  auto MethodStep = std::make_unique<CheffeMethodStep>(Kind);
-  MethodSteps.push_back(std::move(MethodStep));
-  return MethodSteps.back().get();
+  auto *MethodStep =
+      Arena->create<CheffeMethodStep>(Kind, MethodSteps.size());
+  MethodSteps.push_back(MethodStep);
+  return MethodStep;
 }
 
 CheffeMethodStep *CheffeRecipeInfo::getLastMethodStep() const
 {
-  return MethodSteps.empty() ? nullptr : MethodSteps.back().get();
+  return MethodSteps.empty() ? nullptr : MethodSteps.back();
 }
 
 void CheffeRecipeInfo::resetIngredientsToInitialValues()
@@ -72,14 +97,28 @@ void CheffeRecipeInfo::resetIngredientsToInitialValues()
   }
 }
 
-std::vector<CheffeMethodStep *> CheffeRecipeInfo::getMethodStepList()
+void CheffeRecipeInfo::moveToProgram(CheffeArena &NewArena,
+                                     const CheffeSymbolTable &OldSymbols,
+                                     CheffeSymbolTable &NewSymbols)
 {
-  std::vector<CheffeMethodStep *> MethodStepList;
-  for (auto &MS : MethodSteps)
+  Arena = &NewArena;
+
+  // Interning the names and rebuilding the map in definition order gives the
+  // same symbols, and the same map, as defining them in the new program would.
+  IngredientMapTy NewIngredients;
+  for (CheffeSymbol &Symbol : IngredientOrder)
   {
-    MethodStepList.push_back(MS.get());
+    CheffeIngredient *Ingredient = Ingredients[Symbol];
+    Symbol = NewSymbols.intern(OldSymbols.getName(Symbol));
+    NewIngredients[Symbol] = Ingredient;
   }
-  return MethodStepList;
+  Ingredients.swap(NewIngredients);
+}
+
+const CheffeRecipeInfo::MethodStepListTy &
+CheffeRecipeInfo::getMethodSteps() const
+{
+  return MethodSteps;
 }
 
 } // end namespace cheffe
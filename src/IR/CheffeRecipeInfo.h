@@ -1,9 +1,11 @@
 #ifndef CHEFFE_RECIPE_INFO
 #define CHEFFE_RECIPE_INFO
 
+#include "IR/CheffeArena.h"
 #include "IR/CheffeMethodStep.h"
+#include "IR/CheffeSymbolTable.h"
 
-#include <map>
+#include <unordered_map>
 #include <vector>
 #include <string>
 
@@ -15,37 +17,69 @@ class CheffeIngredient;
 class CheffeRecipeInfo
 {
 public:
+  typedef std::unordered_map<CheffeSymbol, CheffeIngredient *> IngredientMapTy;
+  typedef std::vector<CheffeMethodStep *> MethodStepListTy;
+
   CheffeRecipeInfo() = delete;
 
-  CheffeRecipeInfo(const std::string &Title) : ServesNo(0), RecipeTitle(Title)
+  // Ingredients and method steps are allocated from the program's arena.
+  CheffeRecipeInfo(const std::string &Title, CheffeArena &Arena)
+      : ServesNo(0), IsLoaded(true), RecipeTitle(Title), Arena(&Arena)
   {
   }
 
+  CheffeRecipeInfo(const CheffeRecipeInfo &) = delete;
+  CheffeRecipeInfo &operator=(const CheffeRecipeInfo &) = delete;
+
   void setServesNo(const unsigned Serves);
 
   unsigned getServesNo() const;
 
-  std::string getRecipeTitle() const;
+  const std::string &getRecipeTitle() const;
+
+  SourceLocation getTitleLoc() const;
+  void setTitleLoc(const SourceLocation Loc);
 
-  void addIngredientDefinition(const CheffeIngredient &Ingredient);
+  // A recipe that's been parsed lazily only has its title to begin with. The
+  // rest of it, somewhere in SourceRange, is parsed the first time it's
+  // needed, at which point it's replaced by a fully-loaded recipe.
+  bool isLoaded() const;
+  SourceLocation getSourceRange() const;
+  void setUnloaded(const SourceLocation Range);
 
-  CheffeIngredient *getIngredient(const std::string &IngredientName) const;
+  void addIngredientDefinition(const CheffeSymbol IngredientName,
+                               const CheffeIngredient &Ingredient);
 
-  std::vector<CheffeIngredient *> getDryIngredients() const;
+  CheffeIngredient *getIngredient(const CheffeSymbol IngredientName) const;
+
+  const IngredientMapTy &getIngredients() const;
 
   CheffeMethodStep *addNewMethodStep(const MethodStepKind Kind);
 
   CheffeMethodStep *getLastMethodStep() const;
 
-  std::vector<CheffeMethodStep *> getMethodStepList();
+  const MethodStepListTy &getMethodSteps() const;
 
   void resetIngredientsToInitialValues();
 
+  // Moves this recipe into another program: anything allocated for it from
+  // now on comes from NewArena, and its ingredients are re-keyed by the
+  // symbols NewSymbols has for their names.
+  void moveToProgram(CheffeArena &NewArena, const CheffeSymbolTable &OldSymbols,
+                     CheffeSymbolTable &NewSymbols);
+
 private:
   unsigned ServesNo;
+  bool IsLoaded;
+  SourceLocation TitleLoc;
+  SourceLocation SourceRange;
   std::string RecipeTitle;
-  std::map<std::string, std::unique_ptr<CheffeIngredient>> Ingredients;
-  std::vector<std::unique_ptr<CheffeMethodStep>> MethodSteps;
+  CheffeArena *Arena;
+  IngredientMapTy Ingredients;
+  // Ingredients in the order they were first defined in, which is the order
+  // they were added to the map in.
+  std::vector<CheffeSymbol> IngredientOrder;
+  MethodStepListTy MethodSteps;
 };
 
 } // end namespace cheffe
@@ -0,0 +1,41 @@
+#include "IR/CheffeSymbolTable.h"
+
+#include <cassert>
+
+namespace cheffe
+{
+
+CheffeSymbol CheffeSymbolTable::intern(const std::string &Name)
+{
+  auto Result = Symbols.insert(std::make_pair(Name, Names.size()));
+  if (Result.second)
+  {
+    Names.push_back(&Result.first->first);
+  }
+  return Result.first->second;
+}
+
+bool CheffeSymbolTable::lookup(const std::string &Name,
+                               CheffeSymbol &Symbol) const
+{
+  auto SymbolIter = Symbols.find(Name);
+  if (SymbolIter == std::end(Symbols))
+  {
+    return false;
+  }
+  Symbol = SymbolIter->second;
+  return true;
+}
+
+const std::string &CheffeSymbolTable::getName(const CheffeSymbol Symbol) const
+{
+  assert(Symbol < Names.size() && "Invalid symbol!");
+  return *Names[Symbol];
+}
+
+unsigned CheffeSymbolTable::size() const
+{
+  return Names.size();
+}
+
+} // end namespace cheffe
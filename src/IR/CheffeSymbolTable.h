@@ -0,0 +1,41 @@
+#ifndef CHEFFE_SYMBOL_TABLE
+#define CHEFFE_SYMBOL_TABLE
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cheffe
+{
+
+typedef unsigned CheffeSymbol;
+
+// Maps the names used in a program to small integers, so that the same name
+// is only ever stored once and can be compared or hashed as a number.
+class CheffeSymbolTable
+{
+public:
+  CheffeSymbolTable()
+  {
+  }
+
+  // Returns the symbol for the given name, creating one if need be.
+  CheffeSymbol intern(const std::string &Name);
+
+  // Returns false if the name has never been interned, in which case nothing
+  // in the program can be referring to it.
+  bool lookup(const std::string &Name, CheffeSymbol &Symbol) const;
+
+  const std::string &getName(const CheffeSymbol Symbol) const;
+
+  unsigned size() const;
+
+private:
+  std::unordered_map<std::string, CheffeSymbol> Symbols;
+  // Points at the keys in the map above, which never move once inserted.
+  std::vector<const std::string *> Names;
+};
+
+} // end namespace cheffe
+
+#endif // CHEFFE_SYMBOL_TABLE
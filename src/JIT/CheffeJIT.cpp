@@ -5,33 +5,59 @@
 #include "Utils/CheffeDebugUtils.h"
 
 #include <memory>
+#include <cassert>
 #include <algorithm>
 #include <iostream>
+#include <ctime>
+#include <limits>
 
 #define DEBUG_TYPE "jit"
 
 namespace cheffe
 {
-CheffeErrorCode CheffeJIT::getIngredientInfo(const MethodOp *MOp,
+CheffeErrorCode CheffeJIT::getIngredientInfo(const MethodOp &MOp,
                                              CheffeIngredient **IngredientInfo,
                                              SourceLocation &IngredientLoc)
 {
-  auto *Ingredient = (IngredientOp *)MOp;
-  if (!Ingredient->getIngredient())
+  if (!MOp.getIngredient())
   {
-    Diagnostics->report(Ingredient->getSourceLoc(), DiagnosticKind::Error,
-                        LineContext::WithContext)
-        << "Trying to use an undefined ingredient";
+    Diagnostics->report(MOp.getSourceLoc(), diag::err_undefined_ingredient_use);
     return CheffeErrorCode::CHEFFE_ERROR;
   }
 
-  IngredientLoc = Ingredient->getSourceLoc();
-  *IngredientInfo = Ingredient->getIngredient();
+  IngredientLoc = MOp.getSourceLoc();
+  *IngredientInfo = MOp.getIngredient();
 
   return CheffeErrorCode::CHEFFE_SUCCESS;
 }
 
-void CheffeJIT::pushStackItem(std::vector<CheffeJIT::StackTy> &Stack,
+CheffeJIT::CheffeFrame &CheffeJIT::acquireFrame()
+{
+  if (CallDepth == FramePool.size())
+  {
+    FramePool.emplace_back();
+  }
+  return FramePool[CallDepth++];
+}
+
+void CheffeJIT::releaseFrame()
+{
+  assert(CallDepth > 0 && "Releasing a frame that was never acquired");
+  --CallDepth;
+}
+
+void CheffeJIT::copyStacks(CheffeJIT::StackListTy &Dest,
+                           const CheffeJIT::StackListTy &Source)
+{
+  Dest.resize(Source.size());
+  for (std::size_t i = 0, e = Source.size(); i != e; ++i)
+  {
+    Dest[i].assign(std::begin(Source[i]), std::end(Source[i]));
+    countWork(&CheffeWorkCounts::ElementsCopied, Source[i].size());
+  }
+}
+
+void CheffeJIT::pushStackItem(CheffeJIT::StackListTy &Stack,
                               const CheffeJIT::StackItemTy StackItem,
                               const unsigned StackIdx)
 {
@@ -41,10 +67,11 @@ void CheffeJIT::pushStackItem(std::vector<CheffeJIT::StackTy> &Stack,
   }
 
   Stack[StackIdx].push_back(StackItem);
+  countWork(&CheffeWorkCounts::ElementsMoved, 1);
 }
 
 CheffeJIT::StackItemTy
-CheffeJIT::popStackItem(std::vector<CheffeJIT::StackTy> &Stack,
+CheffeJIT::popStackItem(CheffeJIT::StackListTy &Stack,
                         const unsigned StackItemIdx)
 {
   if (StackItemIdx >= Stack.size())
@@ -58,6 +85,7 @@ CheffeJIT::popStackItem(std::vector<CheffeJIT::StackTy> &Stack,
   }
   auto StackItem = Stack[StackItemIdx].back();
   Stack[StackItemIdx].pop_back();
+  countWork(&CheffeWorkCounts::ElementsMoved, 1);
   return StackItem;
 }
 
@@ -69,9 +97,8 @@ bool CheffeJIT::checkIngredientHasValue(const CheffeIngredient *Ingredient,
     return true;
   }
 
-  Diagnostics->report(IngredientLoc, DiagnosticKind::Error,
-                      LineContext::WithContext)
-      << "Using ingredient '" << Ingredient->Name << "' without a value";
+  Diagnostics->report(IngredientLoc, diag::err_ingredient_without_value)
+      << Ingredient->Name;
   return false;
 }
 
@@ -83,19 +110,53 @@ CheffeErrorCode CheffeJIT::executeProgram()
     return CheffeErrorCode::CHEFFE_ERROR;
   }
 
-  std::shared_ptr<CheffeRecipeInfo> MainRecipeInfo =
-      ProgramInfo->getEntryPointRecipe();
-
-  if (!MainRecipeInfo)
+  if (!ProgramInfo->getNumRecipes() ||
+      ProgramInfo->loadRecipe(0) != CheffeErrorCode::CHEFFE_SUCCESS)
   {
     return CheffeErrorCode::CHEFFE_ERROR;
   }
 
-  std::vector<StackTy> MixingBowls;
-  std::vector<StackTy> BakingDishes;
+  CheffeRecipeInfo *MainRecipeInfo = ProgramInfo->getEntryPointRecipe();
+
+  // The entry point's "caller" bowls come from the pool too, so running the
+  // same program again doesn't need to allocate them afresh.
+  CheffeFrame &TopLevelFrame = acquireFrame();
+  TopLevelFrame.MixingBowls.resize(0);
+  TopLevelFrame.BakingDishes.resize(0);
+  const CheffeErrorCode Success =
+      Timings ? executeRecipeTimed(MainRecipeInfo, TopLevelFrame.MixingBowls,
+                                   TopLevelFrame.BakingDishes)
+              : executeRecipe(MainRecipeInfo, TopLevelFrame.MixingBowls,
+                              TopLevelFrame.BakingDishes);
+  releaseFrame();
+
+  return Success;
+}
+
+CheffeErrorCode
+CheffeJIT::executeRecipeTimed(CheffeRecipeInfo *RecipeInfo,
+                              StackListTy &CallerMixingBowls,
+                              StackListTy &CallerBakingDishes)
+{
+  CheffeTimes *OuterServedTimes = ServedTimes;
+  CheffeTimes RecipeServedTimes;
+  ServedTimes = &RecipeServedTimes;
+
+  const CheffeTimes Start = CheffeTimes::now();
   const CheffeErrorCode Success =
-      executeRecipe(MainRecipeInfo, MixingBowls, BakingDishes);
+      executeRecipe(RecipeInfo, CallerMixingBowls, CallerBakingDishes);
+  const CheffeTimes Elapsed = CheffeTimes::now() - Start;
 
+  ServedTimes = OuterServedTimes;
+  if (OuterServedTimes)
+  {
+    *OuterServedTimes += Elapsed;
+  }
+  if (RecipeInfo)
+  {
+    Timings->addTimes(CheffePhase::Execute, RecipeInfo->getRecipeTitle(),
+                      Elapsed - RecipeServedTimes);
+  }
   return Success;
 }
 
@@ -105,17 +166,18 @@ long long randomGenerator(long long i)
 }
 
 CheffeErrorCode
-CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
-                         std::vector<StackTy> &CallerMixingBowls,
-                         std::vector<StackTy> &CallerBakingDishes)
+CheffeJIT::executeRecipe(CheffeRecipeInfo *RecipeInfo,
+                         StackListTy &CallerMixingBowls,
+                         StackListTy &CallerBakingDishes)
 {
-  RecipeInfo->resetIngredientsToInitialValues();
-
   if (!RecipeInfo)
   {
     return CheffeErrorCode::CHEFFE_ERROR;
   }
 
+  RecipeInfo->resetIngredientsToInitialValues();
+  countWork(&CheffeWorkCounts::FramesCreated, 1);
+
   // clang-format off
   CHEFFE_DEBUG(
     dbgs() << std::endl << "Executing '" << RecipeInfo->getRecipeTitle()
@@ -123,11 +185,29 @@ CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
   );
   // clang-format on
 
+  // Each activation borrows a frame from the pool for the duration of the
+  // recipe, and hands it back on every path out of here.
+  struct FrameHelper
+  {
+    FrameHelper(CheffeJIT *JIT) : JIT(JIT), Frame(JIT->acquireFrame())
+    {
+    }
+    ~FrameHelper()
+    {
+      JIT->releaseFrame();
+    }
+
+    CheffeJIT *JIT;
+    CheffeFrame &Frame;
+  } Helper(this);
+
   // Recipes take a copy of all of the caller's mixing bowls and baking dishes.
-  std::vector<StackTy> MixingBowls(CallerMixingBowls);
-  std::vector<StackTy> BakingDishes(CallerBakingDishes);
+  StackListTy &MixingBowls = Helper.Frame.MixingBowls;
+  StackListTy &BakingDishes = Helper.Frame.BakingDishes;
+  copyStacks(MixingBowls, CallerMixingBowls);
+  copyStacks(BakingDishes, CallerBakingDishes);
 
-  auto MethodSteps = RecipeInfo->getMethodStepList();
+  const auto &MethodSteps = RecipeInfo->getMethodSteps();
 
   // clang-format off
   CHEFFE_DEBUG(
@@ -145,6 +225,11 @@ CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
   {
     auto *MS = *MSI;
     CHEFFE_DEBUG(dbgs() << MS);
+    if (WorkCounts)
+    {
+      ++WorkCounts->StepsDispatched[static_cast<unsigned>(
+          MS->getMethodStepKind())];
+    }
 
     switch (MS->getMethodStepKind())
     {
@@ -195,8 +280,7 @@ CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
       const bool IsDry = Ingredient->RuntimeValueData.IsDry;
       const long long Value = Ingredient->RuntimeValueData.Value;
 
-      auto *MixingBowl = (MixingBowlOp *)MS->getOperand(1);
-      const unsigned MixingBowlNo = MixingBowl->getMixingBowlNo();
+      const unsigned MixingBowlNo = MS->getOperand(1).getMixingBowlNo();
 
       pushStackItem(MixingBowls, std::make_pair(IsDry, Value),
                     MixingBowlNo - 1);
@@ -214,8 +298,7 @@ CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
         return CheffeErrorCode::CHEFFE_ERROR;
       }
 
-      auto *MixingBowl = (MixingBowlOp *)MS->getOperand(1);
-      const unsigned MixingBowlNo = MixingBowl->getMixingBowlNo();
+      const unsigned MixingBowlNo = MS->getOperand(1).getMixingBowlNo();
 
       auto TopOfStack = popStackItem(MixingBowls, MixingBowlNo - 1);
 
@@ -225,16 +308,20 @@ CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
     }
     case MethodStepKind::AddDry:
     {
-      auto *MixingBowl = (MixingBowlOp *)MS->getOperand(0);
-      const unsigned MixingBowlNo = MixingBowl->getMixingBowlNo();
+      const unsigned MixingBowlNo = MS->getOperand(0).getMixingBowlNo();
       if (MixingBowlNo > MixingBowls.size())
       {
         MixingBowls.resize(MixingBowlNo);
       }
 
       long long DrySum = 0;
-      for (auto &Item : RecipeInfo->getDryIngredients())
+      for (auto &Ingredient : RecipeInfo->getIngredients())
       {
+        const CheffeIngredient *Item = Ingredient.second;
+        if (!Item->RuntimeValueData.IsDry)
+        {
+          continue;
+        }
         if (!checkIngredientHasValue(Item, Item->DefLoc))
         {
           return CheffeErrorCode::CHEFFE_ERROR;
@@ -266,8 +353,7 @@ CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
         return CheffeErrorCode::CHEFFE_ERROR;
       }
 
-      auto *MixingBowl = (MixingBowlOp *)MS->getOperand(1);
-      const unsigned MixingBowlNo = MixingBowl->getMixingBowlNo();
+      const unsigned MixingBowlNo = MS->getOperand(1).getMixingBowlNo();
 
       const long long Value = Ingredient->RuntimeValueData.Value;
       auto NewValue = popStackItem(MixingBowls, MixingBowlNo - 1);
@@ -297,11 +383,8 @@ CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
     case MethodStepKind::Pour:
     {
       // FIXME: No safety here if the indices are wrong!
-      auto *MixingBowl = (MixingBowlOp *)MS->getOperand(0);
-      auto *BakingDish = (BakingDishOp *)MS->getOperand(1);
-
-      const unsigned MixingBowlNo = MixingBowl->getMixingBowlNo();
-      const unsigned BakingDishNo = BakingDish->getBakingDishNo();
+      const unsigned MixingBowlNo = MS->getOperand(0).getMixingBowlNo();
+      const unsigned BakingDishNo = MS->getOperand(1).getBakingDishNo();
 
       // No point in trying to copy if the mixing bowl is empty
       if (MixingBowlNo > MixingBowls.size())
@@ -314,10 +397,11 @@ CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
         BakingDishes.resize(BakingDishNo);
       }
 
-      for (auto &StackItem : MixingBowls[MixingBowlNo - 1])
-      {
-        pushStackItem(BakingDishes, StackItem, BakingDishNo - 1);
-      }
+      const StackTy &MixingBowl = MixingBowls[MixingBowlNo - 1];
+      StackTy &BakingDish = BakingDishes[BakingDishNo - 1];
+      BakingDish.insert(BakingDish.end(), MixingBowl.begin(),
+                        MixingBowl.end());
+      countWork(&CheffeWorkCounts::ElementsCopied, MixingBowl.size());
       break;
     }
     case MethodStepKind::LiquefyIngredient:
@@ -338,8 +422,7 @@ CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
     }
     case MethodStepKind::LiquefyBowl:
     {
-      auto *MixingBowl = (MixingBowlOp *)MS->getOperand(0);
-      const unsigned MixingBowlNo = MixingBowl->getMixingBowlNo();
+      const unsigned MixingBowlNo = MS->getOperand(0).getMixingBowlNo();
       // If we haven't put anything into this mixing bowl, don't bother trying
       // to loop
       if (MixingBowlNo > MixingBowls.size())
@@ -357,13 +440,13 @@ CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
     case MethodStepKind::StirIngredient:
     {
       const bool IsBowl = MS->getMethodStepKind() == MethodStepKind::StirBowl;
-      auto *MixingBowl = (MixingBowlOp *)MS->getOperand(IsBowl ? 0 : 1);
-      const unsigned MixingBowlNo = MixingBowl->getMixingBowlNo();
+      const unsigned MixingBowlNo =
+          MS->getOperand(IsBowl ? 0 : 1).getMixingBowlNo();
 
       long long Number = 0;
       if (IsBowl)
       {
-        Number = ((NumberOp *)MS->getOperand(1))->getNumberValue();
+        Number = MS->getOperand(1).getNumberValue();
       }
       else
       {
@@ -391,9 +474,7 @@ CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
 
       if (Number < 0)
       {
-        Diagnostics->report(MS->getSourceLoc(), DiagnosticKind::Error,
-                            LineContext::WithContext)
-            << "Trying to stir the mixing bowl by a negative amount";
+        Diagnostics->report(MS->getSourceLoc(), diag::err_negative_stir);
         return CheffeErrorCode::CHEFFE_ERROR;
       }
 
@@ -404,12 +485,14 @@ CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
 
       MixingBowls[MixingBowlNo - 1].insert(
           MixingBowls[MixingBowlNo - 1].begin() + InsertPos, TopOfStack);
+      countWork(&CheffeWorkCounts::ElementsMoved, 1);
+      countWork(&CheffeWorkCounts::ElementsShifted,
+                SizeOfMixingBowl - InsertPos);
       break;
     }
     case MethodStepKind::Clean:
     {
-      const auto *MixingBowl = (MixingBowlOp *)MS->getOperand(0);
-      const unsigned MixingBowlNo = MixingBowl->getMixingBowlNo();
+      const unsigned MixingBowlNo = MS->getOperand(0).getMixingBowlNo();
 
       // If there's already nothing in the mixing bowl, don't bother cleaning
       // anything
@@ -423,8 +506,7 @@ CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
     }
     case MethodStepKind::Mix:
     {
-      const auto *MixingBowl = (MixingBowlOp *)MS->getOperand(0);
-      const unsigned MixingBowlNo = MixingBowl->getMixingBowlNo();
+      const unsigned MixingBowlNo = MS->getOperand(0).getMixingBowlNo();
 
       // If there's already nothing in the mixing bowl, don't bother cleaning
       // anything
@@ -434,6 +516,8 @@ CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
       }
       std::random_shuffle(MixingBowls[MixingBowlNo - 1].begin(),
                           MixingBowls[MixingBowlNo - 1].end(), randomGenerator);
+      countWork(&CheffeWorkCounts::ElementsShifted,
+                MixingBowls[MixingBowlNo - 1].size());
       break;
     }
     case MethodStepKind::Verb:
@@ -448,8 +532,7 @@ CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
         return CheffeErrorCode::CHEFFE_ERROR;
       }
 
-      const long long Distance =
-          ((NumberOp *)MS->getOperand(1))->getNumberValue();
+      const long long Distance = MS->getOperand(1).getNumberValue();
       assert(Distance > 0 && "Invalid distance");
 
       if (Ingredient->RuntimeValueData.Value == 0)
@@ -461,8 +544,7 @@ CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
     case MethodStepKind::UntilVerbed:
     {
       SourceLocation UntilIngredientLoc;
-      CheffeIngredient *UntilIngredient =
-          ((IngredientOp *)(MS->getOperand(0)))->getIngredient();
+      CheffeIngredient *UntilIngredient = MS->getOperand(0).getIngredient();
 
       if (UntilIngredient)
       {
@@ -490,8 +572,7 @@ CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
         return CheffeErrorCode::CHEFFE_ERROR;
       }
 
-      const long long Distance =
-          ((NumberOp *)(MS->getOperand(2)))->getNumberValue();
+      const long long Distance = MS->getOperand(2).getNumberValue();
       assert(Distance < 0 && "Invalid distance");
 
       if (FromIngredient->RuntimeValueData.Value != 0)
@@ -502,8 +583,7 @@ CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
     }
     case MethodStepKind::SetAside:
     {
-      const long long Distance =
-          ((NumberOp *)MS->getOperand(0))->getNumberValue();
+      const long long Distance = MS->getOperand(0).getNumberValue();
       assert(Distance > 0 && "Invalid distance");
 
       MSI += Distance;
@@ -511,22 +591,31 @@ CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
     }
     case MethodStepKind::Serve:
     {
-      auto *Recipe = (RecipeOp *)MS->getOperand(0);
-      const std::string CalleeRecipeName = Recipe->getRecipeName();
-
-      std::shared_ptr<CheffeRecipeInfo> CalleeRecipeInfo =
-          ProgramInfo->getRecipe(CalleeRecipeName);
-
-      if (!CalleeRecipeInfo)
+      const MethodOp &Recipe = MS->getOperand(0);
+      assert(Recipe.isResolved() && "Serving a recipe that wasn't linked");
+
+      // Recipes parsed lazily are only parsed once they're first served.
+      // That's timed as parsing, so it isn't charged to this recipe too.
+      const CheffeTimes LoadStart =
+          Timings ? CheffeTimes::now() : CheffeTimes();
+      const CheffeErrorCode LoadSuccess =
+          ProgramInfo->loadRecipe(Recipe.getRecipeIndex());
+      if (Timings && ServedTimes)
+      {
+        *ServedTimes += CheffeTimes::now() - LoadStart;
+      }
+      if (LoadSuccess != CheffeErrorCode::CHEFFE_SUCCESS)
       {
-        Diagnostics->report(Recipe->getSourceLoc(), DiagnosticKind::Error,
-                            LineContext::WithContext)
-            << "Cannot find recipe '" << CalleeRecipeName << "' to execute";
         return CheffeErrorCode::CHEFFE_ERROR;
       }
 
+      CheffeRecipeInfo *CalleeRecipeInfo =
+          ProgramInfo->getRecipe(Recipe.getRecipeIndex());
+
       const CheffeErrorCode CalleeSuccess =
-          executeRecipe(CalleeRecipeInfo, MixingBowls, BakingDishes);
+          Timings ? executeRecipeTimed(CalleeRecipeInfo, MixingBowls,
+                                       BakingDishes)
+                  : executeRecipe(CalleeRecipeInfo, MixingBowls, BakingDishes);
 
       if (CalleeSuccess != CheffeErrorCode::CHEFFE_SUCCESS)
       {
@@ -537,8 +626,7 @@ CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
     }
     case MethodStepKind::Refrigerate:
     {
-      const long long NumberOfHours =
-          ((NumberOp *)(MS->getOperand(0)))->getNumberValue();
+      const long long NumberOfHours = MS->getOperand(0).getNumberValue();
       return returnFromRecipe(MixingBowls, BakingDishes, CallerMixingBowls,
                               NumberOfHours, RecipeInfo->getRecipeTitle());
     }
@@ -550,10 +638,24 @@ CheffeJIT::executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
                           RecipeInfo->getRecipeTitle());
 }
 
+// The number of characters it takes to print Number in decimal.
+static unsigned getPrintedLength(const long long Number)
+{
+  unsigned Length = Number < 0 ? 2 : 1;
+  // Negating the most negative number would overflow, so the digits are
+  // counted off a negative value instead.
+  for (long long Rest = Number < 0 ? Number : -Number; Rest <= -10;
+       Rest /= 10)
+  {
+    ++Length;
+  }
+  return Length;
+}
+
 CheffeErrorCode
-CheffeJIT::returnFromRecipe(std::vector<CheffeJIT::StackTy> &MixingBowls,
-                            std::vector<CheffeJIT::StackTy> &BakingDishes,
-                            std::vector<CheffeJIT::StackTy> &CallerMixingBowls,
+CheffeJIT::returnFromRecipe(CheffeJIT::StackListTy &MixingBowls,
+                            CheffeJIT::StackListTy &BakingDishes,
+                            CheffeJIT::StackListTy &CallerMixingBowls,
                             const unsigned BakingDishesOutputNo,
                             const std::string &DebugRecipeTitle)
 {
@@ -569,6 +671,7 @@ CheffeJIT::returnFromRecipe(std::vector<CheffeJIT::StackTy> &MixingBowls,
     {
       CallerMixingBowls[0].push_back(Item);
     }
+    countWork(&CheffeWorkCounts::ElementsCopied, MixingBowls[0].size());
   }
 
   bool HaveOutputAnything = false;
@@ -582,12 +685,16 @@ CheffeJIT::returnFromRecipe(std::vector<CheffeJIT::StackTy> &MixingBowls,
         if (HaveOutputAnything)
         {
           std::cout << " ";
+          countWork(&CheffeWorkCounts::BytesOutput, 1);
         }
         std::cout << Item.second;
+        countWork(&CheffeWorkCounts::BytesOutput,
+                  getPrintedLength(Item.second));
       }
       else
       {
         std::cout << (char)Item.second;
+        countWork(&CheffeWorkCounts::BytesOutput, 1);
       }
       HaveOutputAnything = true;
     }
@@ -5,9 +5,12 @@
 #include "IR/CheffeIngredient.h"
 #include "IR/CheffeMethodStep.h"
 #include "IR/CheffeProgramInfo.h"
+#include "JIT/CheffeWorkCounts.h"
 #include "Utils/CheffeDiagnosticHandler.h"
+#include "Utils/CheffePhaseTimings.h"
 
 #include <deque>
+#include <vector>
 
 namespace cheffe
 {
@@ -16,38 +19,144 @@ class CheffeJIT
 {
 private:
   typedef std::pair<bool, long long> StackItemTy;
-  typedef std::deque<StackItemTy> StackTy;
+  typedef std::vector<StackItemTy> StackTy;
+
+  // A list of mixing bowls or baking dishes. Shrinking it only empties the
+  // bowls being dropped, so that growing it again hands each bowl number back
+  // the same storage it had before.
+  class StackListTy
+  {
+  public:
+    StackListTy() : Size(0)
+    {
+    }
+
+    std::size_t size() const
+    {
+      return Size;
+    }
+
+    bool empty() const
+    {
+      return Size == 0;
+    }
+
+    StackTy &operator[](const std::size_t Idx)
+    {
+      return Stacks[Idx];
+    }
+
+    const StackTy &operator[](const std::size_t Idx) const
+    {
+      return Stacks[Idx];
+    }
+
+    void resize(const std::size_t NewSize)
+    {
+      while (Size > NewSize)
+      {
+        Stacks[--Size].clear();
+      }
+      if (NewSize > Stacks.size())
+      {
+        Stacks.resize(NewSize);
+      }
+      Size = NewSize;
+    }
+
+  private:
+    std::vector<StackTy> Stacks;
+    std::size_t Size;
+  };
+
+  // The storage used by a single recipe activation. Frames are pooled by call
+  // depth so that a recipe served in a loop reuses the capacity of the bowls
+  // and dishes left behind by its previous activation.
+  struct CheffeFrame
+  {
+    StackListTy MixingBowls;
+    StackListTy BakingDishes;
+  };
 
 public:
   CheffeJIT(std::unique_ptr<CheffeProgramInfo> ProgramInfo,
             std::shared_ptr<CheffeDiagnosticHandler> Diags)
-      : ProgramInfo(std::move(ProgramInfo)), Diagnostics(Diags)
+      : ProgramInfo(std::move(ProgramInfo)), Diagnostics(Diags), CallDepth(0),
+        WorkCounts(nullptr), Timings(nullptr), ServedTimes(nullptr)
   {
   }
 
   CheffeErrorCode executeProgram();
-  CheffeErrorCode executeRecipe(std::shared_ptr<CheffeRecipeInfo> RecipeInfo,
-                                std::vector<StackTy> &CallerMixingBowls,
-                                std::vector<StackTy> &CallerBakingDishes);
+  CheffeErrorCode executeRecipe(CheffeRecipeInfo *RecipeInfo,
+                                StackListTy &CallerMixingBowls,
+                                StackListTy &CallerBakingDishes);
+
+  // Counts the work done by every run from now on into Counts, which must
+  // outlive the runs, or stops counting if it's null.
+  void setWorkCounts(CheffeWorkCounts *Counts)
+  {
+    WorkCounts = Counts;
+  }
+
+  // Records the time each recipe spends running into Timings, which must
+  // outlive the runs, or stops if it's null.
+  void setPhaseTimings(CheffePhaseTimings *PhaseTimings)
+  {
+    Timings = PhaseTimings;
+  }
 
 private:
   std::unique_ptr<CheffeProgramInfo> ProgramInfo;
   std::shared_ptr<CheffeDiagnosticHandler> Diagnostics;
 
-  void pushStackItem(std::vector<StackTy> &Stack, const StackItemTy StackItem,
+  // A std::deque so that growing the pool never invalidates the frames of
+  // the callers further up the stack.
+  std::deque<CheffeFrame> FramePool;
+  unsigned CallDepth;
+
+  CheffeWorkCounts *WorkCounts;
+
+  CheffePhaseTimings *Timings;
+  // Where the running recipe adds up the time spent in the recipes it serves,
+  // so that it isn't charged for it as well.
+  CheffeTimes *ServedTimes;
+
+  void countWork(unsigned long long CheffeWorkCounts::*Counter,
+                 const unsigned long long Amount)
+  {
+    if (WorkCounts)
+    {
+      WorkCounts->*Counter += Amount;
+    }
+  }
+
+  CheffeFrame &acquireFrame();
+  void releaseFrame();
+
+  // Runs a recipe as executeRecipe does, charging it for the time it spends
+  // running, less the time spent in the recipes it serves. Kept apart so that
+  // running without timings costs nothing more than a check of Timings.
+  CheffeErrorCode executeRecipeTimed(CheffeRecipeInfo *RecipeInfo,
+                                     StackListTy &CallerMixingBowls,
+                                     StackListTy &CallerBakingDishes);
+
+  void copyStacks(StackListTy &Dest,
+                  const StackListTy &Source);
+
+  void pushStackItem(StackListTy &Stack, const StackItemTy StackItem,
                      const unsigned StackIdx);
-  StackItemTy popStackItem(std::vector<StackTy> &Stack,
+  StackItemTy popStackItem(StackListTy &Stack,
                            const unsigned StackItemIdx);
 
   bool checkIngredientHasValue(const CheffeIngredient *Ingredient,
                                const SourceLocation IngredientLoc);
-  CheffeErrorCode getIngredientInfo(const MethodOp *MOp,
+  CheffeErrorCode getIngredientInfo(const MethodOp &MOp,
                                     CheffeIngredient **IngredientInfo,
                                     SourceLocation &IngredientLoc);
 
-  CheffeErrorCode returnFromRecipe(std::vector<StackTy> &MixingBowls,
-                                   std::vector<StackTy> &BakingDishes,
-                                   std::vector<StackTy> &CallerMixingBowls,
+  CheffeErrorCode returnFromRecipe(StackListTy &MixingBowls,
+                                   StackListTy &BakingDishes,
+                                   StackListTy &CallerMixingBowls,
                                    const unsigned BakingDishesOutputNo,
                                    const std::string &DebugRecipeTitle);
 };
@@ -0,0 +1,35 @@
+#include "JIT/CheffeWorkCounts.h"
+
+namespace cheffe
+{
+
+unsigned long long CheffeWorkCounts::getNumStepsDispatched() const
+{
+  unsigned long long NumSteps = 0;
+  for (const unsigned long long Count : StepsDispatched)
+  {
+    NumSteps += Count;
+  }
+  return NumSteps;
+}
+
+void CheffeWorkCounts::print(std::ostream &OS) const
+{
+  OS << "=== Work Counts ===" << std::endl
+     << "Steps dispatched: " << getNumStepsDispatched() << std::endl;
+  for (unsigned i = 0; i < NumStepKinds; ++i)
+  {
+    if (StepsDispatched[i])
+    {
+      OS << "  " << getMethodStepKindAsString(static_cast<MethodStepKind>(i))
+         << ": " << StepsDispatched[i] << std::endl;
+    }
+  }
+  OS << "Elements moved: " << ElementsMoved << std::endl
+     << "Elements copied: " << ElementsCopied << std::endl
+     << "Elements shifted: " << ElementsShifted << std::endl
+     << "Bytes output: " << BytesOutput << std::endl
+     << "Frames created: " << FramesCreated << std::endl;
+}
+
+} // end namespace cheffe
@@ -0,0 +1,44 @@
+#ifndef CHEFFE_WORK_COUNTS
+#define CHEFFE_WORK_COUNTS
+
+#include "IR/CheffeMethodStep.h"
+
+#include <ostream>
+
+namespace cheffe
+{
+
+// Abstract units of work done by the JIT, counted only when it's asked to.
+// Unlike timings, they come out the same on every machine and every run, so
+// tests can check them exactly.
+struct CheffeWorkCounts
+{
+  static const unsigned NumStepKinds =
+      static_cast<unsigned>(MethodStepKind::Invalid);
+
+  // Method steps dispatched, indexed by their kind.
+  unsigned long long StepsDispatched[NumStepKinds] = {};
+  // Items pushed onto or popped off a mixing bowl or baking dish one at a
+  // time, including those popped off a dish to be output.
+  unsigned long long ElementsMoved = 0;
+  // Items copied wholesale between bowls and dishes: a served recipe's copy of
+  // its caller's, a poured bowl, and a served recipe's first mixing bowl
+  // handed back on return.
+  unsigned long long ElementsCopied = 0;
+  // Items that had to move along within a bowl: those a stirred item is put
+  // beneath, and those mixed.
+  unsigned long long ElementsShifted = 0;
+  unsigned long long BytesOutput = 0;
+  // Recipe activations, including the main recipe's.
+  unsigned long long FramesCreated = 0;
+
+  unsigned long long getNumStepsDispatched() const;
+
+  // Prints the counts in a form meant for reading; steps that were never
+  // dispatched are left out.
+  void print(std::ostream &OS) const;
+};
+
+} // end namespace cheffe
+
+#endif // CHEFFE_WORK_COUNTS
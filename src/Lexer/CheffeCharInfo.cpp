@@ -0,0 +1,151 @@
+#include "Lexer/CheffeCharInfo.h"
+
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+#define CHEFFE_LEXER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace cheffe
+{
+
+namespace charinfo
+{
+
+namespace
+{
+
+constexpr unsigned char classifyChar(const unsigned C)
+{
+  if (C == ' ' || C == '\t')
+  {
+    return CHAR_BLANK;
+  }
+  if (C == '\v' || C == '\f' || C == '\r')
+  {
+    return CHAR_OTHER_SPACE;
+  }
+  if (C == '\n')
+  {
+    return CHAR_NEWLINE;
+  }
+  if ((C >= 'a' && C <= 'z') || (C >= 'A' && C <= 'Z'))
+  {
+    return CHAR_LETTER;
+  }
+  if (C >= '0' && C <= '9')
+  {
+    return CHAR_DIGIT;
+  }
+  if (C > ' ' && C < 0x7F)
+  {
+    return CHAR_PUNCT;
+  }
+  return 0;
+}
+
+} // end anonymous namespace
+
+constexpr CharInfoTable::CharInfoTable() : Info()
+{
+  for (unsigned C = 0; C < 256; ++C)
+  {
+    Info[C] = classifyChar(C);
+  }
+}
+
+constexpr CharInfoTable InfoTable;
+
+static_assert(InfoTable.Info['a'] == CHAR_LETTER &&
+                  InfoTable.Info['Z'] == CHAR_LETTER,
+              "Letters misclassified");
+static_assert(InfoTable.Info['7'] == CHAR_DIGIT, "Digits misclassified");
+static_assert(InfoTable.Info['.'] == CHAR_PUNCT &&
+                  InfoTable.Info['~'] == CHAR_PUNCT,
+              "Punctuation misclassified");
+static_assert(InfoTable.Info['\n'] == CHAR_NEWLINE &&
+                  InfoTable.Info['\r'] == CHAR_OTHER_SPACE &&
+                  InfoTable.Info['\t'] == CHAR_BLANK,
+              "Whitespace misclassified");
+static_assert(InfoTable.Info[0x7F] == 0 && InfoTable.Info[0xE9] == 0,
+              "Non-printable characters misclassified");
+
+} // end namespace charinfo
+
+const char *scanLetters(const char *Ptr, const char *End)
+{
+#ifdef CHEFFE_LEXER_SSE2
+  // Setting the 0x20 bit folds upper case onto lower case, without moving any
+  // other character into [a-z]. Bytes above 0x7F stay negative, and so fail
+  // the signed comparisons.
+  const __m128i CaseBit = _mm_set1_epi8(0x20);
+  const __m128i BeforeA = _mm_set1_epi8('a' - 1);
+  const __m128i AfterZ = _mm_set1_epi8('z' + 1);
+  while (End - Ptr >= 16)
+  {
+    const __m128i Chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(Ptr));
+    const __m128i Folded = _mm_or_si128(Chunk, CaseBit);
+    const __m128i IsLetter = _mm_and_si128(_mm_cmpgt_epi8(Folded, BeforeA),
+                                           _mm_cmplt_epi8(Folded, AfterZ));
+    const unsigned Mask = ~_mm_movemask_epi8(IsLetter) & 0xFFFF;
+    if (Mask)
+    {
+      return Ptr + __builtin_ctz(Mask);
+    }
+    Ptr += 16;
+  }
+#endif
+
+  while (Ptr != End && isLetter(static_cast<unsigned char>(*Ptr)))
+  {
+    ++Ptr;
+  }
+  return Ptr;
+}
+
+const char *scanHorizontalWhitespace(const char *Ptr, const char *End)
+{
+#ifdef CHEFFE_LEXER_SSE2
+  // ' ', or anything in ['\t', '\r'] except for '\n'.
+  const __m128i Space = _mm_set1_epi8(' ');
+  const __m128i BeforeTab = _mm_set1_epi8('\t' - 1);
+  const __m128i AfterCR = _mm_set1_epi8('\r' + 1);
+  const __m128i NewLine = _mm_set1_epi8('\n');
+  while (End - Ptr >= 16)
+  {
+    const __m128i Chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(Ptr));
+    const __m128i InControlRange = _mm_and_si128(
+        _mm_cmpgt_epi8(Chunk, BeforeTab), _mm_cmplt_epi8(Chunk, AfterCR));
+    const __m128i IsSpace = _mm_or_si128(
+        _mm_cmpeq_epi8(Chunk, Space),
+        _mm_andnot_si128(_mm_cmpeq_epi8(Chunk, NewLine), InControlRange));
+    const unsigned Mask = ~_mm_movemask_epi8(IsSpace) & 0xFFFF;
+    if (Mask)
+    {
+      return Ptr + __builtin_ctz(Mask);
+    }
+    Ptr += 16;
+  }
+#endif
+
+  using namespace charinfo;
+  while (Ptr != End && hasCharInfo(static_cast<unsigned char>(*Ptr),
+                                   CHAR_BLANK | CHAR_OTHER_SPACE))
+  {
+    ++Ptr;
+  }
+  return Ptr;
+}
+
+const char *scanDigits(const char *Ptr, const char *End)
+{
+  // Unsigned arithmetic turns this into a single comparison per character.
+  while (Ptr != End && static_cast<unsigned char>(*Ptr - '0') < 10)
+  {
+    ++Ptr;
+  }
+  return Ptr;
+}
+
+} // end namespace cheffe
@@ -0,0 +1,78 @@
+#ifndef CHEFFE_CHAR_INFO
+#define CHEFFE_CHAR_INFO
+
+#include <cstddef>
+
+namespace cheffe
+{
+
+namespace charinfo
+{
+
+enum CharInfoFlags : unsigned char
+{
+  CHAR_BLANK = 0x01,       // ' ', '\t'
+  CHAR_OTHER_SPACE = 0x02, // '\v', '\f', '\r'
+  CHAR_NEWLINE = 0x04,     // '\n'
+  CHAR_LETTER = 0x08,      // [A-Za-z]
+  CHAR_DIGIT = 0x10,       // [0-9]
+  CHAR_PUNCT = 0x20        // Printable, but not a letter, digit or space
+};
+
+// The classification of each byte, matching the "C" locale's <cctype>. It's
+// built at compile time, so there's no static initialisation to order.
+struct CharInfoTable
+{
+  unsigned char Info[256];
+
+  constexpr CharInfoTable();
+};
+
+extern const CharInfoTable InfoTable;
+
+} // end namespace charinfo
+
+// These all take an int, as returned by the lexer's getNextChar(), and are
+// false for the -1 that signals the end of the input.
+inline bool hasCharInfo(const int C, const unsigned char Flags)
+{
+  return C >= 0 && (charinfo::InfoTable.Info[C & 0xFF] & Flags) != 0;
+}
+
+inline bool isWhitespace(const int C)
+{
+  using namespace charinfo;
+  return hasCharInfo(C, CHAR_BLANK | CHAR_OTHER_SPACE | CHAR_NEWLINE);
+}
+
+inline bool isBlank(const int C)
+{
+  return hasCharInfo(C, charinfo::CHAR_BLANK);
+}
+
+inline bool isLetter(const int C)
+{
+  return hasCharInfo(C, charinfo::CHAR_LETTER);
+}
+
+inline bool isDigit(const int C)
+{
+  return hasCharInfo(C, charinfo::CHAR_DIGIT);
+}
+
+inline bool isPunctuation(const int C)
+{
+  return hasCharInfo(C, charinfo::CHAR_PUNCT);
+}
+
+// Return a pointer to the first character in [Ptr, End) that isn't in the
+// respective class, or End if there isn't one. The letter and whitespace
+// scanners use SSE2 to look at 16 bytes at a time where it's available;
+// numbers are too short for that to pay off.
+const char *scanLetters(const char *Ptr, const char *End);
+const char *scanHorizontalWhitespace(const char *Ptr, const char *End);
+const char *scanDigits(const char *Ptr, const char *End);
+
+} // end namespace cheffe
+
+#endif // CHEFFE_CHAR_INFO
@@ -1,4 +1,5 @@
 #include "Lexer/CheffeLexer.h"
+#include "Lexer/CheffeCharInfo.h"
 
 #include <cassert>
 
@@ -8,6 +9,23 @@ namespace cheffe
 void CheffeLexer::setSourceFile(const CheffeSourceFile &SrcFile)
 {
   File = SrcFile;
+  BufferStart = File.getSource().data();
+  BufferSize = File.size();
+  assert(BufferSize <= CheffeSourceBuffer::MaxBufferSize &&
+         "Source locations can't address this buffer");
+}
+
+const CheffeSourceFile &CheffeLexer::getSourceFile() const
+{
+  return File;
+}
+
+void CheffeLexer::setSourceRange(const std::size_t Begin, const std::size_t End)
+{
+  assert(Begin <= End && End <= File.size() && "Invalid source range");
+  CurrentPos = Begin;
+  BufferSize = End;
+  IgnoreNewLines = false;
 }
 
 void CheffeLexer::setIgnoreNewLines(const bool Ignore)
@@ -17,63 +35,63 @@ void CheffeLexer::setIgnoreNewLines(const bool Ignore)
 
 int CheffeLexer::getNextChar()
 {
-  if (static_cast<std::size_t>(CurrentPos) >= File.Source.size())
+  if (CurrentPos >= BufferSize)
   {
     return -1;
   }
-  const char Char = File[CurrentPos++];
-  if (Char == '\n')
-  {
-    ++LineNumber;
-    ColumnNumber = 1;
-  }
-  else
-  {
-    ++ColumnNumber;
-  }
-  return Char;
+  return BufferStart[CurrentPos++];
 }
 
 // Peeks at the next char from the input stream. Can optionally ignore any
 // space or tab characters while peeking.
 int CheffeLexer::peekNextChar(IgnoreWhiteSpace Ignore) const
 {
-  int NextChar = -1;
   std::size_t Pos = CurrentPos;
-  do
+  if (Ignore == IgnoreWhiteSpace::True)
   {
-    if (static_cast<std::size_t>(Pos) >= File.Source.size())
+    while (Pos < BufferSize && isBlank(BufferStart[Pos]))
     {
-      return -1;
+      ++Pos;
     }
-    NextChar = File[Pos++];
-  } while (Ignore == IgnoreWhiteSpace::True &&
-           (NextChar == ' ' || NextChar == '\t'));
+  }
 
-  return NextChar;
+  if (Pos >= BufferSize)
+  {
+    return -1;
+  }
+  return BufferStart[Pos];
+}
+
+void CheffeLexer::advance(const std::size_t Count)
+{
+  assert(CurrentPos + Count <= BufferSize && "Advancing past end of buffer");
+  CurrentPos += Count;
 }
 
 std::string CheffeLexer::getTextSpan(const std::size_t Begin,
                                      const std::size_t End) const
 {
-  assert(Begin >= 0 && Begin <= End && "");
-  return File.Source.substr(Begin, End - Begin);
+  return getTextRef(Begin, End).str();
+}
+
+StringRef CheffeLexer::getTextRef(const std::size_t Begin,
+                                  const std::size_t End) const
+{
+  assert(Begin <= End && End <= BufferSize && "Invalid text span");
+  return StringRef(BufferStart + Begin, End - Begin);
 }
 
 Token CheffeLexer::getToken()
 {
   Token Tok(TokenKind::Unknown);
 
-  Tok.SourceLoc.Begin = CurrentPos;
-
   // Skip any whitespace.
-  while (isspace(peekNextChar()))
+  while (isWhitespace(peekNextChar()))
   {
     if (peekNextChar() == '\n')
     {
       Tok.Kind = TokenKind::NewLine;
-      Tok.SourceLoc.LineNo = LineNumber;
-      Tok.SourceLoc.ColumnNo = ColumnNumber;
+      const std::size_t TokBegin = CurrentPos;
 
       getNextChar();
       if (peekNextChar(IgnoreWhiteSpace::True) == '\n')
@@ -86,59 +104,50 @@ Token CheffeLexer::getToken()
         continue;
       }
 
-      Tok.SourceLoc.End = CurrentPos;
+      Tok.SourceLoc = SourceLocation(TokBegin, CurrentPos);
       return Tok;
     }
 
-    getNextChar();
+    const char *Ptr = BufferStart + CurrentPos;
+    advance(scanHorizontalWhitespace(Ptr, BufferStart + BufferSize) - Ptr);
   }
 
-  Tok.SourceLoc.Begin = CurrentPos;
-  Tok.SourceLoc.LineNo = LineNumber;
-  Tok.SourceLoc.ColumnNo = ColumnNumber;
+  const std::size_t TokBegin = CurrentPos;
 
   const int Char = getNextChar();
 
   if (Char == -1)
   {
-    Tok.SourceLoc.End = CurrentPos;
+    Tok.SourceLoc = SourceLocation(TokBegin, CurrentPos);
     Tok.Kind = TokenKind::EndOfFile;
     return Tok;
   }
 
-  if (isalpha(Char))
+  if (isLetter(Char))
   {
-    std::string IdentifierString{(char)Char};
-    while (isalpha(peekNextChar()))
-    {
-      IdentifierString += getNextChar();
-    }
-
-    Tok.IdentifierString = std::move(IdentifierString);
+    const char *Ptr = BufferStart + CurrentPos;
+    advance(scanLetters(Ptr, BufferStart + BufferSize) - Ptr);
 
-    Tok.SourceLoc.End = CurrentPos;
+    Tok.SourceLoc = SourceLocation(TokBegin, CurrentPos);
+    Tok.Text = getTextRef(TokBegin, CurrentPos);
     Tok.Kind = TokenKind::Identifier;
     return Tok;
   }
 
-  if (isdigit(Char))
+  if (isDigit(Char))
   {
-    std::string NumStr = {(char)Char};
-    while (isdigit(peekNextChar()))
-    {
-      NumStr += getNextChar();
-    }
-
-    Tok.NumVal = strtod(NumStr.c_str(), 0);
+    const char *Ptr = BufferStart + CurrentPos;
+    advance(scanDigits(Ptr, BufferStart + BufferSize) - Ptr);
 
-    Tok.SourceLoc.End = CurrentPos;
+    Tok.SourceLoc = SourceLocation(TokBegin, CurrentPos);
+    Tok.Text = getTextRef(TokBegin, CurrentPos);
     Tok.Kind = TokenKind::Number;
     return Tok;
   }
 
-  if (ispunct(Char))
+  if (isPunctuation(Char))
   {
-    Tok.SourceLoc.End = CurrentPos;
+    Tok.SourceLoc = SourceLocation(TokBegin, CurrentPos);
     Tok.Kind = TokenKind::Unknown;
 
     switch (Char)
@@ -165,7 +174,7 @@ Token CheffeLexer::getToken()
     return Tok;
   }
 
-  Tok.SourceLoc.End = CurrentPos;
+  Tok.SourceLoc = SourceLocation(TokBegin, CurrentPos);
   Tok.Kind = TokenKind::Unknown;
   return Tok;
 }
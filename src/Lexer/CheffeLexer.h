@@ -21,14 +21,17 @@ private:
   std::size_t CurrentPos;
   CheffeSourceFile File;
 
-  unsigned LineNumber;
-  unsigned ColumnNumber;
+  // Cached from the source file, as the lexer looks at every character.
+  const char *BufferStart;
+  std::size_t BufferSize;
 
   bool IgnoreNewLines;
 
+  void advance(const std::size_t Count);
+
 public:
   CheffeLexer()
-      : CurrentPos(0), File(), LineNumber(1), ColumnNumber(1),
+      : CurrentPos(0), File(), BufferStart(nullptr), BufferSize(0),
         IgnoreNewLines(false)
   {
   }
@@ -36,6 +39,12 @@ public:
   // Sets the source file to work on
   void setSourceFile(const CheffeSourceFile &SrcFile);
 
+  const CheffeSourceFile &getSourceFile() const;
+
+  // Lexes only the text in [Begin, End) of the source file, as though the file
+  // held nothing else. Source locations are still offsets into the whole file.
+  void setSourceRange(const std::size_t Begin, const std::size_t End);
+
   // Gets a char from the input
   int getNextChar();
 
@@ -49,6 +58,10 @@ public:
   // Returns a copy of the span of text from the input file.
   std::string getTextSpan(const std::size_t Begin, const std::size_t End) const;
 
+  // Returns a reference to the span of text, without copying it. It's only
+  // valid for as long as this lexer's source file is.
+  StringRef getTextRef(const std::size_t Begin, const std::size_t End) const;
+
   void setIgnoreNewLines(const bool Ignore);
 };
 
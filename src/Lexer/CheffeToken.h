@@ -1,6 +1,12 @@
 #ifndef CHEFFE_TOKEN
 #define CHEFFE_TOKEN
 
+#include "Utils/CheffeStringRef.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstdint>
 #include <string>
 #include <iostream>
 
@@ -60,66 +66,52 @@ static std::ostream &operator<<(std::ostream &OS, const TokenKind &Kind)
   return OS;
 }
 
+// A span of characters in the source buffer, as a 32-bit offset and length.
+// Line and column numbers aren't stored: they're looked up in the source
+// buffer's line index when a diagnostic needs them.
 struct SourceLocation
 {
-public:
-  friend class CheffeLexer;
-
 private:
-  std::size_t Begin;
-  std::size_t End;
-
-  unsigned LineNo;
-  unsigned ColumnNo;
+  std::uint32_t Offset;
+  std::uint32_t Length;
 
 public:
-  SourceLocation() : Begin(0), End(0), LineNo(1), ColumnNo(1)
+  SourceLocation() : Offset(0), Length(0)
   {
   }
 
   SourceLocation(const std::size_t B, const std::size_t E)
-      : Begin(B), End(E), LineNo(1), ColumnNo(1)
-  {
-  }
-
-  SourceLocation(const std::size_t B, const std::size_t E, const unsigned Line,
-                 const unsigned Column)
-      : Begin(B), End(E), LineNo(Line), ColumnNo(Column)
+      : Offset(static_cast<std::uint32_t>(B)),
+        Length(static_cast<std::uint32_t>(E - B))
   {
+    assert(B <= E && E <= UINT32_MAX && "Invalid source location");
   }
 
   // Constructs a SourceLocation from the beginning of the first
   // SourceLocation, to the end of the second.
   SourceLocation(const SourceLocation Begin, const SourceLocation End)
-      : Begin(Begin.getBegin()), End(End.getEnd()), LineNo(Begin.getLineNo()),
-        ColumnNo(Begin.getColumnNo())
+      : SourceLocation(Begin.getBegin(), End.getEnd())
   {
   }
 
   std::size_t getBegin() const
   {
-    return Begin;
+    return Offset;
   }
   std::size_t getEnd() const
   {
-    return End;
+    return static_cast<std::size_t>(Offset) + Length;
   }
 
   std::size_t getLength() const
   {
-    return End - Begin;
-  }
-
-  unsigned getLineNo() const
-  {
-    return LineNo;
-  }
-  unsigned getColumnNo() const
-  {
-    return ColumnNo;
+    return Length;
   }
 };
 
+static_assert(sizeof(SourceLocation) == 8,
+              "SourceLocation should stay small: it's in every token");
+
 class Token
 {
 public:
@@ -131,76 +123,18 @@ private:
   // Position information
   SourceLocation SourceLoc;
 
-  long long NumVal;
-  std::string IdentifierString;
+  // The characters of the token, referring straight into the source buffer.
+  // Identifiers and numbers are only decoded from this when asked for.
+  StringRef Text;
 
 public:
   // Constructors
-  Token() : Kind(TokenKind::EndOfFile), SourceLoc(), NumVal(0)
-  {
-  }
-
-  Token(TokenKind Tok) : Kind(Tok), SourceLoc(), NumVal(0)
-  {
-  }
-
-  Token(TokenKind Tok, std::size_t B, std::size_t E, long long Val)
-      : Kind(Tok), SourceLoc(B, E), NumVal(Val)
-  {
-  }
-
-  Token(std::string Str)
-      : Kind(TokenKind::Identifier), SourceLoc(), NumVal(0),
-        IdentifierString(Str)
-  {
-  }
-
-  Token(const char *Str)
-      : Kind(TokenKind::Identifier), SourceLoc(), NumVal(0),
-        IdentifierString(Str)
-  {
-  }
-
-  // Copy constructor
-  Token(const Token &Other)
-      : Kind(Other.Kind), SourceLoc(Other.SourceLoc), NumVal(Other.NumVal),
-        IdentifierString(Other.IdentifierString)
-  {
-  }
-
-  // Move constructor
-  Token(Token &&Other)
-      : Kind(Other.Kind), SourceLoc(Other.SourceLoc), NumVal(Other.NumVal),
-        IdentifierString(std::move(Other.IdentifierString))
-
-  {
-    Other.Kind = TokenKind::Unknown;
-    Other.SourceLoc = SourceLocation();
-    Other.NumVal = 0;
-  }
-
-  // Copy assignment operator
-  Token &operator=(const Token &Other)
+  Token() : Kind(TokenKind::EndOfFile), SourceLoc(), Text()
   {
-    Kind = Other.Kind;
-    SourceLoc = Other.SourceLoc;
-    IdentifierString = Other.IdentifierString;
-    NumVal = Other.NumVal;
-    return *this;
   }
 
-  // Move assignment operator
-  Token &operator=(Token &&Other)
+  Token(TokenKind Tok) : Kind(Tok), SourceLoc(), Text()
   {
-    Kind = Other.Kind;
-    SourceLoc = Other.SourceLoc;
-    IdentifierString = std::move(Other.IdentifierString);
-    NumVal = Other.NumVal;
-
-    Other.Kind = TokenKind::Unknown;
-    Other.SourceLoc = SourceLocation();
-    Other.NumVal = 0;
-    return *this;
   }
 
   bool isBlankLine() const
@@ -213,13 +147,9 @@ public:
   {
     return Kind == Tok;
   }
-  bool is(const std::string &Str) const
-  {
-    return is(TokenKind::Identifier) && IdentifierString == Str;
-  }
-  bool is(std::string &&Str) const
+  bool is(const StringRef Str) const
   {
-    return is(TokenKind::Identifier) && IdentifierString == Str;
+    return is(TokenKind::Identifier) && Text == Str;
   }
   //==== is() ====//
 
@@ -228,11 +158,7 @@ public:
   {
     return Kind != Tok;
   }
-  bool isNot(const std::string &Str) const
-  {
-    return !is(Str);
-  }
-  bool isNot(std::string &&Str) const
+  bool isNot(const StringRef Str) const
   {
     return !is(Str);
   }
@@ -253,9 +179,9 @@ public:
     return isAnyOf(std::forward<Tail>(Toks)...);
   }
   template <typename... Tail>
-  bool isAnyOf(std::string &&Str, Tail &&... Toks) const
+  bool isAnyOf(const StringRef Str, Tail &&... Toks) const
   {
-    if (is(std::forward<std::string>(Str)))
+    if (is(Str))
     {
       return true;
     }
@@ -278,9 +204,9 @@ public:
     return isNotAnyOf(std::forward<Tail>(Toks)...);
   }
   template <typename... Tail>
-  bool isNotAnyOf(std::string &&Str, Tail &&... Toks) const
+  bool isNotAnyOf(const StringRef Str, Tail &&... Toks) const
   {
-    if (is(std::forward<std::string>(Str)))
+    if (is(Str))
     {
       return false;
     }
@@ -298,13 +224,46 @@ public:
     return SourceLoc;
   }
 
+  StringRef getText() const
+  {
+    return Text;
+  }
+
   std::string getIdentifierString() const
   {
-    return IdentifierString;
+    return Text.str();
+  }
+
+  // Decodes the number into Value, returning false if it's too large to fit,
+  // in which case Value is LLONG_MAX. No 18-digit number can overflow, so only
+  // the digits after those are checked.
+  bool getNumVal(long long &Value) const
+  {
+    const std::size_t SafeDigits = std::min<std::size_t>(Text.size(), 18);
+    long long NumVal = 0;
+    std::size_t i = 0;
+    for (; i < SafeDigits; ++i)
+    {
+      NumVal = NumVal * 10 + (Text[i] - '0');
+    }
+    for (; i < Text.size(); ++i)
+    {
+      const int Digit = Text[i] - '0';
+      if (NumVal > (LLONG_MAX - Digit) / 10)
+      {
+        Value = LLONG_MAX;
+        return false;
+      }
+      NumVal = NumVal * 10 + Digit;
+    }
+    Value = NumVal;
+    return true;
   }
 
   long long getNumVal() const
   {
+    long long NumVal = 0;
+    getNumVal(NumVal);
     return NumVal;
   }
 
@@ -312,20 +271,20 @@ public:
   {
     if (Tok.Kind == TokenKind::Identifier)
     {
-      if (Tok.IdentifierString.empty())
+      if (Tok.Text.empty())
       {
         OS << "identifier";
       }
       else
       {
-        OS << Tok.IdentifierString;
+        OS << Tok.Text;
       }
       return OS;
     }
 
     if (Tok.Kind == TokenKind::Number)
     {
-      OS << Tok.NumVal;
+      OS << Tok.Text;
       return OS;
     }
 
@@ -0,0 +1,66 @@
+#include "Linker/CheffeLinker.h"
+#include "IR/CheffeRecipeInfo.h"
+
+namespace cheffe
+{
+
+CheffeErrorCode CheffeLinker::linkProgram(CheffeProgramInfo &ProgramInfo)
+{
+  CheffeErrorCode Success = CheffeErrorCode::CHEFFE_SUCCESS;
+
+  // Keep going after a failure so that every missing recipe is reported.
+  for (unsigned i = 0, e = ProgramInfo.getNumRecipes(); i != e; ++i)
+  {
+    if (linkRecipe(ProgramInfo, *ProgramInfo.getRecipe(i)) !=
+        CheffeErrorCode::CHEFFE_SUCCESS)
+    {
+      Success = CheffeErrorCode::CHEFFE_ERROR;
+    }
+  }
+
+  return Success;
+}
+
+CheffeErrorCode CheffeLinker::linkRecipe(const CheffeProgramInfo &ProgramInfo,
+                                         CheffeRecipeInfo &Recipe)
+{
+  CheffePhaseTimer Timer(Timings, CheffePhase::Link, Recipe.getRecipeTitle());
+  CheffeErrorCode Success = CheffeErrorCode::CHEFFE_SUCCESS;
+
+  for (auto &MS : Recipe.getMethodSteps())
+  {
+    if (MS->getMethodStepKind() != MethodStepKind::Serve)
+    {
+      continue;
+    }
+
+    if (resolveRecipeOp(ProgramInfo, MS->getOperand(0)) !=
+        CheffeErrorCode::CHEFFE_SUCCESS)
+    {
+      Success = CheffeErrorCode::CHEFFE_ERROR;
+    }
+  }
+
+  return Success;
+}
+
+CheffeErrorCode
+CheffeLinker::resolveRecipeOp(const CheffeProgramInfo &ProgramInfo,
+                              MethodOp &Recipe)
+{
+  unsigned RecipeIdx = 0;
+  if (!ProgramInfo.getRecipeIndex(Recipe.getRecipeName(), RecipeIdx))
+  {
+    // The operand may have been linked before, to a recipe that's since gone.
+    Recipe.clearRecipeIndex();
+    Diagnostics->report(Recipe.getSourceLoc(),
+                        diag::err_undefined_serve_recipe)
+        << Recipe.getRecipeName();
+    return CheffeErrorCode::CHEFFE_ERROR;
+  }
+
+  Recipe.setRecipeIndex(RecipeIdx);
+  return CheffeErrorCode::CHEFFE_SUCCESS;
+}
+
+} // end namespace cheffe
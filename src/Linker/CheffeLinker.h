@@ -0,0 +1,49 @@
+#ifndef CHEFFE_LINKER
+#define CHEFFE_LINKER
+
+#include "cheffe.h"
+#include "IR/CheffeProgramInfo.h"
+#include "Utils/CheffeDiagnosticHandler.h"
+#include "Utils/CheffePhaseTimings.h"
+
+#include <memory>
+
+namespace cheffe
+{
+
+// Runs once the whole program has been parsed, binding every recipe operand
+// to the index of the recipe it names. Any recipe that can't be found is
+// reported here, rather than when the program gets around to serving it.
+class CheffeLinker
+{
+public:
+  CheffeLinker(std::shared_ptr<CheffeDiagnosticHandler> Diags)
+      : Diagnostics(Diags), Timings(nullptr)
+  {
+  }
+
+  CheffeErrorCode linkProgram(CheffeProgramInfo &ProgramInfo);
+
+  // Links one recipe of the program, for recipes that are loaded after the
+  // rest of the program has already been linked.
+  CheffeErrorCode linkRecipe(const CheffeProgramInfo &ProgramInfo,
+                             CheffeRecipeInfo &Recipe);
+
+  // Records the time spent linking each recipe into Timings, if it isn't
+  // null.
+  void setPhaseTimings(CheffePhaseTimings *PhaseTimings)
+  {
+    Timings = PhaseTimings;
+  }
+
+private:
+  std::shared_ptr<CheffeDiagnosticHandler> Diagnostics;
+  CheffePhaseTimings *Timings;
+
+  CheffeErrorCode resolveRecipeOp(const CheffeProgramInfo &ProgramInfo,
+                                  MethodOp &Recipe);
+};
+
+} // end namespace cheffe
+
+#endif // CHEFFE_LINKER
@@ -0,0 +1,257 @@
+#ifndef CHEFFE_KEYWORDS
+#define CHEFFE_KEYWORDS
+
+#include "Utils/CheffeStringRef.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cheffe
+{
+
+// The keyword tables below are perfect hashes built at compile time: every
+// keyword owns a distinct slot under the table's seed, so a lookup is one
+// hash, one slot read and one string comparison. The seeds were found
+// offline; the static_asserts at the bottom of this file reject any seed
+// that makes two keywords collide.
+
+constexpr std::size_t getKeywordLength(const char *Keyword)
+{
+  std::size_t Length = 0;
+  while (Keyword[Length])
+  {
+    ++Length;
+  }
+  return Length;
+}
+
+// FNV-1a, followed by a final mix so that the low bits used to pick a slot
+// depend on every character.
+constexpr std::uint32_t hashKeyword(const char *Str, const std::size_t Length,
+                                    const std::uint32_t Seed)
+{
+  std::uint32_t Hash = 2166136261u ^ Seed;
+  for (std::size_t i = 0; i < Length; ++i)
+  {
+    Hash ^= static_cast<unsigned char>(Str[i]);
+    Hash *= 16777619u;
+  }
+  Hash ^= Hash >> 15;
+  Hash *= 0x2c1b3c6du;
+  Hash ^= Hash >> 12;
+  return Hash;
+}
+
+template <typename EntryTy, std::size_t NumEntries, std::size_t NumSlots>
+class KeywordTable
+{
+  static_assert(NumSlots && (NumSlots & (NumSlots - 1)) == 0,
+                "Keyword tables must have a power-of-two number of slots");
+  static_assert(NumEntries <= NumSlots && NumEntries < 255,
+                "Too many keywords for this table");
+
+public:
+  constexpr KeywordTable(const EntryTy (&KeywordEntries)[NumEntries],
+                         const std::uint32_t HashSeed)
+      : Entries(KeywordEntries), Seed(HashSeed), Slots{}, Collides(false)
+  {
+    for (std::size_t i = 0; i < NumEntries; ++i)
+    {
+      const char *Name = Entries[i].Name;
+      const std::size_t Slot = getSlot(Name, getKeywordLength(Name));
+      if (Slots[Slot])
+      {
+        Collides = true;
+      }
+      Slots[Slot] = static_cast<unsigned char>(i + 1);
+    }
+  }
+
+  constexpr bool hasCollisions() const
+  {
+    return Collides;
+  }
+
+  // Returns the entry for Name, or nullptr if it isn't a keyword.
+  const EntryTy *lookup(const StringRef Name) const
+  {
+    const unsigned char Index = Slots[getSlot(Name.data(), Name.size())];
+    if (!Index || !Name.equals(Entries[Index - 1].Name))
+    {
+      return nullptr;
+    }
+    return &Entries[Index - 1];
+  }
+
+private:
+  const EntryTy *Entries;
+  std::uint32_t Seed;
+  // One-based indices into Entries; zero marks an empty slot.
+  unsigned char Slots[NumSlots];
+  bool Collides;
+
+  constexpr std::size_t getSlot(const char *Str,
+                                const std::size_t Length) const
+  {
+    return hashKeyword(Str, Length, Seed) & (NumSlots - 1);
+  }
+};
+
+enum class MethodStepKeywordKind
+{
+  Take,
+  Put,
+  Fold,
+  Add,
+  Remove,
+  Combine,
+  Divide,
+  Liquefy,
+  Liquify,
+  Stir,
+  Mix,
+  Clean,
+  Pour,
+  Set,
+  Serve,
+  Refrigerate
+};
+
+struct MethodStepKeyword
+{
+  const char *Name;
+  MethodStepKeywordKind Kind;
+};
+
+constexpr MethodStepKeyword MethodStepKeywordEntries[] = {
+    {"Take", MethodStepKeywordKind::Take},
+    {"Put", MethodStepKeywordKind::Put},
+    {"Fold", MethodStepKeywordKind::Fold},
+    {"Add", MethodStepKeywordKind::Add},
+    {"Remove", MethodStepKeywordKind::Remove},
+    {"Combine", MethodStepKeywordKind::Combine},
+    {"Divide", MethodStepKeywordKind::Divide},
+    {"Liquefy", MethodStepKeywordKind::Liquefy},
+    {"Liquify", MethodStepKeywordKind::Liquify},
+    {"Stir", MethodStepKeywordKind::Stir},
+    {"Mix", MethodStepKeywordKind::Mix},
+    {"Clean", MethodStepKeywordKind::Clean},
+    {"Pour", MethodStepKeywordKind::Pour},
+    {"Set", MethodStepKeywordKind::Set},
+    {"Serve", MethodStepKeywordKind::Serve},
+    {"Refrigerate", MethodStepKeywordKind::Refrigerate}};
+
+constexpr KeywordTable<MethodStepKeyword, 16, 16>
+    MethodStepKeywords(MethodStepKeywordEntries, 128863);
+
+// A verb that opens a loop, along with the past tense that closes it.
+struct VerbKeyword
+{
+  const char *Name;
+  const char *PastTense;
+};
+
+constexpr VerbKeyword VerbKeywordEntries[] = {
+    {"Sift", "Sifted"},         {"Rub", "Rubbed"},
+    {"Melt", "Melted"},         {"Caramelise", "Caramelised"},
+    {"Cook", "Cooked"},         {"Chop", "Chopped"},
+    {"Bake", "Baked"},          {"Roast", "Roasted"},
+    {"Boil", "Boiled"},         {"Chill", "Chilled"},
+    {"Fry", "Fried"},           {"Loop", "Looped"},
+    {"Shake", "Shaked"},        {"Sieve", "Sieved"},
+    {"Squeeze", "Squeezed"},    {"Drip", "Dripped"},
+    {"Drop", "Dropped"},        {"Scoop", "Scooped"},
+    {"Coat", "Coated"},         {"Randomize", "Randomized"},
+    {"Toss", "Tossed"},         {"Infuse", "Infused"},
+    {"Watch", "Watched"},       {"Smell", "Smelled"},
+    {"Crush", "Crushed"},       {"Mash", "Mashed"},
+    {"Grind", "Ground"},        {"Finish", "Finished"},
+    {"Shuffle", "Shuffled"},    {"Layer", "Layered"},
+    {"Prepare", "Prepared"},    {"Separate", "Separated"},
+    {"Sprinkle", "Sprinkled"},  {"Move", "Moved"},
+    {"Recite", "Recited"},      {"Repeat", "Repeated"},
+    {"Siphon", "Siphoned"},     {"Gulp", "Gulped"},
+    {"Quote", "Quoted"},        {"Part", "Parted"},
+    {"Dissolve", "Dissolved"},  {"Agitate", "Agitated"},
+    {"Cool", "Cooled"},         {"Leave", "Left"},
+    {"Wash", "Washed"},         {"Water", "Watered"},
+    {"Heat", "Heated"}};
+
+constexpr KeywordTable<VerbKeyword, 47, 128> VerbKeywords(VerbKeywordEntries,
+                                                          1790);
+
+enum class MeasureKindTy
+{
+  Dry,
+  Wet,
+  Unspecified,
+  Invalid
+};
+
+struct MeasureKeyword
+{
+  const char *Name;
+  MeasureKindTy Kind;
+};
+
+constexpr MeasureKeyword MeasureKeywordEntries[] = {
+    {"g", MeasureKindTy::Dry},
+    {"kg", MeasureKindTy::Dry},
+    {"pinch", MeasureKindTy::Dry},
+    {"pinches", MeasureKindTy::Dry},
+    {"ml", MeasureKindTy::Wet},
+    {"l", MeasureKindTy::Wet},
+    {"dash", MeasureKindTy::Wet},
+    {"dashes", MeasureKindTy::Wet},
+    {"cup", MeasureKindTy::Unspecified},
+    {"cups", MeasureKindTy::Unspecified},
+    {"teaspoon", MeasureKindTy::Unspecified},
+    {"teaspoons", MeasureKindTy::Unspecified},
+    {"tablespoon", MeasureKindTy::Unspecified},
+    {"tablespoons", MeasureKindTy::Unspecified}};
+
+constexpr KeywordTable<MeasureKeyword, 14, 16>
+    MeasureKeywords(MeasureKeywordEntries, 1159);
+
+struct MeasureTypeKeyword
+{
+  const char *Name;
+};
+
+constexpr MeasureTypeKeyword MeasureTypeKeywordEntries[] = {{"heaped"},
+                                                            {"level"}};
+
+constexpr KeywordTable<MeasureTypeKeyword, 2, 4>
+    MeasureTypeKeywords(MeasureTypeKeywordEntries, 2);
+
+// A unit of time, in either number, along with both of its spellings.
+struct TimeUnitKeyword
+{
+  const char *Name;
+  const char *Singular;
+  const char *Plural;
+};
+
+constexpr TimeUnitKeyword TimeUnitKeywordEntries[] = {
+    {"hour", "hour", "hours"},
+    {"hours", "hour", "hours"},
+    {"minute", "minute", "minutes"},
+    {"minutes", "minute", "minutes"}};
+
+constexpr KeywordTable<TimeUnitKeyword, 4, 8>
+    TimeUnitKeywords(TimeUnitKeywordEntries, 1);
+
+static_assert(!MethodStepKeywords.hasCollisions(),
+              "Method step keyword seed produces a collision");
+static_assert(!VerbKeywords.hasCollisions(),
+              "Verb keyword seed produces a collision");
+static_assert(!MeasureKeywords.hasCollisions(),
+              "Measure keyword seed produces a collision");
+static_assert(!MeasureTypeKeywords.hasCollisions(),
+              "Measure type keyword seed produces a collision");
+static_assert(!TimeUnitKeywords.hasCollisions(),
+              "Time unit keyword seed produces a collision");
+
+} // end namespace cheffe
+
+#endif // CHEFFE_KEYWORDS
@@ -1,12 +1,16 @@
 #include "Parser/CheffeParser.h"
+#include "Lexer/CheffeCharInfo.h"
 #include "IR/CheffeMethodStep.h"
 #include "IR/CheffeIngredient.h"
-#include "Utils/CheffeUtils.h"
 #include "Utils/CheffeDebugUtils.h"
 
 #include <cassert>
 #include <array>
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <thread>
 
 #define DEBUG_TYPE "parser"
 
@@ -23,6 +27,11 @@ std::shared_ptr<CheffeParserOptions> CheffeParser::getOptions() const
   return Options;
 }
 
+void CheffeParser::setOptions(std::shared_ptr<CheffeParserOptions> Opts)
+{
+  Options = Opts;
+}
+
 void CheffeParser::setSourceFile(const CheffeSourceFile &SrcFile)
 {
   Lexer.setSourceFile(SrcFile);
@@ -40,10 +49,9 @@ bool CheffeParser::checkNonStandardTokenAndConsume(const std::string &Str)
   {
     if (Options->StrictChef)
     {
-      Diagnostics->report(CurrentToken.getSourceLoc(), DiagnosticKind::Error,
-                          LineContext::WithContext)
-          << "Unexpected '" << Str
-          << "'. Try using the '-chef-strict off' option";
+      Diagnostics->report(CurrentToken.getSourceLoc(),
+                          diag::err_strict_chef_unexpected)
+          << Str;
       return true;
     }
     getNextToken();
@@ -52,6 +60,18 @@ bool CheffeParser::checkNonStandardTokenAndConsume(const std::string &Str)
   return false;
 }
 
+bool CheffeParser::getNumberValue(long long &Value, const long long MaxValue)
+{
+  assert(CurrentToken.is(TokenKind::Number) && "Expected a number token");
+  if (CurrentToken.getNumVal(Value) && Value <= MaxValue)
+  {
+    return false;
+  }
+  Diagnostics->report(CurrentToken.getSourceLoc(), diag::err_number_too_large)
+      << CurrentToken;
+  return true;
+}
+
 bool CheffeParser::checkCurrentTokenPlurality(const long long Number,
                                               const std::string &Singular,
                                               const std::string &Plural,
@@ -59,15 +79,15 @@ bool CheffeParser::checkCurrentTokenPlurality(const long long Number,
 {
   if (CurrentToken.is(Singular) && Number != 1)
   {
-    Diagnostics->report(CurrentToken.getSourceLoc(), DiagnosticKind::Warning,
-                        LineContext::WithContext)
-        << "Plural " << Name << " used alongside '" << Singular << "'";
+    Diagnostics->report(CurrentToken.getSourceLoc(),
+                        diag::warn_plural_with_singular)
+        << Name << Singular;
   }
   else if (CurrentToken.is(Plural) && Number == 1)
   {
-    Diagnostics->report(CurrentToken.getSourceLoc(), DiagnosticKind::Warning,
-                        LineContext::WithContext)
-        << "Singular " << Name << " used alongside '" << Plural << "'";
+    Diagnostics->report(CurrentToken.getSourceLoc(),
+                        diag::warn_singular_with_plural)
+        << Name << Plural;
   }
   else
   {
@@ -82,20 +102,26 @@ bool CheffeParser::getIngredientInfo(const std::string &IngredientName,
                                      const SourceLocation IngredientLoc,
                                      CheffeIngredient **Ingredient)
 {
-  *Ingredient = CurrentRecipe->getIngredient(IngredientName);
-  if (Ingredient != nullptr)
+  // A name that was never interned can't have been defined anywhere.
+  CheffeSymbol IngredientSymbol = 0;
+  *Ingredient = nullptr;
+  if (ProgramInfo->getSymbolTable().lookup(IngredientName, IngredientSymbol))
+  {
+    *Ingredient = CurrentRecipe->getIngredient(IngredientSymbol);
+  }
+  if (*Ingredient != nullptr)
   {
     return false;
   }
-  Diagnostics->report(IngredientLoc, DiagnosticKind::Error,
-                      LineContext::WithContext)
-      << "Ingredient '" << IngredientName
-      << "' was not defined in the Ingredients paragraph";
+  Diagnostics->report(IngredientLoc, diag::err_undefined_ingredient)
+      << IngredientName;
   return true;
 }
 
 std::unique_ptr<CheffeProgramInfo> CheffeParser::takeProgramInfo()
 {
+  // The current recipe lives in the program's arena.
+  CurrentRecipe = nullptr;
   return std::move(ProgramInfo);
 }
 
@@ -111,7 +137,12 @@ CheffeParser::parsePossibleOrdinalIdentifier(unsigned &MixingBowlNo)
     return CheffeErrorCode::CHEFFE_SUCCESS;
   }
 
-  const unsigned Number = CurrentToken.getNumVal();
+  long long NumberValue = 0;
+  if (getNumberValue(NumberValue, std::numeric_limits<unsigned>::max()))
+  {
+    return CheffeErrorCode::CHEFFE_ERROR;
+  }
+  const unsigned Number = static_cast<unsigned>(NumberValue);
   auto NumberSourceLoc = CurrentToken.getSourceLoc();
   if (consumeAndExpectToken(TokenKind::Identifier))
   {
@@ -120,17 +151,13 @@ CheffeParser::parsePossibleOrdinalIdentifier(unsigned &MixingBowlNo)
 
   if (!isValidOrdinalIdentifier(Number, CurrentToken.getIdentifierString()))
   {
-    Diagnostics->report(CurrentToken.getSourceLoc(), DiagnosticKind::Warning,
-                        LineContext::WithContext)
-        << "Incorrect use of ordinal identifier: mismatch between number and "
-           "suffix";
+    Diagnostics->report(CurrentToken.getSourceLoc(),
+                        diag::warn_ordinal_suffix_mismatch);
   }
 
   if (Number == 0)
   {
-    Diagnostics->report(NumberSourceLoc, DiagnosticKind::Error,
-                        LineContext::WithContext)
-        << "Cannot use 0 as an ordinal identifier";
+    Diagnostics->report(NumberSourceLoc, diag::err_zero_ordinal);
     return CheffeErrorCode::CHEFFE_ERROR;
   }
 
@@ -184,122 +211,539 @@ bool CheffeParser::isValidOrdinalIdentifier(const unsigned Number,
   return Suffix == ExpectedSuffix;
 }
 
-CheffeErrorCode CheffeParser::parseProgram()
+unsigned CheffeParser::getNumParseThreads() const
 {
-  CheffeErrorCode Success = CheffeErrorCode::CHEFFE_SUCCESS;
+#ifndef NDEBUG
+  // Debug output from several threads at once would be unreadable.
+  if (DebugFlag && isCurrentDebugType(DEBUG_TYPE))
+  {
+    return 1;
+  }
+#endif
 
-  // Grab the first token
-  getNextToken();
+  return std::max(Options->ParseThreads, 1u);
+}
 
-  do
+// Returns the offset of the end of the line Pos is on.
+static std::size_t getLineEnd(const StringRef Source, const std::size_t Pos)
+{
+  const void *NewLine =
+      std::memchr(Source.data() + Pos, '\n', Source.size() - Pos);
+  return NewLine ? static_cast<const char *>(NewLine) - Source.data()
+                 : Source.size();
+}
+
+static bool isBlankLine(const StringRef Source, std::size_t Pos,
+                        const std::size_t LineEnd)
+{
+  while (Pos < LineEnd && isBlank(Source[Pos]))
   {
-    std::string RecipeTitle;
-    SourceLocation RecipeTitleLoc;
-    Success = parseRecipeTitle(RecipeTitle, RecipeTitleLoc);
-    if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
+    ++Pos;
+  }
+  return Pos == LineEnd;
+}
+
+// Returns the word a paragraph starts with, skipping any leading blanks.
+static StringRef getFirstWord(const StringRef Source, std::size_t Pos)
+{
+  while (Pos < Source.size() && isBlank(Source[Pos]))
+  {
+    ++Pos;
+  }
+  const std::size_t Begin = Pos;
+  while (Pos < Source.size() && isLetter(Source[Pos]))
+  {
+    ++Pos;
+  }
+  return StringRef(Source.data() + Begin, Pos - Begin);
+}
+
+// Whether a paragraph starting with Word is the heading of the section of that
+// name, such as 'Method.', rather than just starting with the same word.
+static bool isSectionHeading(const StringRef Source, const StringRef Word,
+                             const char *Section)
+{
+  if (!Word.equals(Section))
+  {
+    return false;
+  }
+  std::size_t Next = Word.end() - Source.begin();
+  while (Next < Source.size() && isBlank(Source[Next]))
+  {
+    ++Next;
+  }
+  return Next < Source.size() && Source[Next] == '.';
+}
+
+std::vector<SourceLocation>
+CheffeParser::findRecipeRanges(const StringRef Source)
+{
+  std::vector<SourceLocation> RecipeRanges;
+  std::size_t RecipeBegin = 0;
+  // Whether the last paragraph could have ended a recipe.
+  bool AfterMethod = false;
+  // A comment can start with 'Method.' too, but only the Method paragraph can
+  // come after the recipe's Ingredients paragraph.
+  bool AfterIngredients = false;
+
+  std::size_t Pos = 0;
+  while (Pos < Source.size())
+  {
+    // Skip blank lines, which is what separates paragraphs.
+    std::size_t LineEnd = getLineEnd(Source, Pos);
+    if (isBlankLine(Source, Pos, LineEnd))
     {
-      return Success;
+      Pos = LineEnd + 1;
+      continue;
     }
 
-    if (!ProgramInfo)
+    const std::size_t ParagraphBegin = Pos;
+    const StringRef FirstWord = getFirstWord(Source, ParagraphBegin);
+    const bool IsServes = FirstWord.equals("Serves");
+    if (AfterMethod && !IsServes)
     {
-      return CheffeErrorCode::CHEFFE_ERROR;
+      RecipeRanges.push_back(SourceLocation(RecipeBegin, ParagraphBegin));
+      RecipeBegin = ParagraphBegin;
+      AfterIngredients = false;
     }
 
-    if (ProgramInfo->getRecipe(RecipeTitle))
+    // Worked out only once it's known which recipe the paragraph is in, as a
+    // recipe can be titled 'Method.' too.
+    const bool IsMethod =
+        AfterIngredients && isSectionHeading(Source, FirstWord, "Method");
+    AfterMethod = IsMethod || (AfterMethod && IsServes);
+    AfterIngredients = AfterIngredients ||
+                       isSectionHeading(Source, FirstWord, "Ingredients");
+
+    // Move to the end of the paragraph: the next blank line.
+    Pos = LineEnd + 1;
+    while (Pos < Source.size())
     {
-      Diagnostics->report(RecipeTitleLoc, DiagnosticKind::Error,
-                          LineContext::WithContext)
-          << "Recipe '" << RecipeTitle << "' defined more than once!";
-      return CheffeErrorCode::CHEFFE_ERROR;
+      LineEnd = getLineEnd(Source, Pos);
+      if (isBlankLine(Source, Pos, LineEnd))
+      {
+        break;
+      }
+      Pos = LineEnd + 1;
     }
+  }
 
-    ProgramInfo->setEntryPointRecipeTitleIfNone(RecipeTitle);
-
-    auto Recipe = std::make_shared<CheffeRecipeInfo>(RecipeTitle);
-
-    CurrentRecipe = Recipe;
-    ProgramInfo->addRecipe(RecipeTitle, Recipe);
+  RecipeRanges.push_back(SourceLocation(RecipeBegin, Source.size()));
+  return RecipeRanges;
+}
 
-    Success = parseCommentBlock();
-    if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
+CheffeErrorCode CheffeParser::parseProgram()
+{
+  const unsigned NumThreads = getNumParseThreads();
+  if (Options->LazyParsing)
+  {
+    // Indexing only reports what it found once it knows the index is good.
+    auto IndexDiagnostics = std::make_shared<CheffeDiagnosticHandler>();
+    std::swap(Diagnostics, IndexDiagnostics);
+    CheffeErrorCode Success = CheffeErrorCode::CHEFFE_SUCCESS;
     {
-      return Success;
+      CheffePhaseTimer Timer(Timings, CheffePhase::Parse, std::string());
+      Success = indexProgram();
     }
-
-    Success = parseIngredientsList();
-    if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
+    std::swap(Diagnostics, IndexDiagnostics);
+    if (Success == CheffeErrorCode::CHEFFE_SUCCESS)
     {
+      Diagnostics->mergeDiagnostics(*IndexDiagnostics);
       return Success;
     }
 
-    Success = parseCookingTime();
-    if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
+    // A title that can't be read where the pre-scan expected one may only
+    // mean the pre-scan guessed wrong, so the whole program is parsed now
+    // instead. That way a valid program is never rejected, and errors are
+    // reported exactly as they would be without lazy parsing.
+    ProgramInfo.reset(new CheffeProgramInfo());
+    Lexer.setSourceRange(0, Lexer.getSourceFile().size());
+  }
+  else if (NumThreads > 1)
+  {
+    std::vector<SourceLocation> RecipeRanges;
     {
-      return Success;
+      CheffePhaseTimer Timer(Timings, CheffePhase::Parse, std::string());
+      RecipeRanges = findRecipeRanges(Lexer.getSourceFile().getSource());
+    }
+    std::size_t NumKept = 0;
+    if (RecipeRanges.size() > 1 &&
+        parseRecipesInParallel(RecipeRanges, NumThreads, NumKept) ==
+            CheffeErrorCode::CHEFFE_SUCCESS)
+    {
+      return CheffeErrorCode::CHEFFE_SUCCESS;
     }
 
-    Success = parseOvenTemperature();
-    if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
+    // Carry on from the first recipe that wasn't kept.
+    if (NumKept)
     {
-      return Success;
+      Lexer.setSourceRange(RecipeRanges[NumKept].getBegin(),
+                           Lexer.getSourceFile().size());
     }
+  }
+
+  CheffeErrorCode Success = CheffeErrorCode::CHEFFE_SUCCESS;
+
+  // Grab the first token
+  getNextToken();
 
-    Success = parseMethod();
+  do
+  {
+    Success = parseRecipe();
     if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
     {
       return Success;
     }
+  } while (CurrentToken.isNot(TokenKind::EndOfFile));
 
-    Success = parseServesStatement();
-    if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
+  return Success;
+}
+
+// Parses each recipe range on its own, spread across NumThreads threads, each
+// with its own program to parse into. The recipes that parsed cleanly before
+// the first range that didn't are brought back into this parser's program in
+// source order, along with their diagnostics, and NumKept is set to how many
+// there were. If that isn't every range the caller is left to parse the rest
+// sequentially; that way errors are always reported exactly as they would be
+// without threads.
+CheffeErrorCode CheffeParser::parseRecipesInParallel(
+    const std::vector<SourceLocation> &RecipeRanges, const unsigned NumThreads,
+    std::size_t &NumKept)
+{
+  struct ParsedRecipe
+  {
+    CheffeRecipeInfo *Recipe = nullptr;
+    CheffeParser *Parser = nullptr;
+    std::shared_ptr<CheffeDiagnosticHandler> Diagnostics;
+    // Only kept if the recipe is.
+    std::unique_ptr<CheffePhaseTimings> Timings;
+  };
+
+  std::vector<ParsedRecipe> Results(RecipeRanges.size());
+  std::vector<std::unique_ptr<CheffeParser>> Workers;
+  std::atomic<std::size_t> NextRecipe(0);
+  // Ranges after the first one to fail are of no use, but every range before
+  // it still has to be parsed.
+  std::atomic<std::size_t> FirstFailure(RecipeRanges.size());
+
+  auto ParseRecipes = [&](CheffeParser *Worker)
+  {
+    // Recipes are handed out in source order, so each worker sees its own
+    // recipes in source order too.
+    for (std::size_t i = NextRecipe++; i < FirstFailure; i = NextRecipe++)
     {
-      return Success;
+      Results[i].Parser = Worker;
+      Results[i].Diagnostics = std::make_shared<CheffeDiagnosticHandler>();
+      Worker->Diagnostics = Results[i].Diagnostics;
+      if (Timings)
+      {
+        Results[i].Timings.reset(new CheffePhaseTimings());
+        Worker->Timings = Results[i].Timings.get();
+      }
+      if (Worker->parseRecipeInRange(RecipeRanges[i], Results[i].Recipe) !=
+          CheffeErrorCode::CHEFFE_SUCCESS)
+      {
+        std::size_t Failure = FirstFailure;
+        while (i < Failure && !FirstFailure.compare_exchange_weak(Failure, i))
+        {
+        }
+      }
     }
+  };
+
+  const unsigned NumWorkers = std::min<std::size_t>(NumThreads,
+                                                    RecipeRanges.size());
+  for (unsigned i = 0; i < NumWorkers; ++i)
+  {
+    Workers.emplace_back(new CheffeParser());
+    Workers.back()->Options = Options;
+    Workers.back()->Lexer.setSourceFile(Lexer.getSourceFile());
+  }
+
+  std::vector<std::thread> Threads;
+  for (unsigned i = 1; i < NumWorkers; ++i)
+  {
+    Threads.emplace_back(ParseRecipes, Workers[i].get());
+  }
+  ParseRecipes(Workers[0].get());
+  for (auto &Thread : Threads)
+  {
+    Thread.join();
+  }
 
-    while (CurrentToken.isBlankLine())
+  // Duplicate titles in different workers only show up here.
+  NumKept = 0;
+  while (NumKept < FirstFailure &&
+         ProgramInfo->adoptRecipe(Results[NumKept].Recipe,
+                                  *Results[NumKept].Parser->ProgramInfo))
+  {
+    ++NumKept;
+  }
+
+  // The recipes that aren't kept go along with the ones that are, but are
+  // never looked at again.
+  if (NumKept)
+  {
+    for (auto &Worker : Workers)
     {
-      getNextToken();
+      ProgramInfo->getArena().adopt(Worker->ProgramInfo->getArena());
     }
+  }
 
-    CHEFFE_DEBUG(dbgs() << std::endl; RecipeScopeInfo.dumpInfo(dbgs()));
+  for (std::size_t i = 0; i < NumKept; ++i)
+  {
+    Diagnostics->mergeDiagnostics(*Results[i].Diagnostics);
+  }
 
-    if (!RecipeScopeInfo.empty())
+  // Brought back in source order, like the recipes themselves. The time spent
+  // on recipes that weren't kept is charged to the program.
+  if (Timings)
+  {
+    for (unsigned Phase = 0; Phase < CheffePhaseTimings::NumPhases; ++Phase)
     {
-      Diagnostics->report(SourceLocation(), DiagnosticKind::Error,
-                          LineContext::WithoutContext)
-          << "Mismatched scopes on function exit";
-      return CheffeErrorCode::CHEFFE_ERROR;
+      for (std::size_t i = 0; i < NumKept; ++i)
+      {
+        for (const auto &Entry : Results[i].Timings->getRecipeTimes(
+                 static_cast<CheffePhase>(Phase)))
+        {
+          Timings->addTimes(static_cast<CheffePhase>(Phase), Entry.first,
+                            Entry.second);
+        }
+      }
     }
+    for (std::size_t i = NumKept; i < Results.size(); ++i)
+    {
+      if (!Results[i].Timings)
+      {
+        continue;
+      }
+      for (unsigned Phase = 0; Phase < CheffePhaseTimings::NumPhases; ++Phase)
+      {
+        Timings->addTimes(CheffePhase::Parse, std::string(),
+                          Results[i].Timings->getPhaseTotal(
+                              static_cast<CheffePhase>(Phase)));
+      }
+    }
+  }
+
+  if (NumKept != RecipeRanges.size())
+  {
+    return CheffeErrorCode::CHEFFE_ERROR;
+  }
 
-    Success = RecipeScopeInfo.fixupScopeMethodSteps(
-        CurrentRecipe->getMethodStepList());
+  CurrentToken = Token(TokenKind::EndOfFile);
+  return CheffeErrorCode::CHEFFE_SUCCESS;
+}
 
+// Reads only the title of each recipe the pre-scan finds, adding each recipe
+// to the program unloaded. As the pre-scan is only a guess, a recipe it got
+// wrong is only found out once that recipe is loaded.
+CheffeErrorCode CheffeParser::indexProgram()
+{
+  for (const SourceLocation &Range :
+       findRecipeRanges(Lexer.getSourceFile().getSource()))
+  {
+    Lexer.setSourceRange(Range.getBegin(), Range.getEnd());
+    getNextToken();
+
+    std::string RecipeTitle;
+    SourceLocation RecipeTitleLoc;
+    const CheffeErrorCode Success =
+        parseRecipeTitle(RecipeTitle, RecipeTitleLoc);
     if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
     {
-      Diagnostics->report(SourceLocation(), DiagnosticKind::Error,
-                          LineContext::WithoutContext)
-          << "Could not fixup nest instructions";
       return Success;
     }
 
-    RecipeScopeInfo.clearInfo();
+    CheffeRecipeInfo *Recipe = ProgramInfo->addRecipe(RecipeTitle);
+    if (!Recipe)
+    {
+      Diagnostics->report(RecipeTitleLoc, diag::err_duplicate_recipe)
+          << RecipeTitle;
+      return CheffeErrorCode::CHEFFE_ERROR;
+    }
+    Recipe->setTitleLoc(RecipeTitleLoc);
+    Recipe->setUnloaded(Range);
+  }
+
+  CurrentToken = Token(TokenKind::EndOfFile);
+  return CheffeErrorCode::CHEFFE_SUCCESS;
+}
 
-    // clang-format off
-    CHEFFE_DEBUG(
-      dbgs() << std::endl << "METHOD LIST:" << std::endl;
-      for (auto &MethodStep : CurrentRecipe->getMethodStepList())
-      {
-        dbgs() << "\t" << *MethodStep;
-      }
-      dbgs() << std::endl;
-    );
-    // clang-format on
-  } while (CurrentToken.isNot(TokenKind::EndOfFile));
+CheffeErrorCode CheffeParser::parseRecipeInRange(const SourceLocation Range,
+                                                 CheffeRecipeInfo *&Recipe)
+{
+  Lexer.setSourceRange(Range.getBegin(), Range.getEnd());
+  getNextToken();
+
+  CurrentRecipe = nullptr;
+  CheffeErrorCode Success = parseRecipe();
+  if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
+  {
+    Recipe = CurrentRecipe;
+    return Success;
+  }
+
+  if (CurrentToken.isNot(TokenKind::EndOfFile))
+  {
+    Diagnostics->report(CurrentToken.getSourceLoc(),
+                        diag::err_text_after_recipe)
+        << CurrentRecipe->getRecipeTitle();
+    Recipe = CurrentRecipe;
+    return CheffeErrorCode::CHEFFE_ERROR;
+  }
+
+  Recipe = CurrentRecipe;
+  return CheffeErrorCode::CHEFFE_SUCCESS;
+}
+
+// The parser lexes as it goes, and reading the clocks around every token would
+// take longer than lexing it. So with timings on, a recipe is lexed again on
+// its own once it's been parsed, and that time is taken off its parse time,
+// along with the time spent fixing up its scopes.
+CheffeErrorCode CheffeParser::parseRecipe()
+{
+  if (!Timings)
+  {
+    return parseRecipeContents();
+  }
+
+  const std::size_t Begin = CurrentToken.getSourceLoc().getBegin();
+  const CheffeRecipeInfo *PreviousRecipe = CurrentRecipe;
+  ScopeFixupTimes = CheffeTimes();
+
+  const CheffeTimes Start = CheffeTimes::now();
+  const CheffeErrorCode Success = parseRecipeContents();
+  CheffeTimes ParseTimes = CheffeTimes::now() - Start;
+
+  CheffeLexer RecipeLexer;
+  RecipeLexer.setSourceFile(Lexer.getSourceFile());
+  RecipeLexer.setSourceRange(
+      Begin, std::max(Begin, CurrentToken.getSourceLoc().getBegin()));
+  const CheffeTimes LexStart = CheffeTimes::now();
+  while (RecipeLexer.getToken().isNot(TokenKind::EndOfFile))
+  {
+  }
+  const CheffeTimes LexTimes = CheffeTimes::now() - LexStart;
+  ParseTimes -= LexTimes;
+  ParseTimes -= ScopeFixupTimes;
+
+  // A recipe that didn't get as far as a title is charged to the program.
+  const std::string Title = CurrentRecipe != PreviousRecipe
+                                ? CurrentRecipe->getRecipeTitle()
+                                : std::string();
+  Timings->addTimes(CheffePhase::Lex, Title, LexTimes);
+  Timings->addTimes(CheffePhase::Parse, Title, ParseTimes);
+  Timings->addTimes(CheffePhase::ScopeFixup, Title, ScopeFixupTimes);
 
   return Success;
 }
 
+CheffeErrorCode CheffeParser::parseRecipeContents()
+{
+  std::string RecipeTitle;
+  SourceLocation RecipeTitleLoc;
+  CheffeErrorCode Success = parseRecipeTitle(RecipeTitle, RecipeTitleLoc);
+  if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
+  {
+    return Success;
+  }
+
+  if (!ProgramInfo)
+  {
+    return CheffeErrorCode::CHEFFE_ERROR;
+  }
+
+  if (ProgramInfo->getRecipe(RecipeTitle))
+  {
+    Diagnostics->report(RecipeTitleLoc, diag::err_duplicate_recipe)
+        << RecipeTitle;
+    return CheffeErrorCode::CHEFFE_ERROR;
+  }
+
+  CurrentRecipe = ProgramInfo->addRecipe(RecipeTitle);
+  CurrentRecipe->setTitleLoc(RecipeTitleLoc);
+
+  Success = parseCommentBlock();
+  if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
+  {
+    return Success;
+  }
+
+  Success = parseIngredientsList();
+  if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
+  {
+    return Success;
+  }
+
+  Success = parseCookingTime();
+  if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
+  {
+    return Success;
+  }
+
+  Success = parseOvenTemperature();
+  if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
+  {
+    return Success;
+  }
+
+  Success = parseMethod();
+  if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
+  {
+    return Success;
+  }
+
+  Success = parseServesStatement();
+  if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
+  {
+    return Success;
+  }
+
+  while (CurrentToken.isBlankLine())
+  {
+    getNextToken();
+  }
+
+  CHEFFE_DEBUG(dbgs() << std::endl; RecipeScopeInfo.dumpInfo(dbgs()));
+
+  if (!RecipeScopeInfo.empty())
+  {
+    Diagnostics->report(SourceLocation(),
+                        diag::err_mismatched_scopes_at_exit);
+    return CheffeErrorCode::CHEFFE_ERROR;
+  }
+
+  const CheffeTimes FixupStart = Timings ? CheffeTimes::now() : CheffeTimes();
+  Success =
+      RecipeScopeInfo.fixupScopeMethodSteps(CurrentRecipe->getMethodSteps());
+  if (Timings)
+  {
+    ScopeFixupTimes = CheffeTimes::now() - FixupStart;
+  }
+
+  if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
+  {
+    Diagnostics->report(SourceLocation(), diag::err_scope_fixup_failed);
+    return Success;
+  }
+
+  RecipeScopeInfo.clearInfo();
+
+  // clang-format off
+  CHEFFE_DEBUG(
+    dbgs() << std::endl << "METHOD LIST:" << std::endl;
+    for (auto &MethodStep : CurrentRecipe->getMethodSteps())
+    {
+      dbgs() << "\t" << *MethodStep;
+    }
+    dbgs() << std::endl;
+  );
+  // clang-format on
+
+  return CheffeErrorCode::CHEFFE_SUCCESS;
+}
+
 // Return true if token didn't match, false otherwise.
 template <typename T> bool CheffeParser::consumeAndExpectToken(const T &Kind)
 {
@@ -314,9 +758,8 @@ template <typename T> bool CheffeParser::expectToken(const T &Kind)
   {
     return false;
   }
-  Diagnostics->report(CurrentToken.getSourceLoc(), DiagnosticKind::Error,
-                      LineContext::WithContext)
-      << "Expected " << Kind << ", got " << CurrentToken;
+  Diagnostics->report(CurrentToken.getSourceLoc(), diag::err_expected_token)
+      << Kind << CurrentToken;
   return true;
 }
 
@@ -351,9 +794,7 @@ CheffeErrorCode CheffeParser::parseRecipeTitle(std::string &RecipeTitle,
 
   if (EndTitleLoc.getEnd() == BeginTitleLoc.getBegin())
   {
-    Diagnostics->report(BeginTitleLoc, DiagnosticKind::Error,
-                        LineContext::WithContext)
-        << "Could not find a title";
+    Diagnostics->report(BeginTitleLoc, diag::err_missing_title);
     return CheffeErrorCode::CHEFFE_ERROR;
   }
 
@@ -409,37 +850,6 @@ CheffeErrorCode CheffeParser::parseCommentBlock()
   return CheffeErrorCode::CHEFFE_SUCCESS;
 }
 
-bool CheffeParser::isValidMeasure(const std::string &Measure,
-                                  MeasureKindTy &Kind)
-{
-  Kind = MeasureKindTy::Invalid;
-  auto MeasureFindResult = std::find(std::begin(ValidDryMeasures),
-                                     std::end(ValidDryMeasures), Measure);
-  if (MeasureFindResult != std::end(ValidDryMeasures))
-  {
-    Kind = MeasureKindTy::Dry;
-    return true;
-  }
-
-  MeasureFindResult = std::find(std::begin(ValidWetMeasures),
-                                std::end(ValidWetMeasures), Measure);
-  if (MeasureFindResult != std::end(ValidWetMeasures))
-  {
-    Kind = MeasureKindTy::Wet;
-    return true;
-  }
-
-  MeasureFindResult = std::find(std::begin(ValidUnspecifiedMeasures),
-                                std::end(ValidUnspecifiedMeasures), Measure);
-  if (MeasureFindResult != std::end(ValidUnspecifiedMeasures))
-  {
-    Kind = MeasureKindTy::Unspecified;
-    return true;
-  }
-
-  return false;
-}
-
 CheffeErrorCode CheffeParser::parseIngredientsList()
 {
   while (CurrentToken.isBlankLine())
@@ -497,7 +907,10 @@ CheffeErrorCode CheffeParser::parseIngredient()
   {
     // Value
     Ingredient.InitialValueData.HasValue = true;
-    Ingredient.InitialValueData.Value = CurrentToken.getNumVal();
+    if (getNumberValue(Ingredient.InitialValueData.Value))
+    {
+      return CheffeErrorCode::CHEFFE_ERROR;
+    }
     getNextToken();
   }
 
@@ -507,15 +920,9 @@ CheffeErrorCode CheffeParser::parseIngredient()
   }
 
   std::string IdentifierString = CurrentToken.getIdentifierString();
-  auto MeasureTypeFindResult =
-      std::find(std::begin(ValidMeasureTypes), std::end(ValidMeasureTypes),
-                IdentifierString);
-
-  const bool IsValidMeasureType =
-      MeasureTypeFindResult != std::end(ValidMeasureTypes);
 
   bool IsIngredientDefinedDry = false;
-  if (IsValidMeasureType)
+  if (MeasureTypeKeywords.lookup(IdentifierString))
   {
     IsIngredientDefinedDry = true;
     Ingredient.MeasureType = IdentifierString;
@@ -528,16 +935,13 @@ CheffeErrorCode CheffeParser::parseIngredient()
     IdentifierString = CurrentToken.getIdentifierString();
   }
 
-  MeasureKindTy MeasureKind;
-  const bool IsValidMeasure = isValidMeasure(IdentifierString, MeasureKind);
-
-  if (IsValidMeasure)
+  if (const MeasureKeyword *Measure = MeasureKeywords.lookup(IdentifierString))
   {
+    const MeasureKindTy MeasureKind = Measure->Kind;
     if (IsIngredientDefinedDry && MeasureKind == MeasureKindTy::Wet)
     {
-      Diagnostics->report(CurrentToken.getSourceLoc(), DiagnosticKind::Error,
-                          LineContext::WithContext)
-          << "Wet measure used when dry measure kind specified";
+      Diagnostics->report(CurrentToken.getSourceLoc(),
+                          diag::err_wet_measure_for_dry);
       return CheffeErrorCode::CHEFFE_ERROR;
     }
 
@@ -553,9 +957,8 @@ CheffeErrorCode CheffeParser::parseIngredient()
 
   if (CurrentToken.is("the"))
   {
-    Diagnostics->report(CurrentToken.getSourceLoc(), DiagnosticKind::Error,
-                        LineContext::WithContext)
-        << "Defining an ingredient beginning with 'the' will be ambiguous";
+    Diagnostics->report(CurrentToken.getSourceLoc(),
+                        diag::err_ingredient_begins_with_the);
     return CheffeErrorCode::CHEFFE_ERROR;
   }
   const std::size_t BeginIngredientNamePos =
@@ -579,30 +982,12 @@ CheffeErrorCode CheffeParser::parseIngredient()
 
   CHEFFE_DEBUG(dbgs() << "INGREDIENT: " << Ingredient << std::endl);
 
-  CurrentRecipe->addIngredientDefinition(Ingredient);
+  CurrentRecipe->addIngredientDefinition(
+      ProgramInfo->getSymbolTable().intern(Ingredient.Name), Ingredient);
 
   return CheffeErrorCode::CHEFFE_SUCCESS;
 }
 
-bool CheffeParser::isValidTimeUnit(const std::string &TimeUnit,
-                                   StringPair &MatchingPair)
-{
-  MatchingPair = {"", ""};
-  auto TimeUnitFindResult =
-      std::find_if(std::begin(ValidTimeUnits), std::end(ValidTimeUnits),
-                   [&TimeUnit](StringPair UnitPair)
-                   {
-        return UnitPair.first == TimeUnit || UnitPair.second == TimeUnit;
-      });
-  if (TimeUnitFindResult == std::end(ValidTimeUnits))
-  {
-    return false;
-  }
-
-  MatchingPair = *TimeUnitFindResult;
-  return true;
-}
-
 CheffeErrorCode CheffeParser::parseCookingTime()
 {
   while (CurrentToken.isBlankLine())
@@ -630,25 +1015,26 @@ CheffeErrorCode CheffeParser::parseCookingTime()
   {
     return CheffeErrorCode::CHEFFE_ERROR;
   }
-  const long long Time = CurrentToken.getNumVal();
+  long long Time = 0;
+  if (getNumberValue(Time))
+  {
+    return CheffeErrorCode::CHEFFE_ERROR;
+  }
 
   if (consumeAndExpectToken(TokenKind::Identifier))
   {
     return CheffeErrorCode::CHEFFE_ERROR;
   }
-  const std::string TimeUnit = CurrentToken.getIdentifierString();
-
-  StringPair MatchingPair;
-  const bool IsValidTimeUnit = isValidTimeUnit(TimeUnit, MatchingPair);
-  if (!IsValidTimeUnit)
+  const TimeUnitKeyword *TimeUnit =
+      TimeUnitKeywords.lookup(CurrentToken.getText());
+  if (!TimeUnit)
   {
-    Diagnostics->report(CurrentToken.getSourceLoc(), DiagnosticKind::Error,
-                        LineContext::WithContext)
-        << "Invalid time measurement: must be hour[s] or minute[s]";
+    Diagnostics->report(CurrentToken.getSourceLoc(),
+                        diag::err_invalid_time_unit);
     return CheffeErrorCode::CHEFFE_ERROR;
   }
 
-  checkCurrentTokenPlurality(Time, MatchingPair.first, MatchingPair.second,
+  checkCurrentTokenPlurality(Time, TimeUnit->Singular, TimeUnit->Plural,
                              "cooking time");
 
   if (consumeAndExpectToken(TokenKind::FullStop))
@@ -663,7 +1049,7 @@ CheffeErrorCode CheffeParser::parseCookingTime()
 
   // clang-format off
   CHEFFE_DEBUG(
-    dbgs() << "COOKING TIME: " << Time << " " << TimeUnit.c_str() << std::endl
+    dbgs() << "COOKING TIME: " << Time << " " << TimeUnit->Name << std::endl
            << std::endl;
   );
   // clang-format on
@@ -708,7 +1094,11 @@ CheffeErrorCode CheffeParser::parseOvenTemperature()
   {
     return CheffeErrorCode::CHEFFE_ERROR;
   }
-  const long long Temperature = CurrentToken.getNumVal();
+  long long Temperature = 0;
+  if (getNumberValue(Temperature))
+  {
+    return CheffeErrorCode::CHEFFE_ERROR;
+  }
 
   if (consumeAndExpectToken("degrees"))
   {
@@ -740,7 +1130,10 @@ CheffeErrorCode CheffeParser::parseOvenTemperature()
     {
       return CheffeErrorCode::CHEFFE_ERROR;
     }
-    GasMark = CurrentToken.getNumVal();
+    if (getNumberValue(GasMark))
+    {
+      return CheffeErrorCode::CHEFFE_ERROR;
+    }
 
     if (consumeAndExpectToken(TokenKind::CloseBrace))
     {
@@ -840,112 +1233,79 @@ CheffeErrorCode CheffeParser::parseMethodStep()
     return CheffeErrorCode::CHEFFE_ERROR;
   }
 
-  const std::string MethodStepKeyword = CurrentToken.getIdentifierString();
-  auto FindResult = std::find(std::begin(ValidMethodSteps),
-                              std::end(ValidMethodSteps), MethodStepKeyword);
+  const MethodStepKeyword *Keyword =
+      MethodStepKeywords.lookup(CurrentToken.getText());
 
-  bool IsKnownVerb = false;
-  const bool IsValidMethodStepKeyword =
-      FindResult != std::end(ValidMethodSteps);
-
-  if (!IsValidMethodStepKeyword)
+  if (!Keyword && !VerbKeywords.lookup(CurrentToken.getText()))
   {
-    auto VerbFindResult =
-        std::find_if(std::begin(ValidVerbKeywords), std::end(ValidVerbKeywords),
-                     [&MethodStepKeyword](const StringPair &Pair)
-                     {
-          return Pair.first == MethodStepKeyword;
-        });
-
-    IsKnownVerb = VerbFindResult != std::end(ValidVerbKeywords);
-  }
-
-  if (!IsValidMethodStepKeyword && !IsKnownVerb)
-  {
-    Diagnostics->report(CurrentToken.getSourceLoc(), DiagnosticKind::Error,
-                        LineContext::WithContext)
-        << "Invalid Method Step Keyword: '" << MethodStepKeyword.c_str() << "'";
+    Diagnostics->report(CurrentToken.getSourceLoc(),
+                        diag::err_invalid_method_step)
+        << CurrentToken.getText();
     return CheffeErrorCode::CHEFFE_ERROR;
   }
 
-  if (MethodStepKeyword == "Liquify")
-  {
-    Diagnostics->report(CurrentToken.getSourceLoc(), DiagnosticKind::Warning,
-                        LineContext::WithContext)
-        << "'Liquify' keyword is deprecated: use 'Liquefy' instead";
-  }
-
   SourceLocation BeginMethodStepLoc = CurrentToken.getSourceLoc();
 
   CheffeErrorCode Success = CheffeErrorCode::CHEFFE_SUCCESS;
-  if (MethodStepKeyword == "Take")
-  {
-    Success = parseTakeMethodStep();
-  }
-  else if (MethodStepKeyword == "Put")
-  {
-    Success = parsePutOrFoldMethodStep(MethodStepKind::Put);
-  }
-  else if (MethodStepKeyword == "Fold")
-  {
-    Success = parsePutOrFoldMethodStep(MethodStepKind::Fold);
-  }
-  else if (MethodStepKeyword == "Add")
-  {
-    Success = parseArithmeticMethodStep(MethodStepKind::Add);
-  }
-  else if (MethodStepKeyword == "Remove")
-  {
-    Success = parseArithmeticMethodStep(MethodStepKind::Remove);
-  }
-  else if (MethodStepKeyword == "Combine")
-  {
-    Success = parseArithmeticMethodStep(MethodStepKind::Combine);
-  }
-  else if (MethodStepKeyword == "Divide")
-  {
-    Success = parseArithmeticMethodStep(MethodStepKind::Divide);
-  }
-  else if (MethodStepKeyword == "Liquefy" || MethodStepKeyword == "Liquify")
-  {
-    Success = parseLiquefyMethodStep();
-  }
-  else if (MethodStepKeyword == "Stir")
-  {
-    Success = parseStirMethodStep();
-  }
-  else if (MethodStepKeyword == "Mix")
-  {
-    Success = parseMixMethodStep();
-  }
-  else if (MethodStepKeyword == "Clean")
-  {
-    Success = parseCleanMethodStep();
-  }
-  else if (MethodStepKeyword == "Pour")
-  {
-    Success = parsePourMethodStep();
-  }
-  else if (IsKnownVerb)
+  // Anything that isn't a method step keyword is a known verb.
+  if (!Keyword)
   {
     Success = parseVerbMethodStep();
   }
-  else if (MethodStepKeyword == "Set")
-  {
-    Success = parseSetAsideMethodStep();
-  }
-  else if (MethodStepKeyword == "Serve")
-  {
-    Success = parseServeMethodStep();
-  }
-  else if (MethodStepKeyword == "Refrigerate")
-  {
-    Success = parseRefrigerateMethodStep();
-  }
   else
   {
-    cheffe_unreachable("Invalid method step keyword!");
-    return CheffeErrorCode::CHEFFE_ERROR;
+    switch (Keyword->Kind)
+    {
+    case MethodStepKeywordKind::Take:
+      Success = parseTakeMethodStep();
+      break;
+    case MethodStepKeywordKind::Put:
+      Success = parsePutOrFoldMethodStep(MethodStepKind::Put);
+      break;
+    case MethodStepKeywordKind::Fold:
+      Success = parsePutOrFoldMethodStep(MethodStepKind::Fold);
+      break;
+    case MethodStepKeywordKind::Add:
+      Success = parseArithmeticMethodStep(MethodStepKind::Add);
+      break;
+    case MethodStepKeywordKind::Remove:
+      Success = parseArithmeticMethodStep(MethodStepKind::Remove);
+      break;
+    case MethodStepKeywordKind::Combine:
+      Success = parseArithmeticMethodStep(MethodStepKind::Combine);
+      break;
+    case MethodStepKeywordKind::Divide:
+      Success = parseArithmeticMethodStep(MethodStepKind::Divide);
+      break;
+    case MethodStepKeywordKind::Liquify:
+      Diagnostics->report(CurrentToken.getSourceLoc(),
+                          diag::warn_deprecated_liquify);
+    // Fall through
+    case MethodStepKeywordKind::Liquefy:
+      Success = parseLiquefyMethodStep();
+      break;
+    case MethodStepKeywordKind::Stir:
+      Success = parseStirMethodStep();
+      break;
+    case MethodStepKeywordKind::Mix:
+      Success = parseMixMethodStep();
+      break;
+    case MethodStepKeywordKind::Clean:
+      Success = parseCleanMethodStep();
+      break;
+    case MethodStepKeywordKind::Pour:
+      Success = parsePourMethodStep();
+      break;
+    case MethodStepKeywordKind::Set:
+      Success = parseSetAsideMethodStep();
+      break;
+    case MethodStepKeywordKind::Serve:
+      Success = parseServeMethodStep();
+      break;
+    case MethodStepKeywordKind::Refrigerate:
+      Success = parseRefrigerateMethodStep();
+      break;
+    }
   }
 
   if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
@@ -1052,6 +1412,23 @@ CheffeParser::parsePutOrFoldMethodStep(const MethodStepKind Step)
   return CheffeErrorCode::CHEFFE_SUCCESS;
 }
 
+const char *CheffeParser::getMethodStepPreposition(const MethodStepKind Step)
+{
+  switch (Step)
+  {
+  case MethodStepKind::Add:
+    return "to";
+  case MethodStepKind::Remove:
+    return "from";
+  case MethodStepKind::Combine:
+  case MethodStepKind::Divide:
+    return "into";
+  default:
+    cheffe_unreachable("Invalid method step kind");
+    return nullptr;
+  }
+}
+
 // Parses either an 'Add', 'Remove', 'Combine', or 'Divide' method step:
 //   Add ingredient [to [nth] mixing bowl].
 //   Remove ingredient [from [nth] mixing bowl].
@@ -1064,11 +1441,7 @@ CheffeParser::parseArithmeticMethodStep(const MethodStepKind Step)
 {
   getNextToken();
 
-  if (MethodStepPrepositions.find(Step) == std::end(MethodStepPrepositions))
-  {
-    cheffe_unreachable("Invalid method step kind");
-  }
-  const std::string Preposition = MethodStepPrepositions.find(Step)->second;
+  const char *Preposition = getMethodStepPreposition(Step);
 
   CheffeMethodStep *MethodStep = nullptr;
 
@@ -1093,7 +1466,7 @@ CheffeParser::parseArithmeticMethodStep(const MethodStepKind Step)
   {
     const SourceLocation BeginIngredientLoc = CurrentToken.getSourceLoc();
     SourceLocation EndIngredientLoc = BeginIngredientLoc;
-    while (CurrentToken.isNotAnyOf(Preposition.c_str(), TokenKind::FullStop,
+    while (CurrentToken.isNotAnyOf(Preposition, TokenKind::FullStop,
                                    TokenKind::EndOfFile))
     {
       EndIngredientLoc = CurrentToken.getSourceLoc();
@@ -1116,7 +1489,7 @@ CheffeParser::parseArithmeticMethodStep(const MethodStepKind Step)
   }
 
   unsigned MixingBowlNo = 1;
-  if (CurrentToken.isNot(Preposition.c_str()))
+  if (CurrentToken.isNot(Preposition))
   {
     MethodStep->addMixingBowl(MixingBowlNo);
     return CheffeErrorCode::CHEFFE_SUCCESS;
@@ -1346,14 +1719,18 @@ CheffeErrorCode CheffeParser::parseStirMethodStep()
       return CheffeErrorCode::CHEFFE_ERROR;
     }
 
-    const long long NumberOfMinutes = CurrentToken.getNumVal();
+    long long NumberOfMinutes = 0;
+    if (getNumberValue(NumberOfMinutes))
+    {
+      return CheffeErrorCode::CHEFFE_ERROR;
+    }
 
     getNextToken();
     if (CurrentToken.isNotAnyOf("minute", "minutes"))
     {
-      Diagnostics->report(CurrentToken.getSourceLoc(), DiagnosticKind::Error,
-                          LineContext::WithContext)
-          << "Expected 'minute' or 'minutes', got " << CurrentToken;
+      Diagnostics->report(CurrentToken.getSourceLoc(),
+                          diag::err_expected_minutes)
+          << CurrentToken;
       return CheffeErrorCode::CHEFFE_ERROR;
     }
 
@@ -1660,9 +2037,8 @@ CheffeErrorCode CheffeParser::parseVerbMethodStep()
     auto MethodStep = CurrentRecipe->addNewMethodStep(MethodStepKind::Verb);
     if (!Ingredient)
     {
-      Diagnostics->report(CurrentToken.getSourceLoc(), DiagnosticKind::Error,
-                          LineContext::WithContext)
-          << "Verb method steps must specify an ingredient";
+      Diagnostics->report(CurrentToken.getSourceLoc(),
+                          diag::err_verb_without_ingredient);
       return CheffeErrorCode::CHEFFE_ERROR;
     }
     MethodStep->addIngredient(Ingredient, IngredientLoc);
@@ -1680,9 +2056,8 @@ CheffeErrorCode CheffeParser::parseVerbMethodStep()
     CheffeScope *Scope = nullptr;
     if (RecipeScopeInfo.popScope(&Scope))
     {
-      Diagnostics->report(CurrentToken.getSourceLoc(), DiagnosticKind::Error,
-                          LineContext::WithContext)
-          << "Mismatched scope: empty scope stack";
+      Diagnostics->report(CurrentToken.getSourceLoc(),
+                          diag::err_until_without_scope);
       return CheffeErrorCode::CHEFFE_ERROR;
     }
     assert(Scope && "Scope information shall not be nullptr");
@@ -1696,20 +2071,14 @@ CheffeErrorCode CheffeParser::parseVerbMethodStep()
     );
     // clang-format on
 
-    auto VerbFindResult =
-        std::find_if(std::begin(ValidVerbKeywords), std::end(ValidVerbKeywords),
-                     [&FromVerb](const StringPair &Pair)
-                     {
-          return Pair.first == FromVerb;
-        });
-    assert(VerbFindResult != std::end(ValidVerbKeywords));
+    const VerbKeyword *FromVerbKeyword = VerbKeywords.lookup(FromVerb);
+    assert(FromVerbKeyword && "Scopes are only opened by known verbs");
 
-    if (!AreLowerCasedStringsEqual(VerbFindResult->second, UntilVerb))
+    if (!StringRef(FromVerbKeyword->PastTense).equalsLower(UntilVerb))
     {
-      Diagnostics->report(CurrentToken.getSourceLoc(), DiagnosticKind::Error,
-                          LineContext::WithContext)
-          << "Mismatched verbs: trying to match '" << FromVerb << "' with '"
-          << UntilVerb << "'";
+      Diagnostics->report(CurrentToken.getSourceLoc(),
+                          diag::err_mismatched_verbs)
+          << FromVerb << UntilVerb;
       return CheffeErrorCode::CHEFFE_ERROR;
     }
     getNextToken();
@@ -1721,8 +2090,7 @@ CheffeErrorCode CheffeParser::parseVerbMethodStep()
     // UntilVerbed's method step.
     assert(Scope->BeginScope &&
            "MethodStep at beginning of loop shall not be nullptr");
-    MethodStep->addIngredient(
-        ((IngredientOp *)(Scope->BeginScope->getOperand(0))));
+    MethodStep->addIngredient(Scope->BeginScope->getOperand(0));
 
     // Register this UntilVerbed method step as the end of the current nest.
     Scope->EndScope = MethodStep;
@@ -1749,9 +2117,8 @@ CheffeErrorCode CheffeParser::parseSetAsideMethodStep()
 
   if (RecipeScopeInfo.addBreak(MethodStep))
   {
-    Diagnostics->report(CurrentToken.getSourceLoc(), DiagnosticKind::Error,
-                        LineContext::WithContext)
-        << "'Set Aside' found outwith any loop nest";
+    Diagnostics->report(CurrentToken.getSourceLoc(),
+                        diag::err_set_aside_outside_loop);
     return CheffeErrorCode::CHEFFE_ERROR;
   }
 
@@ -1785,8 +2152,9 @@ CheffeErrorCode CheffeParser::parseServeMethodStep()
     getNextToken();
   }
 
-  const std::string Recipe =
-      Lexer.getTextSpan(BeginRecipeLoc.getBegin(), EndRecipeLoc.getEnd());
+  // Kept in the program's arena, so that the operand stays trivially copyable.
+  const std::string *Recipe = ProgramInfo->getArena().create<std::string>(
+      Lexer.getTextSpan(BeginRecipeLoc.getBegin(), EndRecipeLoc.getEnd()));
 
   if (expectToken(TokenKind::FullStop))
   {
@@ -1805,7 +2173,7 @@ CheffeErrorCode CheffeParser::parseRefrigerateMethodStep()
 {
   getNextToken();
 
-  unsigned NumberOfHours = 0u;
+  long long NumberOfHours = 0;
   if (CurrentToken.isNot(TokenKind::FullStop))
   {
     if (expectToken("for"))
@@ -1818,7 +2186,10 @@ CheffeErrorCode CheffeParser::parseRefrigerateMethodStep()
       return CheffeErrorCode::CHEFFE_ERROR;
     }
 
-    NumberOfHours = CurrentToken.getNumVal();
+    if (getNumberValue(NumberOfHours, std::numeric_limits<unsigned>::max()))
+    {
+      return CheffeErrorCode::CHEFFE_ERROR;
+    }
 
     getNextToken();
     if (expectToken(TokenKind::Identifier))
@@ -1827,9 +2198,9 @@ CheffeErrorCode CheffeParser::parseRefrigerateMethodStep()
     }
     if (CurrentToken.isNotAnyOf("hour", "hours"))
     {
-      Diagnostics->report(CurrentToken.getSourceLoc(), DiagnosticKind::Error,
-                          LineContext::WithContext)
-          << "Expected 'hour' or 'hours', got " << CurrentToken;
+      Diagnostics->report(CurrentToken.getSourceLoc(),
+                          diag::err_expected_hours)
+          << CurrentToken;
       return CheffeErrorCode::CHEFFE_ERROR;
     }
 
@@ -1872,7 +2243,11 @@ CheffeErrorCode CheffeParser::parseServesStatement()
   {
     return CheffeErrorCode::CHEFFE_ERROR;
   }
-  const long long ServesNo = CurrentToken.getNumVal();
+  long long ServesNo = 0;
+  if (getNumberValue(ServesNo))
+  {
+    return CheffeErrorCode::CHEFFE_ERROR;
+  }
   const SourceLocation NumberLoc = CurrentToken.getSourceLoc();
 
   if (consumeAndExpectToken(TokenKind::FullStop))
@@ -1885,9 +2260,7 @@ CheffeErrorCode CheffeParser::parseServesStatement()
   if (ServesNo < std::numeric_limits<unsigned>::min() ||
       ServesNo > std::numeric_limits<unsigned>::max())
   {
-    Diagnostics->report(NumberLoc, DiagnosticKind::Error,
-                        LineContext::WithContext)
-        << "Serves No is outwith bounds of unsigned integer";
+    Diagnostics->report(NumberLoc, diag::err_serves_out_of_range);
     return CheffeErrorCode::CHEFFE_ERROR;
   }
 
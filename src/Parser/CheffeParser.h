@@ -2,111 +2,29 @@
 #define CHEFFE_PARSER
 
 #include "cheffe.h"
+#include "Parser/CheffeKeywords.h"
 #include "Parser/CheffeScopeInfo.h"
 #include "Lexer/CheffeLexer.h"
 #include "IR/CheffeProgramInfo.h"
 #include "Utils/CheffeDiagnosticHandler.h"
+#include "Utils/CheffePhaseTimings.h"
 
-#include <map>
-#include <utility>
+#include <climits>
 #include <vector>
-#include <set>
-#include <unordered_set>
 
 namespace cheffe
 {
 
-const std::set<std::pair<std::string, std::string>> ValidTimeUnits = {
-    {"hour", "hours"}, {"minute", "minutes"}};
-
-const std::unordered_set<std::string> ValidMethodSteps = {
-    "Take",   "Put",     "Fold",    "Add",        "Remove", "Combine",
-    "Divide", "Liquefy", "Liquify", "Stir",       "Mix",    "Clean",
-    "Pour",   "Set",     "Serve",   "Refrigerate"};
-
-typedef std::pair<std::string, std::string> StringPair;
-const std::set<StringPair> ValidVerbKeywords = {{"Sift", "Sifted"},
-                                                {"Rub", "Rubbed"},
-                                                {"Melt", "Melted"},
-                                                {"Caramelise", "Caramelised"},
-                                                {"Cook", "Cooked"},
-                                                {"Chop", "Chopped"},
-                                                {"Bake", "Baked"},
-                                                {"Roast", "Roasted"},
-                                                {"Boil", "Boiled"},
-                                                {"Chill", "Chilled"},
-                                                {"Fry", "Fried"},
-                                                {"Loop", "Looped"},
-                                                {"Shake", "Shaked"},
-                                                {"Sieve", "Sieved"},
-                                                {"Squeeze", "Squeezed"},
-                                                {"Drip", "Dripped"},
-                                                {"Drop", "Dropped"},
-                                                {"Scoop", "Scooped"},
-                                                {"Coat", "Coated"},
-                                                {"Randomize", "Randomized"},
-                                                {"Toss", "Tossed"},
-                                                {"Infuse", "Infused"},
-                                                {"Watch", "Watched"},
-                                                {"Smell", "Smelled"},
-                                                {"Crush", "Crushed"},
-                                                {"Mash", "Mashed"},
-                                                {"Grind", "Ground"},
-                                                {"Finish", "Finished"},
-                                                {"Shuffle", "Shuffled"},
-                                                {"Layer", "Layered"},
-                                                {"Prepare", "Prepared"},
-                                                {"Separate", "Separated"},
-                                                {"Sprinkle", "Sprinkled"},
-                                                {"Move", "Moved"},
-                                                {"Recite", "Recited"},
-                                                {"Repeat", "Repeated"},
-                                                {"Siphon", "Siphoned"},
-                                                {"Gulp", "Gulped"},
-                                                {"Quote", "Quoted"},
-                                                {"Part", "Parted"},
-                                                {"Dissolve", "Dissolved"},
-                                                {"Agitate", "Agitated"},
-                                                {"Cool", "Cooled"},
-                                                {"Leave", "Left"},
-                                                {"Wash", "Washed"},
-                                                {"Water", "Watered"},
-                                                {"Heat", "Heated"}};
-
-const std::unordered_set<std::string> ValidMeasureTypes = {"heaped", "level"};
-
-const std::unordered_set<std::string> ValidDryMeasures = {"g", "kg", "pinch",
-                                                          "pinches"};
-
-const std::unordered_set<std::string> ValidWetMeasures = {"ml", "l", "dash",
-                                                          "dashes"};
-
-const std::unordered_set<std::string> ValidUnspecifiedMeasures = {
-    "cup", "cups", "teaspoon", "teaspoons", "tablespoon", "tablespoons"};
-
-enum class MeasureKindTy
-{
-  Dry,
-  Wet,
-  Unspecified,
-  Invalid
-};
-
-const std::map<MethodStepKind, std::string> MethodStepPrepositions = {
-    {MethodStepKind::Add, "to"},
-    {MethodStepKind::Remove, "from"},
-    {MethodStepKind::Combine, "into"},
-    {MethodStepKind::Divide, "into"},
-};
-
 class CheffeParserOptions
 {
   friend class CheffeParser;
 
 public:
-  CheffeParserOptions()
+  CheffeParserOptions() : ParseThreads(1)
   {
     StrictChef = false;
+    LazyParsing = false;
+    VerifyAll = false;
   }
 
   void setStrictChef(const bool Switch)
@@ -114,8 +32,43 @@ public:
     StrictChef = Switch;
   }
 
+  // The number of threads to parse recipes on. One, the default, parses
+  // sequentially.
+  void setParseThreads(const unsigned Threads)
+  {
+    ParseThreads = Threads;
+  }
+
+  // Only index each recipe's title up front, leaving the rest of it to be
+  // parsed when the program first serves it. A program whose titles can't all
+  // be found that way is parsed in full up front instead.
+  void setLazyParsing(const bool Switch)
+  {
+    LazyParsing = Switch;
+  }
+
+  bool getLazyParsing() const
+  {
+    return LazyParsing;
+  }
+
+  // When parsing lazily, still parse every recipe before the program runs,
+  // so that errors in recipes that wouldn't be served are reported too.
+  void setVerifyAll(const bool Switch)
+  {
+    VerifyAll = Switch;
+  }
+
+  bool getVerifyAll() const
+  {
+    return VerifyAll;
+  }
+
 private:
   unsigned StrictChef : 1;
+  unsigned LazyParsing : 1;
+  unsigned VerifyAll : 1;
+  unsigned ParseThreads;
 };
 
 class CheffeParser
@@ -123,7 +76,8 @@ class CheffeParser
 public:
   CheffeParser()
       : Lexer(), CurrentToken(), Diagnostics(nullptr), CurrentRecipe(nullptr),
-        ProgramInfo(new CheffeProgramInfo()), Options(new CheffeParserOptions())
+        ProgramInfo(new CheffeProgramInfo()),
+        Options(new CheffeParserOptions()), Timings(nullptr)
   {
   }
 
@@ -136,23 +90,58 @@ public:
   std::unique_ptr<CheffeProgramInfo> takeProgramInfo();
 
   std::shared_ptr<CheffeParserOptions> getOptions() const;
+  void setOptions(std::shared_ptr<CheffeParserOptions> Opts);
+
+  // Records the time spent lexing, parsing and fixing up the scopes of each
+  // recipe into Timings, which must outlive the parse, or stops if it's null.
+  void setPhaseTimings(CheffePhaseTimings *PhaseTimings)
+  {
+    Timings = PhaseTimings;
+  }
+
+  // Parses the single recipe in Range of the source file into this parser's
+  // program. Anything left in the range after the recipe is an error. On
+  // failure, Recipe is left with as much of the recipe as was parsed, or
+  // nullptr if not even its title could be.
+  CheffeErrorCode parseRecipeInRange(const SourceLocation Range,
+                                     CheffeRecipeInfo *&Recipe);
 
   static bool isValidOrdinalIdentifier(const unsigned Number,
                                        const std::string &Sequence);
 
+  // Splits a program's source into the ranges of its recipes, going only by
+  // the text: a recipe starts at the paragraph after a Method paragraph and
+  // the optional Serves statement that follows it. Only a Method paragraph
+  // after an Ingredients paragraph counts, as a comment can start with
+  // 'Method.' too. This is only a guess, so each range still has to be checked
+  // by parsing it.
+  static std::vector<SourceLocation> findRecipeRanges(const StringRef Source);
+
 private:
   CheffeLexer Lexer;
   Token CurrentToken;
 
   std::shared_ptr<CheffeDiagnosticHandler> Diagnostics;
 
-  std::shared_ptr<CheffeRecipeInfo> CurrentRecipe;
+  CheffeRecipeInfo *CurrentRecipe;
   std::unique_ptr<CheffeProgramInfo> ProgramInfo;
 
   std::shared_ptr<CheffeParserOptions> Options;
 
   CheffeScopeInfo RecipeScopeInfo;
 
+  CheffePhaseTimings *Timings;
+  // The time the recipe being parsed spent having its scopes fixed up.
+  CheffeTimes ScopeFixupTimes;
+
+  unsigned getNumParseThreads() const;
+  CheffeErrorCode indexProgram();
+  CheffeErrorCode parseRecipe();
+  CheffeErrorCode parseRecipeContents();
+  CheffeErrorCode
+  parseRecipesInParallel(const std::vector<SourceLocation> &RecipeRanges,
+                         const unsigned NumThreads, std::size_t &NumKept);
+
   CheffeErrorCode parseRecipeTitle(std::string &RecipeTitle,
                                    SourceLocation &RecipeTitleLoc);
   CheffeErrorCode parseCommentBlock();
@@ -183,8 +172,7 @@ private:
                          const SourceLocation IngredientLoc,
                          CheffeIngredient **Ingredient);
 
-  bool isValidTimeUnit(const std::string &TimeUnit, StringPair &MatchingPair);
-  bool isValidMeasure(const std::string &Measure, MeasureKindTy &Kind);
+  static const char *getMethodStepPreposition(const MethodStepKind Step);
 
   bool checkCurrentTokenPlurality(const long long Number,
                                   const std::string &Singular,
@@ -193,6 +181,11 @@ private:
 
   bool checkNonStandardTokenAndConsume(const std::string &Str);
 
+  // Decodes the current number token into Value. Return true if it was larger
+  // than MaxValue, false otherwise.
+  bool getNumberValue(long long &Value,
+                      const long long MaxValue = LLONG_MAX);
+
   Token getNextToken();
 
   // Return true if token didn't match, false otherwise.
@@ -67,52 +67,46 @@ bool CheffeScopeInfo::addBreak(CheffeMethodStep *MethodStep)
 //   beginning of the scope
 // * Each Set Aside method scope in the nest get an offset to the end of the
 //   scope.
+// Every method step knows its own index, so the offsets are plain
+// differences and each scope and break is visited exactly once.
 CheffeErrorCode CheffeScopeInfo::fixupScopeMethodSteps(
-    const std::vector<CheffeMethodStep *> &MethodList)
+    const CheffeRecipeInfo::MethodStepListTy &MethodSteps)
 {
+  // Returns true if MethodStep isn't one of this recipe's method steps.
+  auto IsForeignMethodStep = [&MethodSteps](const CheffeMethodStep *MethodStep)
+  {
+    return !MethodStep || MethodStep->getIndex() >= MethodSteps.size() ||
+           MethodSteps[MethodStep->getIndex()] != MethodStep;
+  };
+
   for (auto &Scope : ScopeList)
   {
     if (!Scope)
     {
       return CheffeErrorCode::CHEFFE_ERROR;
     }
-    if (!Scope->BeginScope || !Scope->EndScope)
-    {
-      return CheffeErrorCode::CHEFFE_ERROR;
-    }
     auto *BeginScopeMethodStep = Scope->BeginScope;
-
-    auto BeginFound = std::find(std::begin(MethodList), std::end(MethodList),
-                                BeginScopeMethodStep);
-    if (BeginFound == std::end(MethodList))
-    {
-      return CheffeErrorCode::CHEFFE_ERROR;
-    }
-
     auto *EndScopeMethodStep = Scope->EndScope;
-    auto EndFound = std::find(std::begin(MethodList), std::end(MethodList),
-                              EndScopeMethodStep);
-    if (EndFound == std::end(MethodList))
+    if (IsForeignMethodStep(BeginScopeMethodStep) ||
+        IsForeignMethodStep(EndScopeMethodStep))
     {
       return CheffeErrorCode::CHEFFE_ERROR;
     }
 
-    const auto BeginningToEnd = std::distance(BeginFound, EndFound);
+    const long long EndIndex = EndScopeMethodStep->getIndex();
+    const long long BeginningToEnd =
+        EndIndex - BeginScopeMethodStep->getIndex();
 
     BeginScopeMethodStep->addNumber(BeginningToEnd);
     EndScopeMethodStep->addNumber(-BeginningToEnd);
 
     for (auto &Break : Scope->BreakList)
     {
-      auto BreakFound =
-          std::find(std::begin(MethodList), std::end(MethodList), Break);
-      if (BreakFound == std::end(MethodList))
+      if (IsForeignMethodStep(Break))
       {
         return CheffeErrorCode::CHEFFE_ERROR;
       }
-      const auto BreakToEnd = std::distance(BreakFound, EndFound);
-
-      Break->addNumber(BreakToEnd);
+      Break->addNumber(EndIndex - Break->getIndex());
     }
   }
   return CheffeErrorCode::CHEFFE_SUCCESS;
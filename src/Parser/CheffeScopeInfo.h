@@ -3,6 +3,7 @@
 
 #include "cheffe.h"
 #include "IR/CheffeMethodStep.h"
+#include "IR/CheffeRecipeInfo.h"
 
 #include <memory>
 #include <vector>
@@ -48,7 +49,7 @@ public:
   bool addBreak(CheffeMethodStep *MethodStep);
 
   CheffeErrorCode
-  fixupScopeMethodSteps(const std::vector<CheffeMethodStep *> &MethodList);
+  fixupScopeMethodSteps(const CheffeRecipeInfo::MethodStepListTy &MethodSteps);
 
   void dumpInfo(std::ostream &OS) const;
 
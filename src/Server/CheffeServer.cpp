@@ -0,0 +1,247 @@
+#include "Server/CheffeServer.h"
+#include "Utils/CheffeFileHandler.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+
+namespace cheffe
+{
+
+CheffeErrorCode CheffeServer::run()
+{
+  std::string Line;
+  while (std::getline(In, Line))
+  {
+    if (Line.empty())
+    {
+      continue;
+    }
+    if (!handleRequest(Line))
+    {
+      break;
+    }
+  }
+  return CheffeErrorCode::CHEFFE_SUCCESS;
+}
+
+// Reads a byte offset or length out of the request's parameters.
+static bool getSizeParam(const JSONValue &Params, const char *Name,
+                         std::size_t &Size, std::string &Error)
+{
+  const JSONValue *Value = Params.get(Name);
+  if (!Value || Value->getKind() != JSONValue::Kind::Number ||
+      Value->getNumber() < 0 || Value->getNumber() > UINT32_MAX ||
+      Value->getNumber() != std::floor(Value->getNumber()))
+  {
+    Error = std::string("expected a byte count for '") + Name + "'";
+    return false;
+  }
+  Size = static_cast<std::size_t>(Value->getNumber());
+  return true;
+}
+
+bool CheffeServer::handleRequest(const std::string &Line)
+{
+  JSONValue Request;
+  std::string Error;
+  if (!JSONValue::parse(Line, Request, Error))
+  {
+    writeError(nullptr, "invalid request: " + Error);
+    return true;
+  }
+
+  const JSONValue *ID = Request.get("id");
+  const JSONValue *Method = Request.get("method");
+  if (!Method || Method->getKind() != JSONValue::Kind::String)
+  {
+    writeError(ID, "request has no method");
+    return true;
+  }
+
+  static const JSONValue NoParams;
+  const JSONValue *Params = Request.get("params");
+  if (!Params)
+  {
+    Params = &NoParams;
+  }
+
+  const auto Start = std::chrono::steady_clock::now();
+  bool Handled = false;
+  if (Method->getString() == "open")
+  {
+    Handled = handleOpen(*Params, Error);
+  }
+  else if (Method->getString() == "change")
+  {
+    Handled = handleChange(*Params, Error);
+  }
+  else if (Method->getString() == "shutdown")
+  {
+    JSONWriter Writer(Out);
+    Writer.objectBegin();
+    writeID(Writer, ID);
+    Writer.attribute("result");
+    Writer.nullValue();
+    Writer.objectEnd();
+    Out << std::endl;
+    return false;
+  }
+  else
+  {
+    Error = "unknown method '" + Method->getString() + "'";
+  }
+
+  if (!Handled)
+  {
+    writeError(ID, Error);
+    return true;
+  }
+
+  const auto Elapsed = std::chrono::steady_clock::now() - Start;
+  writeDiagnostics(
+      ID, std::chrono::duration_cast<std::chrono::microseconds>(Elapsed)
+              .count());
+  return true;
+}
+
+bool CheffeServer::handleOpen(const JSONValue &Params, std::string &Error)
+{
+  const JSONValue *Name = Params.get("name");
+  const JSONValue *Path = Params.get("path");
+  const JSONValue *Text = Params.get("text");
+
+  if (Path && Path->getKind() == JSONValue::Kind::String)
+  {
+    CheffeSourceFile File;
+    if (CheffeFileHandler::readFile(Path->getString(), File) !=
+        CheffeErrorCode::CHEFFE_SUCCESS)
+    {
+      Error = "could not read '" + Path->getString() + "'";
+      return false;
+    }
+    Driver.openDocument(Path->getString(), File.getSource().str());
+    IsOpen = true;
+    return true;
+  }
+
+  if (!Text || Text->getKind() != JSONValue::Kind::String)
+  {
+    Error = "expected a 'text' or 'path' to open";
+    return false;
+  }
+
+  const bool HasName = Name && Name->getKind() == JSONValue::Kind::String;
+  Driver.openDocument(HasName ? Name->getString() : "<stdin>",
+                      Text->getString());
+  IsOpen = true;
+  return true;
+}
+
+bool CheffeServer::handleChange(const JSONValue &Params, std::string &Error)
+{
+  if (!IsOpen)
+  {
+    Error = "no document is open";
+    return false;
+  }
+
+  std::size_t Offset = 0;
+  std::size_t Length = 0;
+  if (!getSizeParam(Params, "offset", Offset, Error) ||
+      !getSizeParam(Params, "length", Length, Error))
+  {
+    return false;
+  }
+
+  const JSONValue *Text = Params.get("text");
+  if (!Text || Text->getKind() != JSONValue::Kind::String)
+  {
+    Error = "expected the 'text' to insert";
+    return false;
+  }
+
+  if (Driver.applyEdit(Offset, Length, Text->getString()) !=
+      CheffeErrorCode::CHEFFE_SUCCESS)
+  {
+    Error = "edit is outwith the document";
+    return false;
+  }
+  return true;
+}
+
+void CheffeServer::writeID(JSONWriter &Writer, const JSONValue *ID)
+{
+  Writer.attribute("id");
+  if (ID && ID->getKind() == JSONValue::Kind::Number)
+  {
+    Writer.value(ID->getNumber());
+  }
+  else if (ID && ID->getKind() == JSONValue::Kind::String)
+  {
+    Writer.value(ID->getString());
+  }
+  else
+  {
+    Writer.nullValue();
+  }
+}
+
+void CheffeServer::writeError(const JSONValue *ID, const std::string &Error)
+{
+  JSONWriter Writer(Out);
+  Writer.objectBegin();
+  writeID(Writer, ID);
+  Writer.attribute("error");
+  Writer.value(Error);
+  Writer.objectEnd();
+  Out << std::endl;
+}
+
+void CheffeServer::writeDiagnostics(const JSONValue *ID,
+                                    const long long Microseconds)
+{
+  const CheffeSourceFile &File = Driver.getSourceFile();
+
+  JSONWriter Writer(Out);
+  Writer.objectBegin();
+  writeID(Writer, ID);
+  Writer.attribute("result");
+  Writer.objectBegin();
+  Writer.attribute("diagnostics");
+  Writer.arrayBegin();
+  for (const CheffeDiagnostic &Diagnostic : Driver.getDiagnostics())
+  {
+    const std::size_t Offset = Diagnostic.SourceLoc.getBegin();
+    Writer.objectBegin();
+    Writer.attribute("severity");
+    Writer.value(CheffeDiagnosticHandler::getDiagnosticKind(Diagnostic.ID) ==
+                         DiagnosticKind::Error
+                     ? "error"
+                     : "warning");
+    Writer.attribute("message");
+    Writer.value(CheffeDiagnosticHandler::getDiagnosticMessage(Diagnostic));
+    Writer.attribute("line");
+    Writer.value(File.getLineNumber(Offset));
+    Writer.attribute("column");
+    Writer.value(File.getColumnNumber(Offset));
+    Writer.attribute("offset");
+    Writer.value(Offset);
+    Writer.attribute("length");
+    Writer.value(Diagnostic.SourceLoc.getLength());
+    Writer.objectEnd();
+  }
+  Writer.arrayEnd();
+  Writer.attribute("recipes");
+  Writer.value(Driver.getNumRecipeRanges());
+  Writer.attribute("reparsed");
+  Writer.value(Driver.getNumRecipesParsed());
+  Writer.attribute("microseconds");
+  Writer.value(Microseconds);
+  Writer.objectEnd();
+  Writer.objectEnd();
+  Out << std::endl;
+}
+
+} // end namespace cheffe
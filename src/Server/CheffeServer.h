@@ -0,0 +1,63 @@
+#ifndef CHEFFE_SERVER
+#define CHEFFE_SERVER
+
+#include "cheffe.h"
+#include "Driver/CheffeIncrementalDriver.h"
+#include "Utils/CheffeJSON.h"
+
+#include <iosfwd>
+#include <string>
+
+namespace cheffe
+{
+
+// A request loop for editors, in the style of a language server: it reads one
+// JSON request per line and writes one JSON response per line. Requests are
+//   {"id": 1, "method": "open", "params": {"name": "a.ch", "text": "..."}}
+//   {"id": 2, "method": "change",
+//    "params": {"offset": 10, "length": 2, "text": "..."}}
+//   {"id": 3, "method": "shutdown"}
+// where "open" may be given a "path" to read instead of the text itself, and
+// "change" replaces "length" bytes at byte "offset" with "text". Both answer
+// with the diagnostics for the whole document:
+//   {"id": 1, "result": {"diagnostics": [{"severity": "error",
+//    "message": "...", "line": 3, "column": 1, "offset": 20, "length": 4}],
+//    "recipes": 12, "reparsed": 1, "microseconds": 250}}
+// A request that can't be carried out is answered with
+//   {"id": 1, "error": "..."}
+// and the loop carries on until it reads "shutdown" or runs out of input.
+class CheffeServer
+{
+public:
+  CheffeServer(std::istream &In, std::ostream &Out)
+      : In(In), Out(Out), IsOpen(false)
+  {
+  }
+
+  CheffeErrorCode run();
+
+  CheffeIncrementalDriver &getDriver()
+  {
+    return Driver;
+  }
+
+private:
+  std::istream &In;
+  std::ostream &Out;
+  CheffeIncrementalDriver Driver;
+  bool IsOpen;
+
+  // Returns false once the loop should stop.
+  bool handleRequest(const std::string &Line);
+
+  bool handleOpen(const JSONValue &Params, std::string &Error);
+  bool handleChange(const JSONValue &Params, std::string &Error);
+
+  void writeError(const JSONValue *ID, const std::string &Error);
+  void writeDiagnostics(const JSONValue *ID, const long long Microseconds);
+  void writeID(JSONWriter &Writer, const JSONValue *ID);
+};
+
+} // end namespace cheffe
+
+#endif // CHEFFE_SERVER
@@ -1,7 +1,7 @@
 #include "CheffeDiagnosticHandler.h"
 
 #include <cassert>
-#include <map>
+#include <sstream>
 
 #if !defined(_WIN32) && !defined(__WIN64) && defined(__unix__) ||              \
     (defined(__APPLE__) && defined(__MACH__))
@@ -25,22 +25,56 @@ std::ostream &CheffeDiagnosticHandler::errs()
   return std::cerr;
 }
 
+namespace
+{
+
+struct DiagnosticInfo
+{
+  DiagnosticKind Kind;
+  LineContext Context;
+  const char *Format;
+};
+
+const DiagnosticInfo DiagnosticInfos[] = {
+#define DIAG(ID, KIND, CONTEXT, FORMAT)                                        \
+  {DiagnosticKind::KIND, LineContext::CONTEXT, FORMAT},
+#include "Utils/CheffeDiagnosticKinds.def"
+};
+
+static_assert(sizeof(DiagnosticInfos) / sizeof(DiagnosticInfos[0]) ==
+                  diag::NUM_DIAGNOSTICS,
+              "Every diagnostic needs an entry");
+
+} // end anonymous namespace
+
 // A conservative method to determine whether to emit colour diagnostics:
 // * if it's a unix system
 // * if stderr is a TTY
 // * if $TERM is an xterm
-static bool shouldUseColour()
+static bool computeShouldUseColour()
 {
-#ifndef CHEFFE_POSIX
+#if !CHEFFE_POSIX
   // Be conversative: don't support colour
   return false;
-#endif
+#else
   const char *const TermVar = std::getenv("TERM");
+  if (!TermVar)
+  {
+    return false;
+  }
   const bool TerminalSupportsColour = !std::strcmp(TermVar, "xterm") ||
                                       !std::strcmp(TermVar, "xterm-color") ||
                                       !std::strcmp(TermVar, "xterm-256color");
   const bool IsATTY = isatty(fileno(stderr)) != 0;
   return IsATTY && TerminalSupportsColour;
+#endif
+}
+
+// The environment is only consulted once per run.
+static bool shouldUseColour()
+{
+  static const bool UseColour = computeShouldUseColour();
+  return UseColour;
 }
 
 enum class ColourKind
@@ -50,122 +84,190 @@ enum class ColourKind
   MagentaBold
 };
 
-const std::map<ColourKind, std::string> ColourCodes = {
-    {ColourKind::RedBold, "\x1b[31;1m"},
-    {ColourKind::YellowBold, "\x1b[33;1m"},
-    {ColourKind::MagentaBold, "\x1b[35;1m"}};
+static const char *getColourCode(const ColourKind Colour)
+{
+  switch (Colour)
+  {
+  case ColourKind::RedBold:
+    return "\x1b[31;1m";
+  case ColourKind::YellowBold:
+    return "\x1b[33;1m";
+  case ColourKind::MagentaBold:
+    return "\x1b[35;1m";
+  }
+  cheffe_unreachable("Invalid Colour Code");
+  return "";
+}
 
 struct ColourText
 {
 public:
   ColourText(const std::string &Message, const ColourKind Colour)
-      : Message(Message)
+      : Message(Message), Colour(Colour)
   {
-    assert(ColourCodes.find(Colour) != std::end(ColourCodes) &&
-           "Invalid Colour Code");
-    ColourOn = shouldUseColour() ? ColourCodes.find(Colour)->second : "";
-    ColourOff = shouldUseColour() ? "\x1b[0m" : "";
   }
 
 private:
   const std::string &Message;
-  std::string ColourOn;
-  std::string ColourOff;
+  ColourKind Colour;
 
   friend std::ostream &operator<<(std::ostream &OS, const ColourText &Text)
   {
-    OS << Text.ColourOn << Text.Message << Text.ColourOff;
-    return OS;
+    if (!shouldUseColour())
+    {
+      return OS << Text.Message;
+    }
+    return OS << getColourCode(Text.Colour) << Text.Message << "\x1b[0m";
   }
 };
 
-void CheffeDiagnosticHandler::formatAndLogMessage(
-    const std::string &Message, const SourceLocation SourceLoc,
-    const DiagnosticKind Kind, const LineContext Context)
+DiagnosticKind CheffeDiagnosticHandler::getDiagnosticKind(const diag::DiagID ID)
 {
-  std::stringstream ss;
-  ss << getFileAndLineNumberInfoAsString(SourceLoc.getLineNo(),
-                                         SourceLoc.getColumnNo()) << ": ";
-  if (Kind == DiagnosticKind::Error)
+  assert(ID < diag::NUM_DIAGNOSTICS && "Invalid diagnostic");
+  return DiagnosticInfos[ID].Kind;
+}
+
+LineContext CheffeDiagnosticHandler::getLineContext(const diag::DiagID ID)
+{
+  assert(ID < diag::NUM_DIAGNOSTICS && "Invalid diagnostic");
+  return DiagnosticInfos[ID].Context;
+}
+
+const char *CheffeDiagnosticHandler::getDiagnosticFormat(const diag::DiagID ID)
+{
+  assert(ID < diag::NUM_DIAGNOSTICS && "Invalid diagnostic");
+  return DiagnosticInfos[ID].Format;
+}
+
+// Fills the diagnostic's arguments into its message.
+static std::string formatMessage(const char *Format,
+                                 const std::vector<std::string> &Args)
+{
+  std::string Message;
+  for (const char *Ptr = Format; *Ptr; ++Ptr)
   {
-    ss << ColourText("error", ColourKind::RedBold) << ": ";
+    if (Ptr[0] == '%' && Ptr[1] >= '0' && Ptr[1] <= '9')
+    {
+      const unsigned ArgNo = *++Ptr - '0';
+      assert(ArgNo < Args.size() && "Too few arguments for diagnostic");
+      if (ArgNo < Args.size())
+      {
+        Message += Args[ArgNo];
+      }
+      continue;
+    }
+    Message += *Ptr;
   }
-  else if (Kind == DiagnosticKind::Warning)
+  return Message;
+}
+
+std::string CheffeDiagnosticHandler::getDiagnosticMessage(
+    const CheffeDiagnostic &Diagnostic)
+{
+  return formatMessage(getDiagnosticFormat(Diagnostic.ID), Diagnostic.Args);
+}
+
+std::string
+CheffeDiagnosticHandler::formatDiagnostic(const CheffeDiagnostic &Diagnostic)
+{
+  const SourceLocation SourceLoc = Diagnostic.SourceLoc;
+  std::stringstream ss;
+  ss << getFileAndLineNumberInfoAsString(
+            File.getLineNumber(SourceLoc.getBegin()),
+            File.getColumnNumber(SourceLoc.getBegin())) << ": ";
+  switch (getDiagnosticKind(Diagnostic.ID))
   {
+  case DiagnosticKind::Error:
+    ss << ColourText("error", ColourKind::RedBold) << ": ";
+    break;
+  case DiagnosticKind::Warning:
     ss << ColourText("warning", ColourKind::YellowBold) << ": ";
+    break;
   }
-  ss << Message << std::endl;
-  if (Context == LineContext::WithContext)
+  ss << formatMessage(getDiagnosticFormat(Diagnostic.ID), Diagnostic.Args)
+     << std::endl;
+  if (getLineContext(Diagnostic.ID) == LineContext::WithContext)
   {
     ss << getLineAsString(SourceLoc) << std::endl;
     ss << ColourText(getContextAsString(SourceLoc), ColourKind::MagentaBold)
        << std::endl;
   }
-
-  switch (Kind)
-  {
-  default:
-    cheffe_unreachable("Impossible enum value");
-    break;
-  case DiagnosticKind::Error:
-    Errors.push_back(ss.str());
-    break;
-  case DiagnosticKind::Warning:
-    Warnings.push_back(ss.str());
-    break;
-  }
+  return ss.str();
 }
 
 void CheffeDiagnosticHandler::flushDiagnostics()
 {
-  for (auto &Message : Warnings)
+  for (const DiagnosticKind Kind :
+       {DiagnosticKind::Warning, DiagnosticKind::Error})
   {
-    errs() << Message << std::endl;
+    for (auto &Diagnostic : Diagnostics)
+    {
+      if (getDiagnosticKind(Diagnostic.ID) == Kind)
+      {
+        errs() << formatDiagnostic(Diagnostic) << std::endl;
+      }
+    }
   }
-  Warnings.clear();
-  for (auto &Message : Errors)
+
+  const std::size_t Dropped = ErrorCount + WarningCount - Diagnostics.size();
+  if (DiagnosticLimit && Dropped)
   {
-    errs() << Message << std::endl;
+    errs() << Dropped << " more diagnostics not shown" << std::endl;
   }
-  Errors.clear();
+
+  Diagnostics.clear();
+  ErrorCount = 0;
+  WarningCount = 0;
 }
 
 unsigned CheffeDiagnosticHandler::getErrorCount() const
 {
-  return Errors.size();
+  return ErrorCount;
 }
 
 unsigned CheffeDiagnosticHandler::getWarningCount() const
 {
-  return Warnings.size();
+  return WarningCount;
 }
 
-std::string
-CheffeDiagnosticHandler::getLineAsString(const SourceLocation SourceLoc)
+void CheffeDiagnosticHandler::setDiagnosticLimit(const unsigned Limit)
+{
+  DiagnosticLimit = Limit;
+}
+
+const std::vector<CheffeDiagnostic> &
+CheffeDiagnosticHandler::getDiagnostics() const
 {
-  assert(SourceLoc.getLineNo() != 0 && "Lines must be indexed from 1");
-  unsigned LineCount = 1;
-  std::size_t FilePos = 0;
-  const std::size_t LineNo = SourceLoc.getLineNo();
-  for (; FilePos < File.Source.size() && LineCount != LineNo; ++FilePos)
+  return Diagnostics;
+}
+
+void CheffeDiagnosticHandler::mergeDiagnostics(
+    const CheffeDiagnosticHandler &Other)
+{
+  ErrorCount += Other.ErrorCount;
+  WarningCount += Other.WarningCount;
+
+  for (const CheffeDiagnostic &Diagnostic : Other.Diagnostics)
   {
-    if (File.Source[FilePos] == '\n')
+    if (DiagnosticLimit && Diagnostics.size() >= DiagnosticLimit)
     {
-      LineCount++;
+      break;
     }
+    Diagnostics.push_back(Diagnostic);
   }
+}
 
-  const std::string Line =
-      File.Source.substr(FilePos, File.Source.find('\n', FilePos) - FilePos);
-
-  return Line;
+std::string
+CheffeDiagnosticHandler::getLineAsString(const SourceLocation SourceLoc)
+{
+  return File.getLine(File.getLineNumber(SourceLoc.getBegin())).str();
 }
 
 std::string
 CheffeDiagnosticHandler::getContextAsString(const SourceLocation SourceLoc)
 {
-  assert(SourceLoc.getColumnNo() != 0 && "Columns must be indexed from 1");
-  const std::string Padding = std::string(SourceLoc.getColumnNo() - 1, ' ');
+  const unsigned ColumnNo = File.getColumnNumber(SourceLoc.getBegin());
+  const std::string Padding = std::string(ColumnNo - 1, ' ');
   const std::string UnderlineToken = std::string(SourceLoc.getLength(), '~');
 
   std::stringstream ss;
@@ -177,7 +279,7 @@ std::string CheffeDiagnosticHandler::getFileAndLineNumberInfoAsString(
     const unsigned LineNo, const unsigned ColumnNo)
 {
   std::stringstream ss;
-  ss << File.Name << ":" << LineNo << ":" << ColumnNo;
+  ss << File.getName() << ":" << LineNo << ":" << ColumnNo;
   return ss.str();
 }
 
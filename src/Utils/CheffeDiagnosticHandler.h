@@ -5,7 +5,7 @@
 #include "Utils/CheffeFileHandler.h"
 #include "Utils/CheffeErrorHandling.h"
 #include <iostream>
-#include <sstream>
+#include <string>
 #include <vector>
 
 namespace cheffe
@@ -23,41 +23,87 @@ enum class LineContext
   WithoutContext
 };
 
+namespace diag
+{
+enum DiagID : unsigned
+{
+#define DIAG(ID, KIND, CONTEXT, FORMAT) ID,
+#include "Utils/CheffeDiagnosticKinds.def"
+  NUM_DIAGNOSTICS
+};
+} // end namespace diag
+
+// A diagnostic as reported: which message it is, where, and the arguments to
+// fill into the message. Nothing is formatted until the diagnostics are
+// flushed, so reporting one is cheap.
+struct CheffeDiagnostic
+{
+  CheffeDiagnostic(const diag::DiagID ID, const SourceLocation SourceLoc)
+      : ID(ID), SourceLoc(SourceLoc), Args()
+  {
+  }
+
+  diag::DiagID ID;
+  SourceLocation SourceLoc;
+  std::vector<std::string> Args;
+};
+
 class CheffeDiagnosticBuilder;
 
 class CheffeDiagnosticHandler
 {
+  friend class CheffeDiagnosticBuilder;
+
 private:
   CheffeSourceFile File;
 
   std::ostream &errs();
 
-  std::vector<std::string> Errors;
-  std::vector<std::string> Warnings;
+  std::vector<CheffeDiagnostic> Diagnostics;
+  unsigned ErrorCount;
+  unsigned WarningCount;
+  unsigned DiagnosticLimit;
 
 public:
   CheffeDiagnosticHandler()
+      : ErrorCount(0), WarningCount(0), DiagnosticLimit(0)
   {
   }
 
-  void formatAndLogMessage(const std::string &Message,
-                           const SourceLocation SourceLoc,
-                           const DiagnosticKind Kind,
-                           const LineContext Context);
+  static DiagnosticKind getDiagnosticKind(const diag::DiagID ID);
+  static LineContext getLineContext(const diag::DiagID ID);
+  static const char *getDiagnosticFormat(const diag::DiagID ID);
 
+  // The diagnostic's message with its arguments filled in, but without the
+  // location or source line that flushing adds.
+  static std::string getDiagnosticMessage(const CheffeDiagnostic &Diagnostic);
+
+  // Formats and prints every recorded diagnostic, warnings first.
   void flushDiagnostics();
 
+  // Every diagnostic reported is counted, even those not kept.
   unsigned getErrorCount() const;
   unsigned getWarningCount() const;
 
+  // Stops keeping diagnostics once this many have been recorded, so that
+  // nothing is spent on ones that will never be shown. Zero means no limit.
+  void setDiagnosticLimit(const unsigned Limit);
+
+  // The diagnostics recorded so far, in the order they were reported.
+  const std::vector<CheffeDiagnostic> &getDiagnostics() const;
+
+  // Reports everything Other has recorded, after what's been reported here.
+  void mergeDiagnostics(const CheffeDiagnosticHandler &Other);
+
   void setSourceFile(const CheffeSourceFile &SrcFile)
   {
     File = SrcFile;
   }
 
   inline CheffeDiagnosticBuilder report(const SourceLocation SourceLoc,
-                                        const DiagnosticKind Kind,
-                                        const LineContext Context);
+                                        const diag::DiagID ID);
+
+  std::string formatDiagnostic(const CheffeDiagnostic &Diagnostic);
 
   std::string getLineAsString(const SourceLocation SourceLoc);
   std::string getContextAsString(const SourceLocation SourceLoc);
@@ -65,64 +111,96 @@ public:
                                                const unsigned ColumnNo);
 };
 
+// Streams arguments into a diagnostic that has just been reported. If the
+// diagnostic wasn't kept, the arguments are dropped.
 class CheffeDiagnosticBuilder
 {
 private:
-  CheffeDiagnosticHandler *Handler;
-  SourceLocation SourceLoc;
-  DiagnosticKind Kind;
-  LineContext Context;
-  std::stringstream MessageStream;
+  CheffeDiagnostic *Diagnostic;
 
 public:
-  CheffeDiagnosticBuilder(CheffeDiagnosticHandler *Diags,
-                          const SourceLocation SourceLoc,
-                          const DiagnosticKind Kind, const LineContext Context)
-      : Handler(Diags), SourceLoc(SourceLoc), Kind(Kind), Context(Context),
-        MessageStream()
-  {
-  }
-
-  CheffeDiagnosticBuilder(const CheffeDiagnosticBuilder &Builder)
-  {
-    Handler = Builder.Handler;
-    SourceLoc = Builder.SourceLoc;
-    Kind = Builder.Kind;
-    Context = Builder.Context;
-    MessageStream << Builder.MessageStream.rdbuf();
-  }
-
-  ~CheffeDiagnosticBuilder()
+  CheffeDiagnosticBuilder(CheffeDiagnostic *Diagnostic)
+      : Diagnostic(Diagnostic)
   {
-    const std::string Message = MessageStream.str();
-    Handler->formatAndLogMessage(Message, SourceLoc, Kind, Context);
   }
 
-  inline CheffeDiagnosticBuilder &operator<<(const char *Str)
+  inline CheffeDiagnosticBuilder &operator<<(const StringRef Str)
   {
-    MessageStream << Str;
+    if (Diagnostic)
+    {
+      Diagnostic->Args.push_back(Str.str());
+    }
     return *this;
   }
 
-  inline CheffeDiagnosticBuilder &operator<<(std::string Str)
+  // A kind of token that was expected, rather than one that was found.
+  inline CheffeDiagnosticBuilder &operator<<(const TokenKind Kind)
   {
-    MessageStream << Str;
+    if (!Diagnostic)
+    {
+      return *this;
+    }
+    switch (Kind)
+    {
+    case TokenKind::Identifier:
+      Diagnostic->Args.push_back("identifier");
+      break;
+    case TokenKind::Number:
+      Diagnostic->Args.push_back("number");
+      break;
+    default:
+      Diagnostic->Args.push_back(TokenKindToString(Kind));
+      break;
+    }
     return *this;
   }
 
-  inline CheffeDiagnosticBuilder &operator<<(Token Tok)
+  inline CheffeDiagnosticBuilder &operator<<(const Token &Tok)
   {
-    MessageStream << Tok;
+    if (!Diagnostic)
+    {
+      return *this;
+    }
+    if (Tok.is(TokenKind::Identifier) && !Tok.getText().empty())
+    {
+      Diagnostic->Args.push_back(Tok.getIdentifierString());
+    }
+    else if (Tok.is(TokenKind::Identifier))
+    {
+      Diagnostic->Args.push_back("identifier");
+    }
+    else if (Tok.is(TokenKind::Number))
+    {
+      Diagnostic->Args.push_back(Tok.getText().str());
+    }
+    else
+    {
+      Diagnostic->Args.push_back(TokenKindToString(Tok.getKind()));
+    }
     return *this;
   }
 };
 
 inline CheffeDiagnosticBuilder
 CheffeDiagnosticHandler::report(const SourceLocation SourceLoc,
-                                const DiagnosticKind Kind,
-                                const LineContext Context)
+                                const diag::DiagID ID)
 {
-  return CheffeDiagnosticBuilder(this, SourceLoc, Kind, Context);
+  if (getDiagnosticKind(ID) == DiagnosticKind::Error)
+  {
+    ++ErrorCount;
+  }
+  else
+  {
+    ++WarningCount;
+  }
+
+  if (DiagnosticLimit && Diagnostics.size() >= DiagnosticLimit)
+  {
+    return CheffeDiagnosticBuilder(nullptr);
+  }
+
+  Diagnostics.emplace_back(ID, SourceLoc);
+  return CheffeDiagnosticBuilder(&Diagnostics.back());
 }
 
 } // end namespace cheffe
@@ -1,26 +1,24 @@
 #include "CheffeFileHandler.h"
 
-#include <fstream>
-
 using namespace cheffe;
 
-CheffeErrorCode CheffeFileHandler::readFile(CheffeSourceFile &File)
+const std::string &CheffeSourceFile::getName() const
+{
+  static const std::string NoName;
+  return Buffer ? Buffer->getName() : NoName;
+}
+
+CheffeErrorCode CheffeFileHandler::readFile(const std::string &FileName,
+                                            CheffeSourceFile &File)
 {
-  std::ifstream InStream(File.Name, std::ios::in | std::ios::binary);
+  auto Buffer = CheffeSourceBuffer::getFile(FileName);
 
-  if (!InStream)
+  if (!Buffer)
   {
     return CheffeErrorCode::CHEFFE_ERROR;
   }
 
-  InStream.seekg(0, std::ios::end);
-
-  File.Source.resize(InStream.tellg());
-
-  InStream.seekg(0, std::ios::beg);
-  InStream.read(&File[0], File.Source.size());
-
-  InStream.close();
+  File = CheffeSourceFile(std::move(Buffer));
 
   return CheffeErrorCode::CHEFFE_SUCCESS;
 }
@@ -2,32 +2,75 @@
 #define CHEFFE_FILE_HANDLER
 
 #include "cheffe.h"
+#include "Utils/CheffeSourceBuffer.h"
 
+#include <memory>
 #include <string>
 
 namespace cheffe
 {
 
-struct CheffeSourceFile
+// A handle on a source buffer. Copying it only copies the reference, so the
+// driver, lexer and diagnostics can each hold one without duplicating the
+// text.
+class CheffeSourceFile
 {
-  std::string Name;
-  std::string Source;
+public:
+  CheffeSourceFile() : Buffer(nullptr)
+  {
+  }
+
+  explicit CheffeSourceFile(std::shared_ptr<const CheffeSourceBuffer> Buffer)
+      : Buffer(std::move(Buffer))
+  {
+  }
 
-  char &operator[](std::size_t Pos)
+  const std::string &getName() const;
+
+  StringRef getSource() const
+  {
+    return Buffer ? Buffer->getBuffer() : StringRef();
+  }
+
+  unsigned getLineNumber(const std::size_t Offset) const
   {
-    return Source[Pos];
+    return Buffer ? Buffer->getLineNumber(Offset) : 1;
   }
 
-  const char &operator[](std::size_t Pos) const
+  unsigned getColumnNumber(const std::size_t Offset) const
   {
-    return Source[Pos];
+    return Buffer ? Buffer->getColumnNumber(Offset) : 1;
   }
+
+  StringRef getLine(const unsigned LineNo) const
+  {
+    return Buffer ? Buffer->getLine(LineNo) : StringRef();
+  }
+
+  std::size_t size() const
+  {
+    return Buffer ? Buffer->getBufferSize() : 0;
+  }
+
+  bool empty() const
+  {
+    return size() == 0;
+  }
+
+  char operator[](std::size_t Pos) const
+  {
+    return Buffer->getBufferStart()[Pos];
+  }
+
+private:
+  std::shared_ptr<const CheffeSourceBuffer> Buffer;
 };
 
 class CheffeFileHandler
 {
 public:
-  static CheffeErrorCode readFile(CheffeSourceFile &File);
+  static CheffeErrorCode readFile(const std::string &FileName,
+                                  CheffeSourceFile &File);
 };
 
 } // end namespace cheffe
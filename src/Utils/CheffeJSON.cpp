@@ -0,0 +1,539 @@
+#include "Utils/CheffeJSON.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ostream>
+
+namespace cheffe
+{
+
+// A recursive-descent parser over the whole document. Nesting is limited so
+// that a malicious request can't run the stack out.
+class JSONParser
+{
+public:
+  JSONParser(const StringRef Text) : Text(Text), Pos(0)
+  {
+  }
+
+  bool parseDocument(JSONValue &Value, std::string &Error)
+  {
+    if (!parseValue(Value, 0))
+    {
+      Error = this->Error;
+      return false;
+    }
+    skipWhitespace();
+    if (Pos != Text.size())
+    {
+      Error = "unexpected text after the JSON value at offset " +
+              std::to_string(Pos);
+      return false;
+    }
+    return true;
+  }
+
+private:
+  static const unsigned MaxDepth = 64;
+
+  StringRef Text;
+  std::size_t Pos;
+  std::string Error;
+
+  bool fail(const std::string &Message)
+  {
+    Error = Message + " at offset " + std::to_string(Pos);
+    return false;
+  }
+
+  void skipWhitespace()
+  {
+    while (Pos < Text.size() && (Text[Pos] == ' ' || Text[Pos] == '\t' ||
+                                 Text[Pos] == '\n' || Text[Pos] == '\r'))
+    {
+      ++Pos;
+    }
+  }
+
+  bool consumeLiteral(const char *Literal)
+  {
+    const StringRef Expected(Literal);
+    if (Text.size() - Pos < Expected.size() ||
+        !StringRef(Text.data() + Pos, Expected.size()).equals(Expected))
+    {
+      return false;
+    }
+    Pos += Expected.size();
+    return true;
+  }
+
+  bool parseValue(JSONValue &Value, const unsigned Depth)
+  {
+    if (Depth > MaxDepth)
+    {
+      return fail("JSON nested too deeply");
+    }
+
+    skipWhitespace();
+    if (Pos == Text.size())
+    {
+      return fail("expected a JSON value");
+    }
+
+    switch (Text[Pos])
+    {
+    case '{':
+      return parseObject(Value, Depth);
+    case '[':
+      return parseArray(Value, Depth);
+    case '"':
+      Value.ValueKind = JSONValue::Kind::String;
+      return parseString(Value.StringValue);
+    case 't':
+    case 'f':
+      Value.ValueKind = JSONValue::Kind::Bool;
+      Value.BoolValue = Text[Pos] == 't';
+      if (!consumeLiteral(Value.BoolValue ? "true" : "false"))
+      {
+        return fail("invalid literal");
+      }
+      return true;
+    case 'n':
+      Value.ValueKind = JSONValue::Kind::Null;
+      if (!consumeLiteral("null"))
+      {
+        return fail("invalid literal");
+      }
+      return true;
+    default:
+      return parseNumber(Value);
+    }
+  }
+
+  bool parseObject(JSONValue &Value, const unsigned Depth)
+  {
+    Value.ValueKind = JSONValue::Kind::Object;
+    ++Pos;
+    skipWhitespace();
+    if (Pos < Text.size() && Text[Pos] == '}')
+    {
+      ++Pos;
+      return true;
+    }
+
+    while (true)
+    {
+      skipWhitespace();
+      std::string Key;
+      if (Pos == Text.size() || Text[Pos] != '"')
+      {
+        return fail("expected an object key");
+      }
+      if (!parseString(Key))
+      {
+        return false;
+      }
+
+      skipWhitespace();
+      if (Pos == Text.size() || Text[Pos] != ':')
+      {
+        return fail("expected ':'");
+      }
+      ++Pos;
+
+      if (!parseValue(Value.ObjectValue[Key], Depth + 1))
+      {
+        return false;
+      }
+
+      skipWhitespace();
+      if (Pos < Text.size() && Text[Pos] == ',')
+      {
+        ++Pos;
+        continue;
+      }
+      if (Pos < Text.size() && Text[Pos] == '}')
+      {
+        ++Pos;
+        return true;
+      }
+      return fail("expected ',' or '}'");
+    }
+  }
+
+  bool parseArray(JSONValue &Value, const unsigned Depth)
+  {
+    Value.ValueKind = JSONValue::Kind::Array;
+    ++Pos;
+    skipWhitespace();
+    if (Pos < Text.size() && Text[Pos] == ']')
+    {
+      ++Pos;
+      return true;
+    }
+
+    while (true)
+    {
+      Value.ArrayValue.emplace_back();
+      if (!parseValue(Value.ArrayValue.back(), Depth + 1))
+      {
+        return false;
+      }
+
+      skipWhitespace();
+      if (Pos < Text.size() && Text[Pos] == ',')
+      {
+        ++Pos;
+        continue;
+      }
+      if (Pos < Text.size() && Text[Pos] == ']')
+      {
+        ++Pos;
+        return true;
+      }
+      return fail("expected ',' or ']'");
+    }
+  }
+
+  bool parseHex4(unsigned &CodePoint)
+  {
+    if (Text.size() - Pos < 4)
+    {
+      return fail("truncated unicode escape");
+    }
+    CodePoint = 0;
+    for (unsigned i = 0; i < 4; ++i)
+    {
+      const char C = Text[Pos++];
+      CodePoint <<= 4;
+      if (C >= '0' && C <= '9')
+      {
+        CodePoint |= C - '0';
+      }
+      else if (C >= 'a' && C <= 'f')
+      {
+        CodePoint |= C - 'a' + 10;
+      }
+      else if (C >= 'A' && C <= 'F')
+      {
+        CodePoint |= C - 'A' + 10;
+      }
+      else
+      {
+        return fail("invalid unicode escape");
+      }
+    }
+    return true;
+  }
+
+  static void appendUTF8(std::string &Str, const unsigned CodePoint)
+  {
+    if (CodePoint < 0x80)
+    {
+      Str += static_cast<char>(CodePoint);
+    }
+    else if (CodePoint < 0x800)
+    {
+      Str += static_cast<char>(0xC0 | (CodePoint >> 6));
+      Str += static_cast<char>(0x80 | (CodePoint & 0x3F));
+    }
+    else if (CodePoint < 0x10000)
+    {
+      Str += static_cast<char>(0xE0 | (CodePoint >> 12));
+      Str += static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F));
+      Str += static_cast<char>(0x80 | (CodePoint & 0x3F));
+    }
+    else
+    {
+      Str += static_cast<char>(0xF0 | (CodePoint >> 18));
+      Str += static_cast<char>(0x80 | ((CodePoint >> 12) & 0x3F));
+      Str += static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F));
+      Str += static_cast<char>(0x80 | (CodePoint & 0x3F));
+    }
+  }
+
+  bool parseString(std::string &Str)
+  {
+    assert(Text[Pos] == '"' && "Not at a string");
+    ++Pos;
+    while (true)
+    {
+      if (Pos == Text.size())
+      {
+        return fail("unterminated string");
+      }
+
+      const char C = Text[Pos++];
+      if (C == '"')
+      {
+        return true;
+      }
+      if (static_cast<unsigned char>(C) < 0x20)
+      {
+        return fail("control character in string");
+      }
+      if (C != '\\')
+      {
+        Str += C;
+        continue;
+      }
+
+      if (Pos == Text.size())
+      {
+        return fail("unterminated string");
+      }
+      switch (Text[Pos++])
+      {
+      case '"':
+        Str += '"';
+        break;
+      case '\\':
+        Str += '\\';
+        break;
+      case '/':
+        Str += '/';
+        break;
+      case 'b':
+        Str += '\b';
+        break;
+      case 'f':
+        Str += '\f';
+        break;
+      case 'n':
+        Str += '\n';
+        break;
+      case 'r':
+        Str += '\r';
+        break;
+      case 't':
+        Str += '\t';
+        break;
+      case 'u':
+      {
+        unsigned CodePoint = 0;
+        if (!parseHex4(CodePoint))
+        {
+          return false;
+        }
+        // A high surrogate must be followed by a low one.
+        if (CodePoint >= 0xD800 && CodePoint < 0xDC00)
+        {
+          unsigned Low = 0;
+          if (!consumeLiteral("\\u") || !parseHex4(Low) || Low < 0xDC00 ||
+              Low >= 0xE000)
+          {
+            return fail("invalid surrogate pair");
+          }
+          CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (Low - 0xDC00);
+        }
+        appendUTF8(Str, CodePoint);
+        break;
+      }
+      default:
+        return fail("invalid escape sequence");
+      }
+    }
+  }
+
+  bool parseNumber(JSONValue &Value)
+  {
+    const std::size_t Begin = Pos;
+    if (Pos < Text.size() && Text[Pos] == '-')
+    {
+      ++Pos;
+    }
+    while (Pos < Text.size() &&
+           ((Text[Pos] >= '0' && Text[Pos] <= '9') || Text[Pos] == '.' ||
+            Text[Pos] == 'e' || Text[Pos] == 'E' || Text[Pos] == '+' ||
+            Text[Pos] == '-'))
+    {
+      ++Pos;
+    }
+
+    const std::string Number(Text.data() + Begin, Pos - Begin);
+    char *End = nullptr;
+    Value.NumberValue = std::strtod(Number.c_str(), &End);
+    if (Number.empty() || *End || !std::isfinite(Value.NumberValue))
+    {
+      Pos = Begin;
+      return fail("invalid number");
+    }
+    Value.ValueKind = JSONValue::Kind::Number;
+    return true;
+  }
+};
+
+bool JSONValue::parse(const StringRef Text, JSONValue &Value,
+                      std::string &Error)
+{
+  Value = JSONValue();
+  return JSONParser(Text).parseDocument(Value, Error);
+}
+
+bool JSONValue::getBool() const
+{
+  assert(ValueKind == Kind::Bool && "Not a bool");
+  return BoolValue;
+}
+
+double JSONValue::getNumber() const
+{
+  assert(ValueKind == Kind::Number && "Not a number");
+  return NumberValue;
+}
+
+const std::string &JSONValue::getString() const
+{
+  assert(ValueKind == Kind::String && "Not a string");
+  return StringValue;
+}
+
+const std::vector<JSONValue> &JSONValue::getArray() const
+{
+  assert(ValueKind == Kind::Array && "Not an array");
+  return ArrayValue;
+}
+
+const JSONValue *JSONValue::get(const std::string &Key) const
+{
+  if (ValueKind != Kind::Object)
+  {
+    return nullptr;
+  }
+  auto Member = ObjectValue.find(Key);
+  return Member == std::end(ObjectValue) ? nullptr : &Member->second;
+}
+
+void JSONWriter::valueBegin()
+{
+  if (NeedsComma)
+  {
+    OS << ',';
+  }
+  NeedsComma = true;
+}
+
+void JSONWriter::objectBegin()
+{
+  valueBegin();
+  OS << '{';
+  NeedsComma = false;
+}
+
+void JSONWriter::objectEnd()
+{
+  OS << '}';
+  NeedsComma = true;
+}
+
+void JSONWriter::arrayBegin()
+{
+  valueBegin();
+  OS << '[';
+  NeedsComma = false;
+}
+
+void JSONWriter::arrayEnd()
+{
+  OS << ']';
+  NeedsComma = true;
+}
+
+void JSONWriter::attribute(const StringRef Key)
+{
+  valueBegin();
+  writeString(Key);
+  OS << ':';
+  NeedsComma = false;
+}
+
+void JSONWriter::value(const StringRef Str)
+{
+  valueBegin();
+  writeString(Str);
+}
+
+void JSONWriter::value(const char *Str)
+{
+  value(StringRef(Str));
+}
+
+void JSONWriter::value(const double Number)
+{
+  valueBegin();
+  // JSON has no way to write infinities or NaNs.
+  if (!std::isfinite(Number))
+  {
+    OS << "null";
+    return;
+  }
+  char Buffer[32];
+  std::snprintf(Buffer, sizeof(Buffer), "%.15g", Number);
+  OS << Buffer;
+}
+
+void JSONWriter::value(const bool Bool)
+{
+  valueBegin();
+  OS << (Bool ? "true" : "false");
+}
+
+void JSONWriter::nullValue()
+{
+  valueBegin();
+  OS << "null";
+}
+
+void JSONWriter::writeInteger(const long long Number)
+{
+  valueBegin();
+  OS << Number;
+}
+
+void JSONWriter::writeUnsigned(const unsigned long long Number)
+{
+  valueBegin();
+  OS << Number;
+}
+
+void JSONWriter::writeString(const StringRef Str)
+{
+  static const char HexDigits[] = "0123456789abcdef";
+  OS << '"';
+  for (const char C : Str)
+  {
+    switch (C)
+    {
+    case '"':
+      OS << "\\\"";
+      break;
+    case '\\':
+      OS << "\\\\";
+      break;
+    case '\n':
+      OS << "\\n";
+      break;
+    case '\r':
+      OS << "\\r";
+      break;
+    case '\t':
+      OS << "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(C) < 0x20)
+      {
+        OS << "\\u00" << HexDigits[(C >> 4) & 0xF] << HexDigits[C & 0xF];
+      }
+      else
+      {
+        OS << C;
+      }
+      break;
+    }
+  }
+  OS << '"';
+}
+
+} // end namespace cheffe
@@ -0,0 +1,118 @@
+#ifndef CHEFFE_JSON
+#define CHEFFE_JSON
+
+#include "Utils/CheffeStringRef.h"
+
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace cheffe
+{
+
+// Just enough JSON for cheffe's tools to talk to other programs: a value type
+// to parse requests into, and a writer to stream results out with.
+class JSONValue
+{
+public:
+  enum class Kind
+  {
+    Null,
+    Bool,
+    Number,
+    String,
+    Array,
+    Object
+  };
+
+  JSONValue() : ValueKind(Kind::Null), BoolValue(false), NumberValue(0)
+  {
+  }
+
+  // Parses a complete JSON document. Returns false, with a description of
+  // the problem in Error, if Text isn't valid JSON.
+  static bool parse(const StringRef Text, JSONValue &Value,
+                    std::string &Error);
+
+  Kind getKind() const
+  {
+    return ValueKind;
+  }
+
+  bool isNull() const
+  {
+    return ValueKind == Kind::Null;
+  }
+
+  bool getBool() const;
+  double getNumber() const;
+  const std::string &getString() const;
+  const std::vector<JSONValue> &getArray() const;
+
+  // Returns the member of an object with the given key, or nullptr if there
+  // isn't one or this isn't an object.
+  const JSONValue *get(const std::string &Key) const;
+
+private:
+  friend class JSONParser;
+
+  Kind ValueKind;
+  bool BoolValue;
+  double NumberValue;
+  std::string StringValue;
+  std::vector<JSONValue> ArrayValue;
+  std::map<std::string, JSONValue> ObjectValue;
+};
+
+// Streams JSON to an output stream, taking care of commas and escaping. Every
+// value inside an object must be preceded by a call to attribute.
+class JSONWriter
+{
+public:
+  explicit JSONWriter(std::ostream &OS) : OS(OS), NeedsComma(false)
+  {
+  }
+
+  void objectBegin();
+  void objectEnd();
+  void arrayBegin();
+  void arrayEnd();
+
+  void attribute(const StringRef Key);
+
+  void value(const StringRef Str);
+  void value(const char *Str);
+  void value(const double Number);
+  void value(const bool Bool);
+  void nullValue();
+
+  template <typename IntTy>
+  typename std::enable_if<std::is_integral<IntTy>::value &&
+                          !std::is_same<IntTy, bool>::value>::type
+  value(const IntTy Number)
+  {
+    if (std::is_signed<IntTy>::value)
+    {
+      writeInteger(static_cast<long long>(Number));
+    }
+    else
+    {
+      writeUnsigned(static_cast<unsigned long long>(Number));
+    }
+  }
+
+private:
+  std::ostream &OS;
+  bool NeedsComma;
+
+  void valueBegin();
+  void writeString(const StringRef Str);
+  void writeInteger(const long long Number);
+  void writeUnsigned(const unsigned long long Number);
+};
+
+} // end namespace cheffe
+
+#endif // CHEFFE_JSON
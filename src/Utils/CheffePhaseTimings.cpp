@@ -0,0 +1,232 @@
+#include "Utils/CheffePhaseTimings.h"
+#include "Utils/CheffeJSON.h"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+
+#if !defined(_WIN32) && !defined(__WIN64) && defined(__unix__) ||              \
+    (defined(__APPLE__) && defined(__MACH__))
+#include <time.h>
+#endif
+
+namespace cheffe
+{
+
+CheffeTimes CheffeTimes::now()
+{
+  CheffeTimes Times;
+  Times.WallSeconds = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now().time_since_epoch())
+                          .count();
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+  struct timespec CPUTime;
+  if (!clock_gettime(CLOCK_THREAD_CPUTIME_ID, &CPUTime))
+  {
+    Times.CPUSeconds = CPUTime.tv_sec + CPUTime.tv_nsec / 1e9;
+    return Times;
+  }
+#endif
+  Times.CPUSeconds = static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+  return Times;
+}
+
+CheffeTimes &CheffeTimes::operator+=(const CheffeTimes &Other)
+{
+  WallSeconds += Other.WallSeconds;
+  CPUSeconds += Other.CPUSeconds;
+  return *this;
+}
+
+CheffeTimes &CheffeTimes::operator-=(const CheffeTimes &Other)
+{
+  WallSeconds = std::max(WallSeconds - Other.WallSeconds, 0.0);
+  CPUSeconds = std::max(CPUSeconds - Other.CPUSeconds, 0.0);
+  return *this;
+}
+
+const char *getPhaseName(const CheffePhase Phase)
+{
+  switch (Phase)
+  {
+  case CheffePhase::ReadFile:
+    return "read-file";
+  case CheffePhase::Lex:
+    return "lex";
+  case CheffePhase::Parse:
+    return "parse";
+  case CheffePhase::ScopeFixup:
+    return "scope-fixup";
+  case CheffePhase::Link:
+    return "link";
+  case CheffePhase::Execute:
+    return "execute";
+  case CheffePhase::Invalid:
+    break;
+  }
+  return "invalid";
+}
+
+void CheffePhaseTimings::addTimes(const CheffePhase Phase,
+                                  const std::string &Recipe,
+                                  const CheffeTimes &Times)
+{
+  std::lock_guard<std::mutex> Lock(Mutex);
+  const unsigned PhaseIdx = static_cast<unsigned>(Phase);
+  RecipeTimesTy &PhaseTimes = RecipeTimes[PhaseIdx];
+  const auto Inserted =
+      RecipeIndices[PhaseIdx].emplace(Recipe, PhaseTimes.size());
+  if (!Inserted.second)
+  {
+    PhaseTimes[Inserted.first->second].second += Times;
+    return;
+  }
+  PhaseTimes.emplace_back(Recipe, Times);
+}
+
+CheffePhaseTimings::RecipeTimesTy
+CheffePhaseTimings::getRecipeTimes(const CheffePhase Phase) const
+{
+  std::lock_guard<std::mutex> Lock(Mutex);
+  return RecipeTimes[static_cast<unsigned>(Phase)];
+}
+
+bool CheffePhaseTimings::getTimes(const CheffePhase Phase,
+                                  const std::string &Recipe,
+                                  CheffeTimes &Times) const
+{
+  std::lock_guard<std::mutex> Lock(Mutex);
+  const unsigned PhaseIdx = static_cast<unsigned>(Phase);
+  const auto Found = RecipeIndices[PhaseIdx].find(Recipe);
+  if (Found == RecipeIndices[PhaseIdx].end())
+  {
+    return false;
+  }
+  Times = RecipeTimes[PhaseIdx][Found->second].second;
+  return true;
+}
+
+CheffeTimes CheffePhaseTimings::getPhaseTotal(const CheffePhase Phase) const
+{
+  CheffeTimes Total;
+  for (const auto &Entry : getRecipeTimes(Phase))
+  {
+    Total += Entry.second;
+  }
+  return Total;
+}
+
+static void printTimesRow(std::ostream &OS, const CheffeTimes &Times,
+                          const unsigned Indent, const std::string &Name)
+{
+  OS << std::setw(12) << Times.WallSeconds * 1000 << std::setw(12)
+     << Times.CPUSeconds * 1000 << "  " << std::string(Indent, ' ') << Name
+     << std::endl;
+}
+
+void CheffePhaseTimings::print(std::ostream &OS) const
+{
+  const std::ios::fmtflags OldFlags = OS.flags();
+  const std::streamsize OldPrecision = OS.precision(3);
+  OS << std::fixed;
+
+  OS << "=== Phase Timings ===" << std::endl
+     << std::setw(12) << "Wall (ms)" << std::setw(12) << "CPU (ms)"
+     << "  Phase / Recipe" << std::endl;
+
+  CheffeTimes Total;
+  for (unsigned i = 0; i < NumPhases; ++i)
+  {
+    const CheffePhase Phase = static_cast<CheffePhase>(i);
+    const RecipeTimesTy PhaseTimes = getRecipeTimes(Phase);
+    if (PhaseTimes.empty())
+    {
+      continue;
+    }
+
+    const CheffeTimes PhaseTotal = getPhaseTotal(Phase);
+    Total += PhaseTotal;
+    printTimesRow(OS, PhaseTotal, 0, getPhaseName(Phase));
+
+    // A phase that only ever worked on the whole program isn't split up.
+    if (PhaseTimes.size() == 1 && PhaseTimes.front().first.empty())
+    {
+      continue;
+    }
+    for (const auto &Entry : PhaseTimes)
+    {
+      printTimesRow(OS, Entry.second, 2,
+                    Entry.first.empty() ? "<whole program>" : Entry.first);
+    }
+  }
+  printTimesRow(OS, Total, 0, "total");
+
+  OS.precision(OldPrecision);
+  OS.flags(OldFlags);
+}
+
+static void writeTimes(JSONWriter &Writer, const CheffeTimes &Times)
+{
+  Writer.attribute("wall_ms");
+  Writer.value(Times.WallSeconds * 1000);
+  Writer.attribute("cpu_ms");
+  Writer.value(Times.CPUSeconds * 1000);
+}
+
+void CheffePhaseTimings::printJSON(std::ostream &OS) const
+{
+  JSONWriter Writer(OS);
+  Writer.objectBegin();
+  Writer.attribute("phases");
+  Writer.arrayBegin();
+
+  CheffeTimes Total;
+  for (unsigned i = 0; i < NumPhases; ++i)
+  {
+    const CheffePhase Phase = static_cast<CheffePhase>(i);
+    const RecipeTimesTy PhaseTimes = getRecipeTimes(Phase);
+    if (PhaseTimes.empty())
+    {
+      continue;
+    }
+
+    const CheffeTimes PhaseTotal = getPhaseTotal(Phase);
+    Total += PhaseTotal;
+
+    Writer.objectBegin();
+    Writer.attribute("phase");
+    Writer.value(getPhaseName(Phase));
+    writeTimes(Writer, PhaseTotal);
+    Writer.attribute("recipes");
+    Writer.arrayBegin();
+    for (const auto &Entry : PhaseTimes)
+    {
+      Writer.objectBegin();
+      // Time spent on the whole program has no recipe to go against.
+      Writer.attribute("recipe");
+      if (Entry.first.empty())
+      {
+        Writer.nullValue();
+      }
+      else
+      {
+        Writer.value(Entry.first);
+      }
+      writeTimes(Writer, Entry.second);
+      Writer.objectEnd();
+    }
+    Writer.arrayEnd();
+    Writer.objectEnd();
+  }
+
+  Writer.arrayEnd();
+  Writer.attribute("total");
+  Writer.objectBegin();
+  writeTimes(Writer, Total);
+  Writer.objectEnd();
+  Writer.objectEnd();
+  OS << std::endl;
+}
+
+} // end namespace cheffe
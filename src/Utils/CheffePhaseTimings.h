@@ -0,0 +1,121 @@
+#ifndef CHEFFE_PHASE_TIMINGS
+#define CHEFFE_PHASE_TIMINGS
+
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cheffe
+{
+
+// A reading of the wall clock and of the CPU time used, or the time between
+// two readings.
+struct CheffeTimes
+{
+  double WallSeconds = 0;
+  double CPUSeconds = 0;
+
+  // The CPU time is the calling thread's where the platform can say, so that
+  // recipes parsed on different threads are each charged only for their own;
+  // elsewhere it's the whole process's.
+  static CheffeTimes now();
+
+  CheffeTimes &operator+=(const CheffeTimes &Other);
+  // Never goes below zero, as the two clocks are read at slightly different
+  // moments.
+  CheffeTimes &operator-=(const CheffeTimes &Other);
+};
+
+inline CheffeTimes operator-(CheffeTimes LHS, const CheffeTimes &RHS)
+{
+  return LHS -= RHS;
+}
+
+// In the order they happen to a program.
+enum class CheffePhase
+{
+  ReadFile,
+  Lex,
+  Parse,
+  ScopeFixup,
+  Link,
+  Execute,
+  Invalid
+};
+
+const char *getPhaseName(const CheffePhase Phase);
+
+// The time spent in each phase of compiling and running a program, split by
+// the recipe it was spent on. Time spent on the whole program at once, such
+// as reading the file, goes against an empty recipe title.
+class CheffePhaseTimings
+{
+public:
+  typedef std::vector<std::pair<std::string, CheffeTimes>> RecipeTimesTy;
+
+  static const unsigned NumPhases = static_cast<unsigned>(CheffePhase::Invalid);
+
+  // Adds Times to those already recorded for Recipe in Phase. Safe to call
+  // from several threads at once.
+  void addTimes(const CheffePhase Phase, const std::string &Recipe,
+                const CheffeTimes &Times);
+
+  // Recipes are listed in the order their times were first recorded.
+  RecipeTimesTy getRecipeTimes(const CheffePhase Phase) const;
+
+  // Returns false if no times were recorded for Recipe in Phase.
+  bool getTimes(const CheffePhase Phase, const std::string &Recipe,
+                CheffeTimes &Times) const;
+
+  CheffeTimes getPhaseTotal(const CheffePhase Phase) const;
+
+  // Prints a table meant for reading, leaving out phases that never ran.
+  void print(std::ostream &OS) const;
+
+  // Prints the same as print, as a JSON object. Times are in milliseconds.
+  void printJSON(std::ostream &OS) const;
+
+private:
+  mutable std::mutex Mutex;
+  RecipeTimesTy RecipeTimes[NumPhases];
+  // Where each recipe's times are in RecipeTimes.
+  std::unordered_map<std::string, std::size_t> RecipeIndices[NumPhases];
+};
+
+// Times the scope it's declared in, adding it to Recipe's times in Phase when
+// the scope is left. Does nothing if Timings is null.
+class CheffePhaseTimer
+{
+public:
+  CheffePhaseTimer(CheffePhaseTimings *Timings, const CheffePhase Phase,
+                   const std::string &Recipe)
+      : Timings(Timings), Phase(Phase),
+        Recipe(Timings ? Recipe : std::string())
+  {
+    if (Timings)
+    {
+      Start = CheffeTimes::now();
+    }
+  }
+
+  ~CheffePhaseTimer()
+  {
+    if (Timings)
+    {
+      Timings->addTimes(Phase, Recipe, CheffeTimes::now() - Start);
+    }
+  }
+
+private:
+  CheffePhaseTimings *Timings;
+  const CheffePhase Phase;
+  const std::string Recipe;
+  CheffeTimes Start;
+};
+
+} // end namespace cheffe
+
+#endif // CHEFFE_PHASE_TIMINGS
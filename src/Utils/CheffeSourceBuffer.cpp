@@ -0,0 +1,195 @@
+#include "Utils/CheffeSourceBuffer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CHEFFE_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cheffe
+{
+
+namespace
+{
+
+class OwnedSourceBuffer : public CheffeSourceBuffer
+{
+public:
+  OwnedSourceBuffer(const std::string &Name, std::string &&Text)
+      : CheffeSourceBuffer(Name), Contents(std::move(Text))
+  {
+    init(Contents.data(), Contents.size());
+  }
+
+private:
+  std::string Contents;
+};
+
+#ifdef CHEFFE_HAVE_MMAP
+class MappedSourceBuffer : public CheffeSourceBuffer
+{
+public:
+  MappedSourceBuffer(const std::string &Name, void *Mapping,
+                     const std::size_t Size)
+      : CheffeSourceBuffer(Name), Mapping(Mapping), MappingSize(Size)
+  {
+    init(static_cast<const char *>(Mapping), Size);
+  }
+
+  ~MappedSourceBuffer() override
+  {
+    ::munmap(Mapping, MappingSize);
+  }
+
+private:
+  void *Mapping;
+  std::size_t MappingSize;
+};
+
+// Returns nullptr if the file can't be mapped, in which case the caller falls
+// back to reading it.
+std::shared_ptr<const CheffeSourceBuffer>
+getMappedFile(const std::string &FileName)
+{
+  const int FD = ::open(FileName.c_str(), O_RDONLY);
+  if (FD < 0)
+  {
+    return nullptr;
+  }
+
+  struct stat FileInfo;
+  if (::fstat(FD, &FileInfo) != 0 || !S_ISREG(FileInfo.st_mode) ||
+      FileInfo.st_size == 0)
+  {
+    ::close(FD);
+    return nullptr;
+  }
+
+  const std::size_t Size = static_cast<std::size_t>(FileInfo.st_size);
+  if (Size > CheffeSourceBuffer::MaxBufferSize)
+  {
+    ::close(FD);
+    return nullptr;
+  }
+
+  void *Mapping = ::mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, FD, 0);
+  // The mapping stays valid once the descriptor is closed.
+  ::close(FD);
+  if (Mapping == MAP_FAILED)
+  {
+    return nullptr;
+  }
+
+  return std::make_shared<MappedSourceBuffer>(FileName, Mapping, Size);
+}
+#endif // CHEFFE_HAVE_MMAP
+
+} // end anonymous namespace
+
+std::shared_ptr<const CheffeSourceBuffer>
+CheffeSourceBuffer::getFile(const std::string &FileName)
+{
+#ifdef CHEFFE_HAVE_MMAP
+  if (auto Buffer = getMappedFile(FileName))
+  {
+    return Buffer;
+  }
+#endif
+
+  std::ifstream InStream(FileName, std::ios::in | std::ios::binary);
+
+  if (!InStream)
+  {
+    return nullptr;
+  }
+
+  InStream.seekg(0, std::ios::end);
+  const std::streamoff Size = InStream.tellg();
+  if (Size < 0 || static_cast<std::size_t>(Size) > MaxBufferSize)
+  {
+    return nullptr;
+  }
+
+  std::string Contents;
+  Contents.resize(Size);
+
+  InStream.seekg(0, std::ios::beg);
+  InStream.read(&Contents[0], Contents.size());
+
+  if (!InStream)
+  {
+    return nullptr;
+  }
+
+  return getMemBuffer(FileName, std::move(Contents));
+}
+
+std::shared_ptr<const CheffeSourceBuffer>
+CheffeSourceBuffer::getMemBuffer(const std::string &Name, std::string Contents)
+{
+  if (Contents.size() > MaxBufferSize)
+  {
+    return nullptr;
+  }
+  return std::make_shared<OwnedSourceBuffer>(Name, std::move(Contents));
+}
+
+void CheffeSourceBuffer::buildLineStarts() const
+{
+  LineStarts.push_back(0);
+  const char *const End = BufferStart + BufferSize;
+  const char *Ptr = BufferStart;
+  while ((Ptr = static_cast<const char *>(std::memchr(Ptr, '\n', End - Ptr))))
+  {
+    LineStarts.push_back(++Ptr - BufferStart);
+  }
+}
+
+const std::vector<std::uint32_t> &CheffeSourceBuffer::getLineStarts() const
+{
+  std::call_once(LineStartsFlag, &CheffeSourceBuffer::buildLineStarts, this);
+  return LineStarts;
+}
+
+unsigned CheffeSourceBuffer::getNumLines() const
+{
+  return getLineStarts().size();
+}
+
+unsigned CheffeSourceBuffer::getLineNumber(const std::size_t Offset) const
+{
+  const std::vector<std::uint32_t> &Starts = getLineStarts();
+  // The first line starting after Offset is one past Offset's line.
+  return std::upper_bound(std::begin(Starts), std::end(Starts), Offset) -
+         std::begin(Starts);
+}
+
+unsigned CheffeSourceBuffer::getColumnNumber(const std::size_t Offset) const
+{
+  const std::size_t LineStart = getLineStarts()[getLineNumber(Offset) - 1];
+  return std::min(Offset, BufferSize) - LineStart + 1;
+}
+
+StringRef CheffeSourceBuffer::getLine(const unsigned LineNo) const
+{
+  const std::vector<std::uint32_t> &Starts = getLineStarts();
+  assert(LineNo != 0 && "Lines must be indexed from 1");
+  if (LineNo > Starts.size())
+  {
+    return StringRef();
+  }
+
+  const std::size_t LineStart = Starts[LineNo - 1];
+  const std::size_t LineEnd =
+      LineNo < Starts.size() ? Starts[LineNo] - 1 : BufferSize;
+  return StringRef(BufferStart + LineStart, LineEnd - LineStart);
+}
+
+} // end namespace cheffe
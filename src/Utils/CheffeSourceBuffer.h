@@ -0,0 +1,97 @@
+#ifndef CHEFFE_SOURCE_BUFFER
+#define CHEFFE_SOURCE_BUFFER
+
+#include "Utils/CheffeStringRef.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace cheffe
+{
+
+// The immutable contents of a source file. There is only ever one copy of a
+// file's text in memory, shared by everything that needs to look at it: files
+// are memory-mapped where possible, rather than read into a string.
+class CheffeSourceBuffer
+{
+public:
+  virtual ~CheffeSourceBuffer()
+  {
+  }
+
+  CheffeSourceBuffer(const CheffeSourceBuffer &) = delete;
+  CheffeSourceBuffer &operator=(const CheffeSourceBuffer &) = delete;
+
+  // Source locations are 32-bit offsets into the buffer, which caps its size.
+  static const std::size_t MaxBufferSize = UINT32_MAX;
+
+  // Returns nullptr if the file can't be opened or read, or is too large.
+  static std::shared_ptr<const CheffeSourceBuffer>
+  getFile(const std::string &FileName);
+
+  // Takes ownership of a copy of the given text. Returns nullptr if the text
+  // is too large.
+  static std::shared_ptr<const CheffeSourceBuffer>
+  getMemBuffer(const std::string &Name, std::string Contents);
+
+  const std::string &getName() const
+  {
+    return Name;
+  }
+
+  const char *getBufferStart() const
+  {
+    return BufferStart;
+  }
+
+  std::size_t getBufferSize() const
+  {
+    return BufferSize;
+  }
+
+  StringRef getBuffer() const
+  {
+    return StringRef(BufferStart, BufferSize);
+  }
+
+  // Line lookups go through an index of line-start offsets, built the first
+  // time one is needed. Lines and columns are numbered from 1.
+  unsigned getNumLines() const;
+
+  // Offsets at or past the end of the buffer belong to the last line.
+  unsigned getLineNumber(const std::size_t Offset) const;
+  unsigned getColumnNumber(const std::size_t Offset) const;
+
+  // Returns the text of the given line, without its newline.
+  StringRef getLine(const unsigned LineNo) const;
+
+protected:
+  CheffeSourceBuffer(const std::string &Name)
+      : Name(Name), BufferStart(""), BufferSize(0)
+  {
+  }
+
+  void init(const char *Start, const std::size_t Size)
+  {
+    BufferStart = Start;
+    BufferSize = Size;
+  }
+
+private:
+  std::string Name;
+  const char *BufferStart;
+  std::size_t BufferSize;
+
+  mutable std::once_flag LineStartsFlag;
+  mutable std::vector<std::uint32_t> LineStarts;
+
+  void buildLineStarts() const;
+  const std::vector<std::uint32_t> &getLineStarts() const;
+};
+
+} // end namespace cheffe
+
+#endif // CHEFFE_SOURCE_BUFFER
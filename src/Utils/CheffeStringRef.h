@@ -0,0 +1,115 @@
+#ifndef CHEFFE_STRING_REF
+#define CHEFFE_STRING_REF
+
+#include <cctype>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+namespace cheffe
+{
+
+// A non-owning reference to a run of characters, typically somewhere inside
+// the source buffer. The referenced storage has to outlive the StringRef.
+class StringRef
+{
+private:
+  const char *Data;
+  std::size_t Length;
+
+public:
+  StringRef() : Data(nullptr), Length(0)
+  {
+  }
+
+  StringRef(const char *Str) : Data(Str), Length(Str ? std::strlen(Str) : 0)
+  {
+  }
+
+  StringRef(const char *Str, const std::size_t Len) : Data(Str), Length(Len)
+  {
+  }
+
+  StringRef(const std::string &Str) : Data(Str.data()), Length(Str.size())
+  {
+  }
+
+  const char *data() const
+  {
+    return Data;
+  }
+
+  std::size_t size() const
+  {
+    return Length;
+  }
+
+  bool empty() const
+  {
+    return Length == 0;
+  }
+
+  char operator[](const std::size_t Idx) const
+  {
+    return Data[Idx];
+  }
+
+  const char *begin() const
+  {
+    return Data;
+  }
+
+  const char *end() const
+  {
+    return Data + Length;
+  }
+
+  bool equals(const StringRef RHS) const
+  {
+    return Length == RHS.Length &&
+           (Length == 0 || std::memcmp(Data, RHS.Data, Length) == 0);
+  }
+
+  // As equals, but ignoring the case of ASCII letters.
+  bool equalsLower(const StringRef RHS) const
+  {
+    if (Length != RHS.Length)
+    {
+      return false;
+    }
+    for (std::size_t i = 0; i < Length; ++i)
+    {
+      if (std::tolower(static_cast<unsigned char>(Data[i])) !=
+          std::tolower(static_cast<unsigned char>(RHS.Data[i])))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Returns an owning copy of the referenced characters.
+  std::string str() const
+  {
+    return Length == 0 ? std::string() : std::string(Data, Length);
+  }
+
+  friend bool operator==(const StringRef LHS, const StringRef RHS)
+  {
+    return LHS.equals(RHS);
+  }
+
+  friend bool operator!=(const StringRef LHS, const StringRef RHS)
+  {
+    return !LHS.equals(RHS);
+  }
+
+  friend std::ostream &operator<<(std::ostream &OS, const StringRef Str)
+  {
+    return OS.write(Str.Data, Str.Length);
+  }
+};
+
+} // end namespace cheffe
+
+#endif // CHEFFE_STRING_REF
@@ -1,11 +1,14 @@
 #include "cheffe.h"
 #include "Driver/CheffeDriver.h"
+#include "Server/CheffeServer.h"
 #include "Parser/CheffeParser.h"
 #include "IR/CheffeProgramInfo.h"
 #include "Utils/CheffeDebugUtils.h"
 #include "Utils/CheffeFileHandler.h"
 #include "Utils/CheffeDiagnosticHandler.h"
+#include "Utils/CheffePhaseTimings.h"
 
+#include <cstdlib>
 #include <string>
 #include <cstring>
 #include <iostream>
@@ -28,6 +31,31 @@ static void printUsage()
             << "  -strict-chef on/off  Adhere strictly to the chef spec"
                                        << std::endl
             << "                       Default: off" << std::endl
+            << "  -parse-threads <n>   Number of threads to parse recipes on"
+                                       << std::endl
+            << "                       Default: 1" << std::endl
+            << "  -lazy-parsing        Only parse each recipe when it's first "
+                                       "served" << std::endl
+            << "  -verify-all          With -lazy-parsing, still parse every "
+                                       "recipe before running" << std::endl
+            << "  -serve               Check programs for an editor: read "
+                                       "JSON requests on stdin" << std::endl
+            << "                       and write diagnostics to stdout, "
+                                       "reparsing only what" << std::endl
+            << "                       each edit changed" << std::endl
+            << "  -count-work          Count the work done by the program, "
+                                       "such as steps" << std::endl
+            << "                       dispatched and bowl items copied, and "
+                                       "print the counts" << std::endl
+            << "                       to stderr on exit" << std::endl
+            << "  -time-phases         Time reading the file, lexing, "
+                                       "parsing, fixing up" << std::endl
+            << "                       scopes, linking and executing, recipe "
+                                       "by recipe, and" << std::endl
+            << "                       print the times to stderr on exit"
+                                       << std::endl
+            << "  -time-phases-json    As -time-phases, but print the times "
+                                       "as JSON" << std::endl
             << "  -help                Print usage and exit" << std::endl
             << std::endl;
   // clang-format on
@@ -38,6 +66,10 @@ int main(int argc, char **argv)
 {
   CheffeDriver Driver;
   std::string FileName;
+  bool Serve = false;
+  bool CountWork = false;
+  bool TimePhases = false;
+  bool TimePhasesJSON = false;
   for (int i = 1; i < argc; ++i)
   {
     if (!std::strcmp(argv[i], "-help"))
@@ -85,6 +117,57 @@ int main(int argc, char **argv)
       Driver.getParserOptions()->setStrictChef(StrictChef);
       continue;
     }
+    if (!std::strcmp(argv[i], "-parse-threads"))
+    {
+      if (i == argc - 1)
+      {
+        std::cerr << "Option -parse-threads expects a value" << std::endl;
+        return 1;
+      }
+
+      const char *OptionValue = argv[++i];
+      char *End = nullptr;
+      const unsigned long Threads = std::strtoul(OptionValue, &End, 10);
+      if (*End || !Threads || Threads > 1024)
+      {
+        std::cerr << "Invalid value '" << OptionValue
+                  << "' for option -parse-threads" << std::endl;
+        return 1;
+      }
+      Driver.getParserOptions()->setParseThreads(Threads);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-serve"))
+    {
+      Serve = true;
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-lazy-parsing"))
+    {
+      Driver.getParserOptions()->setLazyParsing(true);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-verify-all"))
+    {
+      Driver.getParserOptions()->setVerifyAll(true);
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-count-work"))
+    {
+      CountWork = true;
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-time-phases"))
+    {
+      TimePhases = true;
+      continue;
+    }
+    if (!std::strcmp(argv[i], "-time-phases-json"))
+    {
+      TimePhases = true;
+      TimePhasesJSON = true;
+      continue;
+    }
 
     // Input file is last in argument list
     if (i == argc - 1)
@@ -93,28 +176,62 @@ int main(int argc, char **argv)
     }
   }
 
+  if (Serve)
+  {
+    CheffeServer Server(std::cin, std::cout);
+    *Server.getDriver().getParserOptions() = *Driver.getParserOptions();
+    return Server.run() == CheffeErrorCode::CHEFFE_SUCCESS ? 0 : 1;
+  }
+
   if (FileName.empty())
   {
     std::cerr << "Error: no input file\n";
     return 1;
   }
 
-  CheffeSourceFile InFile = {FileName, ""};
-  const CheffeErrorCode Ret = CheffeFileHandler::readFile(InFile);
+  CheffePhaseTimings Timings;
+  // Startup costs are worth seeing even when the program fails to compile.
+  auto printTimings = [&]()
+  {
+    if (!TimePhases)
+    {
+      return;
+    }
+    if (TimePhasesJSON)
+    {
+      Timings.printJSON(std::cerr);
+    }
+    else
+    {
+      Timings.print(std::cerr);
+    }
+  };
+
+  CheffeSourceFile InFile;
+  CheffeErrorCode Ret;
+  {
+    CheffePhaseTimer Timer(TimePhases ? &Timings : nullptr,
+                           CheffePhase::ReadFile, std::string());
+    Ret = CheffeFileHandler::readFile(FileName, InFile);
+  }
 
   if (Ret != CheffeErrorCode::CHEFFE_SUCCESS)
   {
-    std::cerr << "Error: could not read input file '" << InFile.Name << "'\n";
+    std::cerr << "Error: could not read input file '" << FileName << "'\n";
     return 1;
   }
 
-  if (InFile.Source.empty())
+  if (InFile.empty())
   {
-    std::cerr << "Error: empty input file '" << InFile.Name << "'\n";
+    std::cerr << "Error: empty input file '" << FileName << "'\n";
     return 1;
   }
 
   Driver.setSourceFile(InFile);
+  if (TimePhases)
+  {
+    Driver.setPhaseTimings(&Timings);
+  }
 
   auto Diagnostics = std::make_shared<CheffeDiagnosticHandler>();
 
@@ -128,14 +245,28 @@ int main(int argc, char **argv)
 
   if (Success != CheffeErrorCode::CHEFFE_SUCCESS || !ProgramInfo)
   {
+    printTimings();
     std::cerr << "Error: could not parse input file\n";
     return 1;
   }
 
+  CheffeWorkCounts WorkCounts;
+  if (CountWork)
+  {
+    Driver.setWorkCounts(&WorkCounts);
+  }
+
   Success = Driver.executeProgram(ProgramInfo);
 
   Diagnostics->flushDiagnostics();
 
+  if (CountWork)
+  {
+    WorkCounts.print(std::cerr);
+  }
+
+  printTimings();
+
   if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
   {
     std::cerr << "Error: could not execute input file\n";
@@ -0,0 +1,49 @@
+#include "CheffeAllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<std::size_t> AllocationCount(0);
+
+std::size_t cheffe::getAllocationCount()
+{
+  return AllocationCount.load(std::memory_order_relaxed);
+}
+
+void *operator new(std::size_t Size)
+{
+  AllocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (void *Ptr = std::malloc(Size ? Size : 1))
+  {
+    return Ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t Size)
+{
+  return operator new(Size);
+}
+
+// The sized forms are what C++14 calls for most deletes, so they're replaced
+// too, to make sure every block goes back to the allocator it came from.
+void operator delete(void *Ptr) noexcept
+{
+  std::free(Ptr);
+}
+
+void operator delete(void *Ptr, std::size_t) noexcept
+{
+  std::free(Ptr);
+}
+
+void operator delete[](void *Ptr) noexcept
+{
+  std::free(Ptr);
+}
+
+void operator delete[](void *Ptr, std::size_t) noexcept
+{
+  std::free(Ptr);
+}
@@ -0,0 +1,15 @@
+#ifndef CHEFFE_ALLOCATION_COUNTER
+#define CHEFFE_ALLOCATION_COUNTER
+
+#include <cstddef>
+
+namespace cheffe
+{
+
+// Returns the number of calls made to the global operator new so far. The test
+// binary replaces operator new to keep this count.
+std::size_t getAllocationCount();
+
+} // end namespace cheffe
+
+#endif // CHEFFE_ALLOCATION_COUNTER
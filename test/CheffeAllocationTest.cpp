@@ -0,0 +1,325 @@
+#include "gtest/gtest.h"
+
+#include "cheffe.h"
+#include "CheffeAllocationCounter.h"
+#include "Driver/CheffeDriver.h"
+#include "IR/CheffeProgramInfo.h"
+#include "JIT/CheffeJIT.h"
+#include "Lexer/CheffeLexer.h"
+#include "Linker/CheffeLinker.h"
+#include "Utils/CheffeFileHandler.h"
+
+#include <cctype>
+#include <string>
+#include <sstream>
+#include <streambuf>
+#include <vector>
+
+struct OutputStreamRedirector
+{
+  OutputStreamRedirector()
+      : Buffer(), OldOutputStream(std::cout.rdbuf(Buffer.rdbuf()))
+  {
+  }
+
+  // Release the std::cout stream again
+  ~OutputStreamRedirector()
+  {
+    std::cout.rdbuf(OldOutputStream);
+  }
+
+  std::string getOutputString()
+  {
+    return Buffer.str();
+  }
+
+private:
+  std::stringstream Buffer;
+  std::streambuf *OldOutputStream;
+};
+
+using namespace cheffe;
+
+class AllocationTest : public ::testing::Test
+{
+public:
+  AllocationTest()
+  {
+  }
+
+  // Compiles and executes the given program, returning the number of heap
+  // allocations made while executing it.
+  void DoTest(const char *Name, std::size_t &ExecutionAllocations,
+              std::string &Output)
+  {
+    std::string DirPath = std::string(TEST_ROOT_PATH);
+    CheffeSourceFile InFile;
+
+    const CheffeErrorCode Ret =
+        CheffeFileHandler::readFile(DirPath.append(Name), InFile);
+
+    ASSERT_EQ(Ret, CheffeErrorCode::CHEFFE_SUCCESS);
+
+    ASSERT_FALSE(InFile.empty());
+
+    CheffeDriver Driver;
+    Driver.setSourceFile(InFile);
+
+    auto Diagnostics = std::make_shared<CheffeDiagnosticHandler>();
+
+    Driver.setDiagnosticHandler(Diagnostics);
+
+    auto ProgramInfo = std::unique_ptr<CheffeProgramInfo>(nullptr);
+    CheffeErrorCode Success = Driver.compileProgram(ProgramInfo);
+
+    ASSERT_EQ(Success, CheffeErrorCode::CHEFFE_SUCCESS);
+
+    OutputStreamRedirector Redirector;
+
+    const std::size_t AllocationsBefore = getAllocationCount();
+    Success = Driver.executeProgram(ProgramInfo);
+    ExecutionAllocations = getAllocationCount() - AllocationsBefore;
+
+    ASSERT_EQ(Success, CheffeErrorCode::CHEFFE_SUCCESS);
+
+    Output = Redirector.getOutputString();
+  }
+};
+
+// Both programs are identical but for the number of times they serve the
+// auxiliary recipe. Once the bowls of the first few activations are warm, no
+// further Serve should touch the heap.
+TEST_F(AllocationTest, ServeReusesBowlStorage)
+{
+  enum : unsigned
+  {
+    FewServes = 10u,
+    ManyServes = 1000u
+  };
+
+  std::size_t FewServesAllocations = 0;
+  std::string FewServesOutput;
+  DoTest("/Allocation/serve-loop-1.ch", FewServesAllocations, FewServesOutput);
+  ASSERT_EQ(FewServesOutput, "4 2");
+
+  std::size_t ManyServesAllocations = 0;
+  std::string ManyServesOutput;
+  DoTest("/Allocation/serve-loop-2.ch", ManyServesAllocations,
+         ManyServesOutput);
+  ASSERT_EQ(ManyServesOutput, "4 2");
+
+  ASSERT_EQ(ManyServesAllocations, FewServesAllocations)
+      << (ManyServes - FewServes) << " extra serves made "
+      << (ManyServesAllocations - FewServesAllocations)
+      << " extra allocations";
+}
+
+// Swallows everything written to it, without ever touching the heap.
+struct NullStreamBuffer : public std::streambuf
+{
+protected:
+  int overflow(int C) override
+  {
+    return C;
+  }
+
+  std::streamsize xsputn(const char *, std::streamsize Count) override
+  {
+    return Count;
+  }
+};
+
+struct NullOutputRedirector
+{
+  NullOutputRedirector()
+      : Buffer(), OldOutputStream(std::cout.rdbuf(&Buffer))
+  {
+  }
+
+  ~NullOutputRedirector()
+  {
+    std::cout.rdbuf(OldOutputStream);
+  }
+
+private:
+  NullStreamBuffer Buffer;
+  std::streambuf *OldOutputStream;
+};
+
+class CorpusAllocationTest : public ::testing::TestWithParam<const char *>
+{
+};
+
+// Once a program has been run a couple of times on the same JIT, its bowls and
+// dishes are all warm, so running it again shouldn't allocate at all.
+TEST_P(CorpusAllocationTest, NoAllocationsWhenWarm)
+{
+  enum : unsigned
+  {
+    WarmUpRuns = 2u
+  };
+
+  std::string DirPath = std::string(TEST_ROOT_PATH);
+  CheffeSourceFile InFile;
+
+  ASSERT_EQ(CheffeFileHandler::readFile(DirPath.append(GetParam()), InFile),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+
+  CheffeDriver Driver;
+  Driver.setSourceFile(InFile);
+
+  auto Diagnostics = std::make_shared<CheffeDiagnosticHandler>();
+  Driver.setDiagnosticHandler(Diagnostics);
+
+  auto ProgramInfo = std::unique_ptr<CheffeProgramInfo>(nullptr);
+  ASSERT_EQ(Driver.compileProgram(ProgramInfo),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+
+  CheffeJIT JIT(std::move(ProgramInfo), Diagnostics);
+
+  NullOutputRedirector Redirector;
+
+  for (unsigned i = 0; i < WarmUpRuns; ++i)
+  {
+    ASSERT_EQ(JIT.executeProgram(), CheffeErrorCode::CHEFFE_SUCCESS);
+  }
+
+  const std::size_t AllocationsBefore = getAllocationCount();
+  const CheffeErrorCode Success = JIT.executeProgram();
+  const std::size_t Allocations = getAllocationCount() - AllocationsBefore;
+
+  ASSERT_EQ(Success, CheffeErrorCode::CHEFFE_SUCCESS);
+  ASSERT_EQ(Allocations, 0u);
+}
+
+// Tokens refer straight into the source buffer, so lexing a whole program
+// shouldn't need the heap at all.
+TEST_P(CorpusAllocationTest, LexerDoesNotAllocate)
+{
+  std::string DirPath = std::string(TEST_ROOT_PATH);
+  CheffeSourceFile InFile;
+
+  ASSERT_EQ(CheffeFileHandler::readFile(DirPath.append(GetParam()), InFile),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+
+  CheffeLexer Lexer;
+  Lexer.setSourceFile(InFile);
+
+  unsigned TokenCount = 0;
+  const std::size_t AllocationsBefore = getAllocationCount();
+  for (Token Tok = Lexer.getToken(); Tok.isNot(TokenKind::EndOfFile);
+       Tok = Lexer.getToken())
+  {
+    ++TokenCount;
+  }
+  const std::size_t Allocations = getAllocationCount() - AllocationsBefore;
+
+  ASSERT_GT(TokenCount, 0u);
+  ASSERT_EQ(Allocations, 0u);
+}
+
+// Recipe titles are looked up without folding a copy of them, so linking a
+// program again, and looking its recipes up by any spelling, is heap-free.
+TEST_P(CorpusAllocationTest, RecipeLookupsDoNotAllocate)
+{
+  std::string DirPath = std::string(TEST_ROOT_PATH);
+  CheffeSourceFile InFile;
+
+  ASSERT_EQ(CheffeFileHandler::readFile(DirPath.append(GetParam()), InFile),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+
+  CheffeDriver Driver;
+  Driver.setSourceFile(InFile);
+
+  auto Diagnostics = std::make_shared<CheffeDiagnosticHandler>();
+  Driver.setDiagnosticHandler(Diagnostics);
+
+  auto ProgramInfo = std::unique_ptr<CheffeProgramInfo>(nullptr);
+  ASSERT_EQ(Driver.compileProgram(ProgramInfo),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+
+  std::vector<std::string> UpperCasedTitles;
+  for (unsigned i = 0, e = ProgramInfo->getNumRecipes(); i != e; ++i)
+  {
+    UpperCasedTitles.push_back(ProgramInfo->getRecipe(i)->getRecipeTitle());
+    for (auto &C : UpperCasedTitles.back())
+    {
+      C = std::toupper(static_cast<unsigned char>(C));
+    }
+  }
+
+  CheffeLinker Linker(Diagnostics);
+
+  const std::size_t AllocationsBefore = getAllocationCount();
+  const CheffeErrorCode Success = Linker.linkProgram(*ProgramInfo);
+  bool FoundAll = true;
+  for (unsigned i = 0, e = ProgramInfo->getNumRecipes(); i != e; ++i)
+  {
+    unsigned RecipeIdx = e;
+    FoundAll &= ProgramInfo->getRecipeIndex(UpperCasedTitles[i], RecipeIdx) &&
+                RecipeIdx == i;
+  }
+  const std::size_t Allocations = getAllocationCount() - AllocationsBefore;
+
+  ASSERT_EQ(Success, CheffeErrorCode::CHEFFE_SUCCESS);
+  ASSERT_TRUE(FoundAll);
+  ASSERT_EQ(Allocations, 0u);
+}
+
+static const char *JITExecutionCorpus[] = {
+  "/JITExecution/99-bottles.ch",
+  "/JITExecution/add-1.ch",
+  "/JITExecution/add-2.ch",
+  "/JITExecution/adddry-1.ch",
+  "/JITExecution/clean-bowl-1.ch",
+  "/JITExecution/clean-bowl-2.ch",
+  "/JITExecution/clean-bowl-3.ch",
+  "/JITExecution/combine-1.ch",
+  "/JITExecution/combine-2.ch",
+  "/JITExecution/control-flow-1.ch",
+  "/JITExecution/control-flow-2.ch",
+  "/JITExecution/control-flow-3.ch",
+  "/JITExecution/control-flow-4.ch",
+  "/JITExecution/divide-1.ch",
+  "/JITExecution/divide-2.ch",
+  "/JITExecution/exp.ch",
+  "/JITExecution/fizzbuzz.ch",
+  "/JITExecution/fold-1.ch",
+  "/JITExecution/fold-2.ch",
+  "/JITExecution/hello-cake.ch",
+  "/JITExecution/hello-full.ch",
+  "/JITExecution/hello.ch",
+  "/JITExecution/liquefy-ingr-1.ch",
+  "/JITExecution/liquefy-ingr-2.ch",
+  "/JITExecution/loops.ch",
+  "/JITExecution/mix-bowl-1.ch",
+  "/JITExecution/multi-table.ch",
+  "/JITExecution/nothing-1.ch",
+  "/JITExecution/nothing-2.ch",
+  "/JITExecution/pour-1.ch",
+  "/JITExecution/put-1.ch",
+  "/JITExecution/put-2.ch",
+  "/JITExecution/put-3.ch",
+  "/JITExecution/put-4.ch",
+  "/JITExecution/put-5.ch",
+  "/JITExecution/put-6.ch",
+  "/JITExecution/refrigerate-1.ch",
+  "/JITExecution/refrigerate-2.ch",
+  "/JITExecution/refrigerate-3.ch",
+  "/JITExecution/remove-1.ch",
+  "/JITExecution/remove-2.ch",
+  "/JITExecution/reset-ingredient-values.ch",
+  "/JITExecution/serve-1.ch",
+  "/JITExecution/serve-2.ch",
+  "/JITExecution/stir-bowl-1.ch",
+  "/JITExecution/stir-bowl-2.ch",
+  "/JITExecution/stir-bowl-3.ch",
+  "/JITExecution/stir-bowl-4.ch",
+  "/JITExecution/stir-bowl-5.ch",
+  "/JITExecution/stir-bowl-6.ch",
+  "/JITExecution/stir-bowl-7.ch",
+  "/JITExecution/stir-ingr-1.ch",
+};
+
+INSTANTIATE_TEST_CASE_P(JITExecution, CorpusAllocationTest,
+                        ::testing::ValuesIn(JITExecutionCorpus));
@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+
+#include "IR/CheffeArena.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace cheffe;
+
+TEST(ArenaTest, AllocationsAreAligned)
+{
+  CheffeArena Arena;
+  for (std::size_t Alignment = 1; Alignment <= 64; Alignment *= 2)
+  {
+    Arena.allocate(1, 1);
+    void *Ptr = Arena.allocate(8, Alignment);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(Ptr) % Alignment, 0u);
+  }
+}
+
+TEST(ArenaTest, LargeAllocations)
+{
+  CheffeArena Arena;
+  char *Small = static_cast<char *>(Arena.allocate(16, 1));
+  char *Large = static_cast<char *>(Arena.allocate(4 << 20, 1));
+  Large[(4 << 20) - 1] = 'x';
+  Small[15] = 'y';
+  ASSERT_GE(Arena.getTotalMemory(), std::size_t(4 << 20));
+  ASSERT_EQ(Arena.getBytesAllocated(), std::size_t((4 << 20) + 16));
+}
+
+struct DestructionRecorder
+{
+  DestructionRecorder(std::vector<int> &Order, const int Id)
+      : Order(Order), Id(Id)
+  {
+  }
+
+  ~DestructionRecorder()
+  {
+    Order.push_back(Id);
+  }
+
+  std::vector<int> &Order;
+  int Id;
+};
+
+TEST(ArenaTest, DestructorsRunInReverseOrder)
+{
+  std::vector<int> Order;
+  {
+    CheffeArena Arena;
+    for (int i = 0; i < 1000; ++i)
+    {
+      Arena.create<DestructionRecorder>(Order, i);
+    }
+    ASSERT_EQ(Arena.create<std::string>(100, 'a')->size(), 100u);
+    ASSERT_TRUE(Order.empty());
+  }
+
+  ASSERT_EQ(Order.size(), 1000u);
+  for (int i = 0; i < 1000; ++i)
+  {
+    ASSERT_EQ(Order[i], 999 - i);
+  }
+}
+
+TEST(ArenaTest, AdoptTakesOverAllocations)
+{
+  std::vector<int> Order;
+  {
+    CheffeArena Arena;
+    Arena.create<DestructionRecorder>(Order, 0);
+    {
+      CheffeArena Other;
+      Other.create<DestructionRecorder>(Order, 1);
+      std::string *Str = Other.create<std::string>(64, 'b');
+      Arena.adopt(Other);
+      ASSERT_EQ(Other.getBytesAllocated(), 0u);
+      ASSERT_EQ(Other.getTotalMemory(), 0u);
+      ASSERT_EQ(*Str, std::string(64, 'b'));
+    }
+    ASSERT_TRUE(Order.empty());
+  }
+
+  ASSERT_EQ(Order.size(), 2u);
+}
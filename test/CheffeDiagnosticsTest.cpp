@@ -44,21 +44,24 @@ public:
   }
 
   void DoTest(const char *Name,
-              const std::pair<unsigned, unsigned> ExpectedDiagnosticCount)
+              const std::pair<unsigned, unsigned> ExpectedDiagnosticCount,
+              const unsigned DiagnosticLimit = 0)
   {
     std::string DirPath = std::string(TEST_ROOT_PATH);
-    CheffeSourceFile InFile = {DirPath.append(Name), ""};
+    CheffeSourceFile InFile;
 
-    const CheffeErrorCode Ret = CheffeFileHandler::readFile(InFile);
+    const CheffeErrorCode Ret =
+        CheffeFileHandler::readFile(DirPath.append(Name), InFile);
 
     ASSERT_EQ(Ret, CheffeErrorCode::CHEFFE_SUCCESS);
 
-    ASSERT_FALSE(InFile.Source.empty());
+    ASSERT_FALSE(InFile.empty());
 
     CheffeDriver Driver;
     Driver.setSourceFile(InFile);
 
     auto Diagnostics = std::make_shared<CheffeDiagnosticHandler>();
+    Diagnostics->setDiagnosticLimit(DiagnosticLimit);
 
     Driver.setDiagnosticHandler(Diagnostics);
 
@@ -245,3 +248,120 @@ TEST_F(DiagnosticsTest, OrdinalIdentifiers)
 
   ASSERT_EQ(MatchCount, ExpectedWarningCount);
 }
+
+TEST_F(DiagnosticsTest, UndefinedServeRecipe)
+{
+  const std::string FileName = "/Diagnostics/undefined-recipe-serve.ch";
+  DoTest(FileName.c_str(), std::make_pair(2u, 0u));
+
+  std::string Errors = getStandardError();
+
+  std::regex DiagnosticRegex("Cannot find recipe '([^']+)' to serve");
+
+  const char *const MissingRecipes[] = {"gravy", "mint sauce"};
+  const char *const LineNos[] = {"9", "10"};
+
+  for (unsigned i = 0; i < 2; ++i)
+  {
+    std::smatch RecipeMatch;
+    ASSERT_TRUE(std::regex_search(Errors, RecipeMatch, DiagnosticRegex));
+    ASSERT_EQ(RecipeMatch.str(1), MissingRecipes[i]);
+    CheckFileNameDiagnostic(Errors, FileName, LineNos[i], "12");
+    Errors = RecipeMatch.suffix().str();
+  }
+}
+
+TEST_F(DiagnosticsTest, UndefinedIngredient1)
+{
+  const std::string FileName = "/Diagnostics/undefined-ingredient-1.ch";
+  DoTest(FileName.c_str(), std::make_pair(1u, 0u));
+
+  const std::string Errors = getStandardError();
+
+  CheckFileNameDiagnostic(Errors, FileName, "10", "5");
+  ASSERT_TRUE(std::regex_search(
+      Errors,
+      std::regex("Ingredient 'mint' was not defined in the Ingredients")));
+}
+
+// Another recipe defining an ingredient doesn't make it defined in this one.
+TEST_F(DiagnosticsTest, UndefinedIngredient2)
+{
+  const std::string FileName = "/Diagnostics/undefined-ingredient-2.ch";
+  DoTest(FileName.c_str(), std::make_pair(1u, 0u));
+
+  const std::string Errors = getStandardError();
+
+  CheckFileNameDiagnostic(Errors, FileName, "19", "5");
+  ASSERT_TRUE(std::regex_search(
+      Errors,
+      std::regex("Ingredient 'lamb' was not defined in the Ingredients")));
+}
+
+TEST_F(DiagnosticsTest, NumberTooLarge)
+{
+  const std::string FileName = "/Diagnostics/number-too-large.ch";
+  DoTest(FileName.c_str(), std::make_pair(1u, 0u));
+
+  const std::string Errors = getStandardError();
+
+  CheckFileNameDiagnostic(Errors, FileName, "8", "1");
+  ASSERT_TRUE(std::regex_search(
+      Errors, std::regex("Number '9223372036854775808' is too large")));
+}
+
+TEST_F(DiagnosticsTest, OrdinalTooLarge)
+{
+  const std::string FileName = "/Diagnostics/ordinal-too-large.ch";
+  DoTest(FileName.c_str(), std::make_pair(1u, 0u));
+
+  const std::string Errors = getStandardError();
+
+  CheckFileNameDiagnostic(Errors, FileName, "10", "19");
+  ASSERT_TRUE(
+      std::regex_search(Errors, std::regex("Number '4294967296' is too large")));
+}
+
+TEST_F(DiagnosticsTest, DiagnosticLimit)
+{
+  const std::string FileName = "/Diagnostics/undefined-recipe-serve.ch";
+  DoTest(FileName.c_str(), std::make_pair(2u, 0u), 1);
+
+  const std::string Errors = getStandardError();
+
+  CheckFileNameDiagnostic(Errors, FileName, "9", "12");
+  ASSERT_TRUE(std::regex_search(Errors, std::regex("'gravy'")));
+  ASSERT_FALSE(std::regex_search(Errors, std::regex("'mint sauce'")));
+  ASSERT_TRUE(
+      std::regex_search(Errors, std::regex("1 more diagnostics not shown")));
+}
+
+TEST_F(DiagnosticsTest, StructuredDiagnostics)
+{
+  CheffeDiagnosticHandler Diagnostics;
+  Diagnostics.setSourceFile(CheffeSourceFile(
+      CheffeSourceBuffer::getMemBuffer("<verbs>", "Sift until rubbed.")));
+
+  Diagnostics.report(SourceLocation(11, 17), diag::err_mismatched_verbs)
+      << "Sift"
+      << "rubbed";
+
+  ASSERT_EQ(Diagnostics.getErrorCount(), 1u);
+  ASSERT_EQ(Diagnostics.getWarningCount(), 0u);
+  ASSERT_EQ(Diagnostics.getDiagnostics().size(), 1u);
+
+  const CheffeDiagnostic &Diagnostic = Diagnostics.getDiagnostics().front();
+  ASSERT_EQ(Diagnostic.ID, diag::err_mismatched_verbs);
+  ASSERT_EQ(Diagnostic.SourceLoc.getBegin(), 11u);
+  ASSERT_EQ(Diagnostic.Args, std::vector<std::string>({"Sift", "rubbed"}));
+
+  // Colour codes may surround parts of the message, so only look for the
+  // uncoloured pieces.
+  const std::string Formatted = Diagnostics.formatDiagnostic(Diagnostic);
+  ASSERT_NE(Formatted.find("<verbs>:1:12: "), std::string::npos);
+  ASSERT_NE(Formatted.find(
+                ": Mismatched verbs: trying to match 'Sift' with 'rubbed'\n"
+                "Sift until rubbed.\n"),
+            std::string::npos);
+  ASSERT_NE(Formatted.find("           ~~~~~~"), std::string::npos);
+}
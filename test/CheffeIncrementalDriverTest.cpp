@@ -0,0 +1,211 @@
+#include "gtest/gtest.h"
+
+#include "cheffe.h"
+#include "Driver/CheffeIncrementalDriver.h"
+#include "IR/CheffeProgramInfo.h"
+#include "Utils/CheffeFileHandler.h"
+
+#include <random>
+#include <sstream>
+#include <string>
+
+using namespace cheffe;
+
+static std::string readTestFile(const char *Name)
+{
+  CheffeSourceFile InFile;
+  if (CheffeFileHandler::readFile(std::string(TEST_ROOT_PATH) + Name,
+                                  InFile) != CheffeErrorCode::CHEFFE_SUCCESS)
+  {
+    return std::string();
+  }
+  return InFile.getSource().str();
+}
+
+// Everything a fresh parse of the text would have to agree on.
+static std::string describe(const CheffeIncrementalDriver &Driver)
+{
+  std::ostringstream OS;
+  for (const CheffeDiagnostic &Diagnostic : Driver.getDiagnostics())
+  {
+    OS << Diagnostic.ID << "@" << Diagnostic.SourceLoc.getBegin() << "+"
+       << Diagnostic.SourceLoc.getLength() << " "
+       << CheffeDiagnosticHandler::getDiagnosticMessage(Diagnostic) << "\n";
+  }
+
+  const CheffeProgramInfo &ProgramInfo = Driver.getProgramInfo();
+  for (unsigned i = 0; i < ProgramInfo.getNumRecipes(); ++i)
+  {
+    const CheffeRecipeInfo *Recipe = ProgramInfo.getRecipe(i);
+    OS << Recipe->getRecipeTitle() << (Recipe->isLoaded() ? "" : " unloaded")
+       << " ingredients " << Recipe->getIngredients().size() << " steps "
+       << Recipe->getMethodSteps().size() << "\n";
+    for (const CheffeMethodStep *MS : Recipe->getMethodSteps())
+    {
+      if (MS->getMethodStepKind() == MethodStepKind::Serve &&
+          MS->getOperand(0).isResolved())
+      {
+        OS << "  serves " << MS->getOperand(0).getRecipeIndex() << "\n";
+      }
+    }
+  }
+  return OS.str();
+}
+
+TEST(IncrementalDriverTest, EditReparsesOnlyItsRecipe)
+{
+  const std::string Text =
+      readTestFile("/JITExecution/serve-1.ch") + "\n" +
+      readTestFile("/JITExecution/reset-ingredient-values.ch");
+  ASSERT_FALSE(Text.empty());
+
+  CheffeIncrementalDriver Driver;
+  Driver.openDocument("test.ch", Text);
+  ASSERT_TRUE(Driver.getDiagnostics().empty());
+  const unsigned NumRecipes = Driver.getNumRecipeRanges();
+  ASSERT_GT(NumRecipes, 2u);
+  ASSERT_EQ(Driver.getNumRecipesParsed(), NumRecipes);
+
+  std::vector<const CheffeRecipeInfo *> Before;
+  for (unsigned i = 0; i < Driver.getProgramInfo().getNumRecipes(); ++i)
+  {
+    Before.push_back(Driver.getProgramInfo().getRecipe(i));
+  }
+
+  // Misspell a method step in the second recipe.
+  const std::size_t Offset = Text.find("Add milk");
+  ASSERT_NE(Offset, std::string::npos);
+  ASSERT_EQ(Driver.applyEdit(Offset, 3, "Stirr"),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+  ASSERT_EQ(Driver.getNumRecipesParsed(), 1u);
+  ASSERT_EQ(Driver.getNumRecipeRanges(), NumRecipes);
+
+  auto Diagnostics = Driver.getDiagnostics();
+  ASSERT_EQ(Diagnostics.size(), 1u);
+  ASSERT_EQ(Diagnostics[0].ID, diag::err_invalid_method_step);
+  ASSERT_EQ(Diagnostics[0].SourceLoc.getBegin(), Offset);
+
+  for (unsigned i = 0; i < Driver.getProgramInfo().getNumRecipes(); ++i)
+  {
+    if (i != 1)
+    {
+      ASSERT_EQ(Driver.getProgramInfo().getRecipe(i), Before[i]);
+    }
+  }
+  ASSERT_FALSE(Driver.getProgramInfo().getRecipe(1u)->isLoaded());
+
+  // Text added before it moves the diagnostic along, without reparsing
+  // anything but the recipe the text was added to.
+  ASSERT_EQ(Driver.applyEdit(0, 0, "\n\n"), CheffeErrorCode::CHEFFE_SUCCESS);
+  ASSERT_EQ(Driver.getNumRecipesParsed(), 1u);
+  Diagnostics = Driver.getDiagnostics();
+  ASSERT_EQ(Diagnostics.size(), 1u);
+  ASSERT_EQ(Diagnostics[0].SourceLoc.getBegin(), Offset + 2);
+
+  // Out-of-bounds edits change nothing.
+  ASSERT_EQ(Driver.applyEdit(Driver.getText().size() + 1, 0, "x"),
+            CheffeErrorCode::CHEFFE_ERROR);
+  ASSERT_EQ(Driver.applyEdit(2, Driver.getText().size(), ""),
+            CheffeErrorCode::CHEFFE_ERROR);
+  ASSERT_EQ(Driver.getDiagnostics().size(), 1u);
+}
+
+TEST(IncrementalDriverTest, RecipeTitlesAreRelinked)
+{
+  const std::string Text = readTestFile("/JITExecution/serve-1.ch");
+  CheffeIncrementalDriver Driver;
+  Driver.openDocument("test.ch", Text);
+  ASSERT_TRUE(Driver.getDiagnostics().empty());
+
+  // Renaming the served recipe breaks the Serve step, without reparsing the
+  // recipe the step is in.
+  const std::size_t Offset = Text.find("Bread Sauce.\n\nA pretty");
+  ASSERT_NE(Offset, std::string::npos);
+  ASSERT_EQ(Driver.applyEdit(Offset, 5, "Onion"),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+  ASSERT_EQ(Driver.getNumRecipesParsed(), 1u);
+  auto Diagnostics = Driver.getDiagnostics();
+  ASSERT_EQ(Diagnostics.size(), 1u);
+  ASSERT_EQ(Diagnostics[0].ID, diag::err_undefined_serve_recipe);
+
+  // Renaming it to the calling recipe's title makes it a duplicate.
+  ASSERT_EQ(Driver.applyEdit(Offset, 11, "Carrots & Sprouts with Bread Sauce"),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+  Diagnostics = Driver.getDiagnostics();
+  ASSERT_EQ(Diagnostics.size(), 2u);
+  ASSERT_EQ(Diagnostics[0].ID, diag::err_undefined_serve_recipe);
+  ASSERT_EQ(Diagnostics[1].ID, diag::err_duplicate_recipe);
+  ASSERT_EQ(Diagnostics[1].SourceLoc.getBegin(), Offset);
+
+  ASSERT_EQ(Driver.applyEdit(Offset, 34, "Bread Sauce"),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+  ASSERT_TRUE(Driver.getDiagnostics().empty());
+}
+
+// A comment starting with 'Method.', or a recipe titled 'Method.', mustn't be
+// taken for the end of a recipe, which would split the recipe in two and
+// report errors in a valid program.
+TEST(IncrementalDriverTest, MethodCommentDoesNotSplitRecipe)
+{
+  const std::string Text = readTestFile("/JITExecution/method-comment.ch");
+  ASSERT_FALSE(Text.empty());
+
+  CheffeIncrementalDriver Driver;
+  Driver.openDocument("test.ch", Text);
+  ASSERT_EQ(describe(Driver), "Hello ingredients 1 steps 5\n"
+                              "  serves 1\n"
+                              "  serves 2\n"
+                              "Sauce ingredients 1 steps 1\n"
+                              "Method ingredients 1 steps 1\n");
+  ASSERT_EQ(Driver.getNumRecipeRanges(), 3u);
+
+  // Editing the comment only reparses the recipe it's in.
+  const std::size_t Offset = Text.find("So does");
+  ASSERT_NE(Offset, std::string::npos);
+  ASSERT_EQ(Driver.applyEdit(Offset, 2, "And so"),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+  ASSERT_EQ(Driver.getNumRecipesParsed(), 1u);
+  ASSERT_TRUE(Driver.getDiagnostics().empty());
+  ASSERT_EQ(Driver.getNumRecipeRanges(), 3u);
+}
+
+// However the text gets to where it is, the result has to be the same as
+// opening that text from scratch.
+TEST(IncrementalDriverTest, EditsMatchFreshParse)
+{
+  const std::string Text = readTestFile("/JITExecution/serve-1.ch") + "\n" +
+                           readTestFile("/JITExecution/99-bottles.ch") +
+                           "\n" + readTestFile("/JITExecution/fizzbuzz.ch");
+  const char *Insertions[] = {"x",
+                              "\n",
+                              "\n\n",
+                              ".",
+                              " ",
+                              "Put flour into mixing bowl.\n",
+                              "Method.\n",
+                              "\n\nServes 2.\n\n",
+                              "\n\nSide Dish.\n\nIngredients.\n1 g salt\n\n"
+                              "Method.\nPut salt into mixing bowl.\n\n"};
+
+  CheffeIncrementalDriver Driver;
+  Driver.openDocument("test.ch", Text);
+
+  std::mt19937 Generator(42);
+  for (unsigned i = 0; i < 300; ++i)
+  {
+    const std::string &Current = Driver.getText();
+    const std::size_t Offset = Generator() % (Current.size() + 1);
+    const std::size_t Length =
+        std::min<std::size_t>(Generator() % 8, Current.size() - Offset);
+    const std::string Insertion =
+        (Generator() % 3) ? Insertions[Generator() % 9] : "";
+
+    ASSERT_EQ(Driver.applyEdit(Offset, Length, Insertion),
+              CheffeErrorCode::CHEFFE_SUCCESS);
+
+    CheffeIncrementalDriver Fresh;
+    Fresh.openDocument("test.ch", Driver.getText());
+    ASSERT_EQ(describe(Driver), describe(Fresh)) << "after edit " << i;
+    ASSERT_LE(Driver.getNumRecipesParsed(), Fresh.getNumRecipesParsed());
+  }
+}
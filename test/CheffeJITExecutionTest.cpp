@@ -4,7 +4,11 @@
 #include "Driver/CheffeDriver.h"
 #include "Parser/CheffeParser.h"
 #include "IR/CheffeProgramInfo.h"
+#include "JIT/CheffeJIT.h"
+#include "JIT/CheffeWorkCounts.h"
 #include "Utils/CheffeFileHandler.h"
+#include "Utils/CheffeJSON.h"
+#include "Utils/CheffePhaseTimings.h"
 
 #include <set>
 #include <string>
@@ -53,19 +57,21 @@ public:
   {
   }
 
-  void DoTest(const char *Name)
+  void DoTest(const char *Name, const bool LazyParsing = false)
   {
     std::string DirPath = std::string(TEST_ROOT_PATH);
-    CheffeSourceFile InFile = {DirPath.append(Name), ""};
+    CheffeSourceFile InFile;
 
-    const CheffeErrorCode Ret = CheffeFileHandler::readFile(InFile);
+    const CheffeErrorCode Ret =
+        CheffeFileHandler::readFile(DirPath.append(Name), InFile);
 
     ASSERT_EQ(Ret, CheffeErrorCode::CHEFFE_SUCCESS);
 
-    ASSERT_FALSE(InFile.Source.empty());
+    ASSERT_FALSE(InFile.empty());
 
     CheffeDriver Driver;
     Driver.setSourceFile(InFile);
+    Driver.getParserOptions()->setLazyParsing(LazyParsing);
 
     auto Diagnostics = std::make_shared<CheffeDiagnosticHandler>();
 
@@ -635,3 +641,332 @@ TEST_F(JITExecutionTest, ResetIngredientValues)
   const std::string Output = getStandardOut();
   ASSERT_EQ(Output, "2 2 2");
 }
+
+TEST_F(JITExecutionTest, LargeNumbers)
+{
+  const std::string FileName = "/JITExecution/large-numbers.ch";
+  DoTest(FileName.c_str());
+  const std::string Output = getStandardOut();
+  ASSERT_EQ(Output, "999999999999999999 1 9223372036854775807");
+}
+
+TEST_F(JITExecutionTest, StepCount)
+{
+  CheffeSourceFile InFile;
+  ASSERT_EQ(CheffeFileHandler::readFile(std::string(TEST_ROOT_PATH) +
+                                            "/JITExecution/step-count.ch",
+                                        InFile),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+
+  CheffeDriver Driver;
+  Driver.setSourceFile(InFile);
+  auto Diagnostics = std::make_shared<CheffeDiagnosticHandler>();
+  Driver.setDiagnosticHandler(Diagnostics);
+
+  auto ProgramInfo = std::unique_ptr<CheffeProgramInfo>(nullptr);
+  ASSERT_EQ(Driver.compileProgram(ProgramInfo),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+
+  CheffeWorkCounts Counts;
+  CheffeJIT JIT(std::move(ProgramInfo), Diagnostics);
+  JIT.setWorkCounts(&Counts);
+  ASSERT_EQ(Counts.getNumStepsDispatched(), 0u);
+  ASSERT_EQ(JIT.executeProgram(), CheffeErrorCode::CHEFFE_SUCCESS);
+  ASSERT_EQ(Counts.getNumStepsDispatched(), 10u);
+
+  // The count carries on over runs.
+  ASSERT_EQ(JIT.executeProgram(), CheffeErrorCode::CHEFFE_SUCCESS);
+  ASSERT_EQ(Counts.getNumStepsDispatched(), 20u);
+  ASSERT_EQ(getStandardOut(), "1 1 11 1 1");
+}
+
+TEST_F(JITExecutionTest, WorkCounts)
+{
+  CheffeSourceFile InFile;
+  ASSERT_EQ(CheffeFileHandler::readFile(std::string(TEST_ROOT_PATH) +
+                                            "/JITExecution/work-counts.ch",
+                                        InFile),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+
+  CheffeDriver Driver;
+  Driver.setSourceFile(InFile);
+  auto Diagnostics = std::make_shared<CheffeDiagnosticHandler>();
+  Driver.setDiagnosticHandler(Diagnostics);
+
+  auto ProgramInfo = std::unique_ptr<CheffeProgramInfo>(nullptr);
+  ASSERT_EQ(Driver.compileProgram(ProgramInfo),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+
+  CheffeWorkCounts Counts;
+  CheffeJIT JIT(std::move(ProgramInfo), Diagnostics);
+  JIT.setWorkCounts(&Counts);
+  ASSERT_EQ(JIT.executeProgram(), CheffeErrorCode::CHEFFE_SUCCESS);
+  ASSERT_EQ(getStandardOut(), "A 10 -7 3 10 -7 3");
+
+  auto getSteps = [&Counts](const MethodStepKind Kind) {
+    return Counts.StepsDispatched[static_cast<unsigned>(Kind)];
+  };
+  ASSERT_EQ(Counts.getNumStepsDispatched(), 12u);
+  ASSERT_EQ(getSteps(MethodStepKind::Put), 6u);
+  ASSERT_EQ(getSteps(MethodStepKind::Remove), 1u);
+  ASSERT_EQ(getSteps(MethodStepKind::StirBowl), 1u);
+  ASSERT_EQ(getSteps(MethodStepKind::Mix), 1u);
+  ASSERT_EQ(getSteps(MethodStepKind::Clean), 1u);
+  ASSERT_EQ(getSteps(MethodStepKind::Serve), 1u);
+  ASSERT_EQ(getSteps(MethodStepKind::Pour), 1u);
+
+  // Seven pushes, a pop and a push for the Remove, a pop and an insertion for
+  // the Stir, and seven pops off the baking dish to output.
+  ASSERT_EQ(Counts.ElementsMoved, 17u);
+  // Three items to the side dish, four back again, seven poured, and seven
+  // handed back from the main recipe on exit.
+  ASSERT_EQ(Counts.ElementsCopied, 21u);
+  // Two items stirred under, and two mixed.
+  ASSERT_EQ(Counts.ElementsShifted, 4u);
+  ASSERT_EQ(Counts.BytesOutput, 17u);
+  ASSERT_EQ(Counts.FramesCreated, 2u);
+
+  // Without somewhere to count into, nothing is counted.
+  JIT.setWorkCounts(nullptr);
+  ASSERT_EQ(JIT.executeProgram(), CheffeErrorCode::CHEFFE_SUCCESS);
+  ASSERT_EQ(Counts.getNumStepsDispatched(), 12u);
+  ASSERT_EQ(Counts.ElementsCopied, 21u);
+}
+
+TEST_F(JITExecutionTest, WorkCountsScaleLinearly)
+{
+  // Stirring a bowl only shifts the items the stirred one goes under, and
+  // serving a recipe copies each of the caller's items once, however many
+  // times round the loop.
+  std::string Source = "Stirring.\n\nIngredients.\n";
+  Source += "1 g one\n";
+  Source += "200 g rounds\n\nMethod.\n";
+  Source += "Put one into the mixing bowl.\n";
+  Source += "Sift the rounds.\n";
+  Source += "Put one into the mixing bowl.\n";
+  Source += "Stir the mixing bowl for 3 minutes.\n";
+  Source += "Serve with Nothing.\n";
+  Source += "Sift the rounds until sifted.\n\n";
+  Source += "Nothing.\n\nIngredients.\n1 g crumb\n\nMethod.\n";
+  Source += "Clean the mixing bowl.\n";
+
+  const CheffeSourceFile InFile(
+      CheffeSourceBuffer::getMemBuffer("stirring.ch", Source));
+  CheffeDriver Driver;
+  Driver.setSourceFile(InFile);
+  auto Diagnostics = std::make_shared<CheffeDiagnosticHandler>();
+  Driver.setDiagnosticHandler(Diagnostics);
+
+  auto ProgramInfo = std::unique_ptr<CheffeProgramInfo>(nullptr);
+  ASSERT_EQ(Driver.compileProgram(ProgramInfo),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+
+  CheffeWorkCounts Counts;
+  CheffeJIT JIT(std::move(ProgramInfo), Diagnostics);
+  JIT.setWorkCounts(&Counts);
+  ASSERT_EQ(JIT.executeProgram(), CheffeErrorCode::CHEFFE_SUCCESS);
+
+  // The first two rounds stir under the one and two items there are; every
+  // other round stirs under three.
+  ASSERT_EQ(Counts.ElementsShifted, 1u + 2u + 198u * 3);
+  // Round N serves with N + 1 items in the bowl, the served recipe hands
+  // nothing back, and the main recipe hands back all 201 on exit.
+  ASSERT_EQ(Counts.ElementsCopied, 200u * 201 / 2 + 200 + 201);
+  ASSERT_EQ(Counts.FramesCreated, 201u);
+}
+
+// Returns the recipes timed in Phase, in the order they were first timed.
+static std::vector<std::string>
+getTimedRecipes(const CheffePhaseTimings &Timings, const CheffePhase Phase)
+{
+  std::vector<std::string> Recipes;
+  for (const auto &Entry : Timings.getRecipeTimes(Phase))
+  {
+    EXPECT_GE(Entry.second.WallSeconds, 0.0);
+    EXPECT_GE(Entry.second.CPUSeconds, 0.0);
+    Recipes.push_back(Entry.first);
+  }
+  return Recipes;
+}
+
+TEST_F(JITExecutionTest, PhaseTimings)
+{
+  CheffeSourceFile InFile;
+  ASSERT_EQ(CheffeFileHandler::readFile(std::string(TEST_ROOT_PATH) +
+                                            "/JITExecution/work-counts.ch",
+                                        InFile),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+
+  const std::vector<std::string> Both = {"Work Counts", "Side Dish"};
+  const std::vector<std::string> WithProgram = {"", "Work Counts",
+                                                "Side Dish"};
+
+  // Sequentially, on two threads, and lazily.
+  for (unsigned Mode = 0; Mode < 3; ++Mode)
+  {
+    CheffeDriver Driver;
+    Driver.setSourceFile(InFile);
+    Driver.getParserOptions()->setParseThreads(Mode == 1 ? 2 : 1);
+    Driver.getParserOptions()->setLazyParsing(Mode == 2);
+    Driver.getParserOptions()->setVerifyAll(Mode == 2);
+    auto Diagnostics = std::make_shared<CheffeDiagnosticHandler>();
+    Driver.setDiagnosticHandler(Diagnostics);
+
+    CheffePhaseTimings Timings;
+    Driver.setPhaseTimings(&Timings);
+
+    auto ProgramInfo = std::unique_ptr<CheffeProgramInfo>(nullptr);
+    ASSERT_EQ(Driver.compileProgram(ProgramInfo),
+              CheffeErrorCode::CHEFFE_SUCCESS);
+    const std::size_t Begin = getStandardOut().length();
+    ASSERT_EQ(Driver.executeProgram(ProgramInfo),
+              CheffeErrorCode::CHEFFE_SUCCESS);
+    ASSERT_EQ(getStandardOut().substr(Begin), "A 10 -7 3 10 -7 3");
+
+    // Finding the recipes up front is charged to the whole program.
+    ASSERT_EQ(getTimedRecipes(Timings, CheffePhase::Parse),
+              Mode ? WithProgram : Both)
+        << Mode;
+    ASSERT_EQ(getTimedRecipes(Timings, CheffePhase::Lex), Both) << Mode;
+    ASSERT_EQ(getTimedRecipes(Timings, CheffePhase::ScopeFixup), Both)
+        << Mode;
+    ASSERT_EQ(getTimedRecipes(Timings, CheffePhase::Link), Both) << Mode;
+
+    // The side dish finishes running first, so it's timed first.
+    const std::vector<std::string> Executed = {"Side Dish", "Work Counts"};
+    ASSERT_EQ(getTimedRecipes(Timings, CheffePhase::Execute), Executed)
+        << Mode;
+
+    // The driver doesn't read the file itself.
+    ASSERT_TRUE(getTimedRecipes(Timings, CheffePhase::ReadFile).empty());
+  }
+}
+
+TEST_F(JITExecutionTest, PhaseTimingsJSON)
+{
+  CheffePhaseTimings Timings;
+  Timings.addTimes(CheffePhase::ReadFile, std::string(), CheffeTimes());
+  CheffeTimes Times;
+  Times.WallSeconds = 0.25;
+  Times.CPUSeconds = 0.125;
+  Timings.addTimes(CheffePhase::Execute, "Main", Times);
+  Timings.addTimes(CheffePhase::Execute, "Main", Times);
+  Timings.addTimes(CheffePhase::Execute, "Served", Times);
+
+  std::ostringstream OS;
+  Timings.printJSON(OS);
+
+  JSONValue Value;
+  std::string Error;
+  ASSERT_TRUE(JSONValue::parse(OS.str(), Value, Error)) << Error;
+
+  // Phases that never ran are left out.
+  const std::vector<JSONValue> &Phases = Value.get("phases")->getArray();
+  ASSERT_EQ(Phases.size(), 2u);
+  ASSERT_EQ(Phases[0].get("phase")->getString(), "read-file");
+  ASSERT_TRUE(Phases[0].get("recipes")->getArray()[0].get("recipe")->isNull());
+
+  ASSERT_EQ(Phases[1].get("phase")->getString(), "execute");
+  ASSERT_EQ(Phases[1].get("wall_ms")->getNumber(), 750.0);
+  ASSERT_EQ(Phases[1].get("cpu_ms")->getNumber(), 375.0);
+  const std::vector<JSONValue> &Recipes = Phases[1].get("recipes")->getArray();
+  ASSERT_EQ(Recipes.size(), 2u);
+  ASSERT_EQ(Recipes[0].get("recipe")->getString(), "Main");
+  ASSERT_EQ(Recipes[0].get("wall_ms")->getNumber(), 500.0);
+  ASSERT_EQ(Recipes[1].get("recipe")->getString(), "Served");
+  ASSERT_EQ(Recipes[1].get("cpu_ms")->getNumber(), 125.0);
+
+  ASSERT_EQ(Value.get("total")->get("wall_ms")->getNumber(), 750.0);
+}
+
+TEST_F(JITExecutionTest, LazyParsingMatchesEager)
+{
+  const char *FileNames[] = {
+      "/JITExecution/serve-1.ch",   "/JITExecution/serve-2.ch",
+      "/JITExecution/exp.ch",       "/JITExecution/99-bottles.ch",
+      "/JITExecution/fizzbuzz.ch",  "/JITExecution/multi-table.ch",
+      "/JITExecution/hello-full.ch", "/JITExecution/method-comment.ch",
+      "/JITExecution/serves-then-title.ch"};
+
+  for (const char *FileName : FileNames)
+  {
+    const std::size_t Begin = getStandardOut().length();
+    DoTest(FileName);
+    const std::string Eager = getStandardOut().substr(Begin);
+    DoTest(FileName, /*LazyParsing*/ true);
+    const std::string Lazy = getStandardOut().substr(Begin + Eager.length());
+
+    ASSERT_EQ(Eager, Lazy) << FileName;
+  }
+}
+
+// The pre-scan splits this program in the wrong place, as the next recipe's
+// title follows straight on from the Serves statement, so lazy parsing has to
+// parse it in full instead.
+TEST_F(JITExecutionTest, LazyParsingFallsBackOnBadIndex)
+{
+  const std::string FileName =
+      std::string(TEST_ROOT_PATH) + "/JITExecution/serves-then-title.ch";
+  CheffeSourceFile InFile;
+  ASSERT_EQ(CheffeFileHandler::readFile(FileName, InFile),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+
+  CheffeDriver Driver;
+  Driver.setSourceFile(InFile);
+  auto Diagnostics = std::make_shared<CheffeDiagnosticHandler>();
+  Driver.setDiagnosticHandler(Diagnostics);
+  Driver.getParserOptions()->setLazyParsing(true);
+
+  std::unique_ptr<CheffeProgramInfo> ProgramInfo;
+  ASSERT_EQ(Driver.compileProgram(ProgramInfo),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+  ASSERT_TRUE(Diagnostics->getDiagnostics().empty());
+  ASSERT_EQ(ProgramInfo->getNumRecipes(), 2u);
+  ASSERT_TRUE(ProgramInfo->getRecipe(1u)->isLoaded());
+
+  ASSERT_EQ(Driver.executeProgram(ProgramInfo),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+  ASSERT_EQ(getStandardOut(), "H");
+}
+
+TEST_F(JITExecutionTest, LazyParsingSkipsUnservedRecipes)
+{
+  CheffeSourceFile InFile;
+  ASSERT_EQ(CheffeFileHandler::readFile(std::string(TEST_ROOT_PATH) +
+                                            "/JITExecution/lazy-parsing-1.ch",
+                                        InFile),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+
+  auto Compile = [&](const bool LazyParsing, const bool VerifyAll,
+                     std::unique_ptr<CheffeProgramInfo> &ProgramInfo)
+  {
+    CheffeDriver Driver;
+    Driver.setSourceFile(InFile);
+    Driver.setDiagnosticHandler(std::make_shared<CheffeDiagnosticHandler>());
+    Driver.getParserOptions()->setLazyParsing(LazyParsing);
+    Driver.getParserOptions()->setVerifyAll(VerifyAll);
+    return Driver.compileProgram(ProgramInfo);
+  };
+
+  std::unique_ptr<CheffeProgramInfo> ProgramInfo;
+
+  // The broken recipe is only reported if it gets parsed.
+  ASSERT_EQ(Compile(false, false, ProgramInfo), CheffeErrorCode::CHEFFE_ERROR);
+  ASSERT_EQ(Compile(true, true, ProgramInfo), CheffeErrorCode::CHEFFE_ERROR);
+
+  ASSERT_EQ(Compile(true, false, ProgramInfo),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+  ASSERT_EQ(ProgramInfo->getNumRecipes(), 3u);
+  ASSERT_TRUE(ProgramInfo->getRecipe(0u)->isLoaded());
+  ASSERT_FALSE(ProgramInfo->getRecipe(1u)->isLoaded());
+  ASSERT_FALSE(ProgramInfo->getRecipe(2u)->isLoaded());
+  ASSERT_EQ(ProgramInfo->getRecipe(2u)->getRecipeTitle(), "Burnt Toast");
+
+  ASSERT_EQ(ProgramInfo->loadRecipe(1), CheffeErrorCode::CHEFFE_SUCCESS);
+  ASSERT_TRUE(ProgramInfo->getRecipe(1u)->isLoaded());
+  ASSERT_EQ(ProgramInfo->getRecipe(1u)->getMethodSteps().size(), 1u);
+  ASSERT_EQ(ProgramInfo->loadRecipe(2), CheffeErrorCode::CHEFFE_ERROR);
+
+  DoTest("/JITExecution/lazy-parsing-1.ch", /*LazyParsing*/ true);
+  ASSERT_EQ(getStandardOut(), "120 20");
+}
@@ -0,0 +1,46 @@
+#include "gtest/gtest.h"
+
+#include "Parser/CheffeKeywords.h"
+
+using namespace cheffe;
+
+template <typename TableTy, typename EntryTy, std::size_t N>
+static void checkEveryEntryIsFound(const TableTy &Table,
+                                   const EntryTy (&Entries)[N])
+{
+  for (const EntryTy &Entry : Entries)
+  {
+    ASSERT_EQ(Table.lookup(Entry.Name), &Entry) << Entry.Name;
+  }
+}
+
+TEST(KeywordsTest, EveryKeywordIsFound)
+{
+  checkEveryEntryIsFound(MethodStepKeywords, MethodStepKeywordEntries);
+  checkEveryEntryIsFound(VerbKeywords, VerbKeywordEntries);
+  checkEveryEntryIsFound(MeasureKeywords, MeasureKeywordEntries);
+  checkEveryEntryIsFound(MeasureTypeKeywords, MeasureTypeKeywordEntries);
+  checkEveryEntryIsFound(TimeUnitKeywords, TimeUnitKeywordEntries);
+}
+
+TEST(KeywordsTest, NonKeywordsAreRejected)
+{
+  ASSERT_EQ(MethodStepKeywords.lookup("take"), nullptr);
+  ASSERT_EQ(MethodStepKeywords.lookup("Tak"), nullptr);
+  ASSERT_EQ(MethodStepKeywords.lookup("Takes"), nullptr);
+  ASSERT_EQ(MethodStepKeywords.lookup(""), nullptr);
+  ASSERT_EQ(VerbKeywords.lookup("Take"), nullptr);
+  ASSERT_EQ(VerbKeywords.lookup("Sifted"), nullptr);
+  ASSERT_EQ(MeasureKeywords.lookup("gram"), nullptr);
+  ASSERT_EQ(MeasureTypeKeywords.lookup("heap"), nullptr);
+  ASSERT_EQ(TimeUnitKeywords.lookup("second"), nullptr);
+}
+
+TEST(KeywordsTest, EntriesCarryTheirData)
+{
+  ASSERT_EQ(MethodStepKeywords.lookup("Liquify")->Kind,
+            MethodStepKeywordKind::Liquify);
+  ASSERT_STREQ(VerbKeywords.lookup("Grind")->PastTense, "Ground");
+  ASSERT_EQ(MeasureKeywords.lookup("dashes")->Kind, MeasureKindTy::Wet);
+  ASSERT_STREQ(TimeUnitKeywords.lookup("minutes")->Singular, "minute");
+}
@@ -8,6 +8,7 @@
 
 #include <string>
 #include <fstream>
+#include <sstream>
 
 using namespace cheffe;
 
@@ -21,13 +22,14 @@ public:
   void DoTest(const char *name, CheffeErrorCode &Error)
   {
     std::string DirPath = std::string(TEST_ROOT_PATH);
-    CheffeSourceFile InFile = {DirPath.append(name), ""};
+    CheffeSourceFile InFile;
 
-    const CheffeErrorCode Ret = CheffeFileHandler::readFile(InFile);
+    const CheffeErrorCode Ret =
+        CheffeFileHandler::readFile(DirPath.append(name), InFile);
 
     ASSERT_EQ(Ret, CheffeErrorCode::CHEFFE_SUCCESS);
 
-    ASSERT_FALSE(InFile.Source.empty());
+    ASSERT_FALSE(InFile.empty());
 
     CheffeDriver Driver;
     Driver.setSourceFile(InFile);
@@ -273,6 +275,16 @@ TEST_F(BadParserTest, BadScopes6)
   TestParse("/Parser/bad-scopes-6.ch");
 }
 
+TEST_F(BadParserTest, BadScopes7)
+{
+  TestParse("/Parser/bad-scopes-7.ch");
+}
+
+TEST_F(BadParserTest, DuplicateRecipeTitle)
+{
+  TestParse("/Parser/duplicate-recipe-title.ch");
+}
+
 TEST_F(ParserTest, TestOrdinalSuffixes)
 {
   ASSERT_TRUE(CheffeParser::isValidOrdinalIdentifier(1, "st"));
@@ -349,3 +361,114 @@ TEST_F(ParserTest, TestOrdinalSuffixes)
     expected_suffix.clear();
   }
 }
+
+TEST_F(ParserTest, RecipeRanges)
+{
+  const std::string Source = "First.\n"
+                             "\n"
+                             "Ingredients.\n"
+                             "1 g sugar\n"
+                             "\n"
+                             "Method.\n"
+                             "Put sugar into the mixing bowl.\n"
+                             "  \n"
+                             "Serves 1.\n"
+                             "\n"
+                             "\n"
+                             "Second.\n"
+                             "\n"
+                             "Method is a comment.\n"
+                             "\n"
+                             "Ingredients.\n"
+                             "1 g salt\n"
+                             "\n"
+                             "Method .\n"
+                             "Put salt into the mixing bowl.\n"
+                             "\n"
+                             "Third.\n";
+
+  const std::vector<SourceLocation> Ranges =
+      CheffeParser::findRecipeRanges(Source);
+
+  const std::size_t Second = Source.find("Second.");
+  const std::size_t Third = Source.find("Third.");
+  ASSERT_EQ(Ranges.size(), 3u);
+  EXPECT_EQ(Ranges[0].getBegin(), 0u);
+  EXPECT_EQ(Ranges[0].getEnd(), Second);
+  EXPECT_EQ(Ranges[1].getBegin(), Second);
+  EXPECT_EQ(Ranges[1].getEnd(), Third);
+  EXPECT_EQ(Ranges[2].getBegin(), Third);
+  EXPECT_EQ(Ranges[2].getEnd(), Source.size());
+}
+
+// Parses a program on the given number of threads, and describes everything
+// that was parsed, in order, even if it didn't all parse.
+static std::string parseAndDescribe(const char *Name, const unsigned Threads,
+                                    std::string &DiagnosticIDs)
+{
+  std::string DirPath = std::string(TEST_ROOT_PATH);
+  CheffeSourceFile InFile;
+  if (CheffeFileHandler::readFile(DirPath.append(Name), InFile) !=
+      CheffeErrorCode::CHEFFE_SUCCESS)
+  {
+    return "<unreadable>";
+  }
+
+  CheffeParser Parser;
+  auto Diagnostics = std::make_shared<CheffeDiagnosticHandler>();
+  Parser.setSourceFile(InFile);
+  Parser.setDiagnosticHandler(Diagnostics);
+  Parser.getOptions()->setParseThreads(Threads);
+
+  const CheffeErrorCode Success = Parser.parseProgram();
+  for (auto &Diagnostic : Diagnostics->getDiagnostics())
+  {
+    DiagnosticIDs += std::to_string(Diagnostic.ID) + "@" +
+                     std::to_string(Diagnostic.SourceLoc.getBegin()) + " ";
+  }
+
+  auto ProgramInfo = Parser.takeProgramInfo();
+  std::ostringstream OS;
+  if (Success != CheffeErrorCode::CHEFFE_SUCCESS)
+  {
+    OS << "<error>\n";
+  }
+  for (unsigned i = 0; i < ProgramInfo->getNumRecipes(); ++i)
+  {
+    const CheffeRecipeInfo *Recipe = ProgramInfo->getRecipe(i);
+    OS << Recipe->getRecipeTitle() << " serves " << Recipe->getServesNo()
+       << "\n";
+    for (auto &Ingredient : Recipe->getIngredients())
+    {
+      OS << "  " << Ingredient.first << " "
+         << ProgramInfo->getSymbolTable().getName(Ingredient.first) << " "
+         << *Ingredient.second << "\n";
+    }
+    for (auto *MethodStep : Recipe->getMethodSteps())
+    {
+      OS << "  " << *MethodStep;
+    }
+  }
+  return OS.str();
+}
+
+TEST_F(ParserTest, ParallelParseMatchesSequential)
+{
+  const char *Names[] = {"/JITExecution/99-bottles.ch",
+                         "/JITExecution/fizzbuzz.ch",
+                         "/Parser/method-step-serve.ch",
+                         "/Parser/sections-whitespace.ch",
+                         "/Parser/duplicate-recipe-title.ch",
+                         "/Parser/later-recipe-error.ch",
+                         "/Diagnostics/undefined-recipe-serve.ch"};
+  for (const char *Name : Names)
+  {
+    std::string SequentialDiagnostics;
+    std::string ParallelDiagnostics;
+    const std::string Sequential =
+        parseAndDescribe(Name, 1, SequentialDiagnostics);
+    const std::string Parallel = parseAndDescribe(Name, 4, ParallelDiagnostics);
+    EXPECT_EQ(Sequential, Parallel) << Name;
+    EXPECT_EQ(SequentialDiagnostics, ParallelDiagnostics) << Name;
+  }
+}
@@ -0,0 +1,67 @@
+#include "gtest/gtest.h"
+
+#include "CheffeRecipeGenerator.h"
+#include "Driver/CheffeDriver.h"
+#include "IR/CheffeProgramInfo.h"
+#include "Utils/CheffeFileHandler.h"
+
+#include <string>
+
+using namespace cheffe;
+
+// Compiles a generated program, which should go through without a single
+// diagnostic.
+static void compileProgram(const std::string &Program)
+{
+  const CheffeSourceFile File(
+      CheffeSourceBuffer::getMemBuffer("<generated>", Program));
+
+  CheffeDriver Driver;
+  Driver.setSourceFile(File);
+  auto Diagnostics = std::make_shared<CheffeDiagnosticHandler>();
+  Driver.setDiagnosticHandler(Diagnostics);
+
+  auto ProgramInfo = std::unique_ptr<CheffeProgramInfo>(nullptr);
+  EXPECT_EQ(Driver.compileProgram(ProgramInfo),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+  EXPECT_EQ(Diagnostics->getErrorCount(), 0u);
+  EXPECT_EQ(Diagnostics->getWarningCount(), 0u);
+}
+
+TEST(RecipeGeneratorTest, RecipeProgramsParse)
+{
+  for (unsigned Seed = 0; Seed < 8; ++Seed)
+  {
+    compileProgram(generateRecipeProgram(64 << 10, Seed));
+  }
+}
+
+TEST(RecipeGeneratorTest, ShapedProgramsParse)
+{
+  for (unsigned Seed = 0; Seed < 24; ++Seed)
+  {
+    GeneratorShape Shape;
+    Shape.TargetSize = 16 << 10;
+    Shape.RecipeCount = Seed % 5;
+    Shape.IngredientsPerRecipe = Seed % 7 + 1;
+    Shape.LoopDepth = Seed % 5;
+    Shape.Seed = Seed;
+    compileProgram(generateShapedProgram(Shape));
+  }
+}
+
+TEST(RecipeGeneratorTest, NumberDenseProgramsParse)
+{
+  for (unsigned Seed = 0; Seed < 8; ++Seed)
+  {
+    compileProgram(generateNumberDenseProgram(64 << 10, Seed));
+  }
+}
+
+TEST(RecipeGeneratorTest, LoopingRecipeProgramsParse)
+{
+  // Odd counts leave the last loop without an inner one.
+  compileProgram(generateLoopingRecipeProgram(1));
+  compileProgram(generateLoopingRecipeProgram(500));
+  compileProgram(generateLoopingRecipeProgram(501));
+}
@@ -0,0 +1,164 @@
+#include "gtest/gtest.h"
+
+#include "Server/CheffeServer.h"
+#include "Utils/CheffeJSON.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace cheffe;
+
+TEST(JSONTest, ParseValues)
+{
+  JSONValue Value;
+  std::string Error;
+  ASSERT_TRUE(JSONValue::parse(
+      " {\"a\": [1, -2.5e1, true, false, null], \"b\": {\"c\": \"d\"}} ", Value,
+      Error))
+      << Error;
+
+  const JSONValue *A = Value.get("a");
+  ASSERT_NE(A, nullptr);
+  ASSERT_EQ(A->getArray().size(), 5u);
+  ASSERT_EQ(A->getArray()[0].getNumber(), 1);
+  ASSERT_EQ(A->getArray()[1].getNumber(), -25);
+  ASSERT_TRUE(A->getArray()[2].getBool());
+  ASSERT_FALSE(A->getArray()[3].getBool());
+  ASSERT_TRUE(A->getArray()[4].isNull());
+  ASSERT_EQ(Value.get("b")->get("c")->getString(), "d");
+  ASSERT_EQ(Value.get("missing"), nullptr);
+  ASSERT_EQ(A->get("a"), nullptr);
+}
+
+TEST(JSONTest, ParseStringEscapes)
+{
+  JSONValue Value;
+  std::string Error;
+  ASSERT_TRUE(JSONValue::parse(
+      "\"q\\\"b\\\\s\\/n\\nt\\tu\\u00e9\\ud83c\\udf70\"", Value, Error))
+      << Error;
+  ASSERT_EQ(Value.getString(), "q\"b\\s/n\nt\tu\xc3\xa9\xf0\x9f\x8d\xb0");
+}
+
+TEST(JSONTest, ParseErrors)
+{
+  const char *Invalid[] = {"",         "{",          "[1,]",     "{\"a\" 1}",
+                           "\"abc",    "tru",        "01x",      "1 2",
+                           "\"\\x\"", "\"\\ud800\"", "{\"a\":}", "\"\t\""};
+  for (const char *Text : Invalid)
+  {
+    JSONValue Value;
+    std::string Error;
+    EXPECT_FALSE(JSONValue::parse(Text, Value, Error)) << Text;
+    EXPECT_FALSE(Error.empty()) << Text;
+  }
+
+  // Deeply nested documents are refused rather than recursed into.
+  JSONValue Value;
+  std::string Error;
+  ASSERT_FALSE(JSONValue::parse(std::string(10000, '['), Value, Error));
+}
+
+TEST(JSONTest, WriterRoundTrips)
+{
+  std::ostringstream OS;
+  JSONWriter Writer(OS);
+  Writer.objectBegin();
+  Writer.attribute("name");
+  Writer.value("a \"quoted\"\nline\x01");
+  Writer.attribute("list");
+  Writer.arrayBegin();
+  Writer.value(1u);
+  Writer.value(-2LL);
+  Writer.value(0.5);
+  Writer.value(true);
+  Writer.nullValue();
+  Writer.arrayBegin();
+  Writer.arrayEnd();
+  Writer.objectBegin();
+  Writer.objectEnd();
+  Writer.arrayEnd();
+  Writer.objectEnd();
+
+  ASSERT_EQ(OS.str(), "{\"name\":\"a \\\"quoted\\\"\\nline\\u0001\","
+                      "\"list\":[1,-2,0.5,true,null,[],{}]}");
+
+  JSONValue Value;
+  std::string Error;
+  ASSERT_TRUE(JSONValue::parse(OS.str(), Value, Error)) << Error;
+  ASSERT_EQ(Value.get("name")->getString(), "a \"quoted\"\nline\x01");
+  ASSERT_EQ(Value.get("list")->getArray().size(), 7u);
+}
+
+static std::vector<JSONValue> runServer(const std::string &Requests)
+{
+  std::istringstream In(Requests);
+  std::ostringstream Out;
+  CheffeServer Server(In, Out);
+  Server.run();
+
+  std::vector<JSONValue> Responses;
+  std::istringstream Lines(Out.str());
+  std::string Line;
+  while (std::getline(Lines, Line))
+  {
+    Responses.emplace_back();
+    std::string Error;
+    EXPECT_TRUE(JSONValue::parse(Line, Responses.back(), Error)) << Line;
+  }
+  return Responses;
+}
+
+TEST(ServerTest, RequestLoop)
+{
+  const std::vector<JSONValue> Responses = runServer(
+      "{\"id\": 1, \"method\": \"change\", \"params\": {\"offset\": 0, "
+      "\"length\": 0, \"text\": \"\"}}\n"
+      "{\"id\": 2, \"method\": \"open\", \"params\": {\"text\": "
+      "\"Soup.\\n\\nIngredients.\\n1 g salt\\n\\nMethod.\\n"
+      "Put salt into mixing bowl.\\n\"}}\n"
+      "\n"
+      "{\"id\": 3, \"method\": \"change\", \"params\": {\"offset\": 38, "
+      "\"length\": 3, \"text\": \"Pat\"}}\n"
+      "{\"id\": 4, \"method\": \"change\", \"params\": {\"offset\": 500, "
+      "\"length\": 0, \"text\": \"x\"}}\n"
+      "{\"id\": 5, \"method\": \"change\", \"params\": {\"offset\": -1, "
+      "\"length\": 0, \"text\": \"x\"}}\n"
+      "not json\n"
+      "{\"id\": \"six\", \"method\": \"reticulate\"}\n"
+      "{\"id\": 7, \"method\": \"shutdown\"}\n"
+      "{\"id\": 8, \"method\": \"shutdown\"}\n");
+
+  ASSERT_EQ(Responses.size(), 8u);
+
+  ASSERT_EQ(Responses[0].get("id")->getNumber(), 1);
+  ASSERT_EQ(Responses[0].get("error")->getString(), "no document is open");
+
+  const JSONValue *Result = Responses[1].get("result");
+  ASSERT_NE(Result, nullptr);
+  ASSERT_TRUE(Result->get("diagnostics")->getArray().empty());
+  ASSERT_EQ(Result->get("recipes")->getNumber(), 1);
+  ASSERT_EQ(Result->get("reparsed")->getNumber(), 1);
+
+  Result = Responses[2].get("result");
+  ASSERT_NE(Result, nullptr);
+  const auto &Diagnostics = Result->get("diagnostics")->getArray();
+  ASSERT_EQ(Diagnostics.size(), 1u);
+  ASSERT_EQ(Diagnostics[0].get("severity")->getString(), "error");
+  ASSERT_EQ(Diagnostics[0].get("message")->getString(),
+            "Invalid Method Step Keyword: 'Pat'");
+  ASSERT_EQ(Diagnostics[0].get("line")->getNumber(), 7);
+  ASSERT_EQ(Diagnostics[0].get("column")->getNumber(), 1);
+  ASSERT_EQ(Diagnostics[0].get("offset")->getNumber(), 38);
+  ASSERT_EQ(Diagnostics[0].get("length")->getNumber(), 3);
+
+  ASSERT_NE(Responses[3].get("error"), nullptr);
+  ASSERT_NE(Responses[4].get("error"), nullptr);
+  ASSERT_TRUE(Responses[5].get("id")->isNull());
+  ASSERT_NE(Responses[5].get("error"), nullptr);
+  ASSERT_EQ(Responses[6].get("id")->getString(), "six");
+  ASSERT_NE(Responses[6].get("error"), nullptr);
+  ASSERT_EQ(Responses[7].get("id")->getNumber(), 7);
+  ASSERT_TRUE(Responses[7].get("result")->isNull());
+}
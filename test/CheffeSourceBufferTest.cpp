@@ -0,0 +1,77 @@
+#include "gtest/gtest.h"
+
+#include "cheffe.h"
+#include "Utils/CheffeFileHandler.h"
+#include "Utils/CheffeSourceBuffer.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace cheffe;
+
+TEST(SourceBufferTest, FileContentsMatch)
+{
+  const std::string FileName =
+      std::string(TEST_ROOT_PATH) + "/JITExecution/hello.ch";
+
+  auto Buffer = CheffeSourceBuffer::getFile(FileName);
+  ASSERT_TRUE(Buffer != nullptr);
+
+  std::ifstream InStream(FileName, std::ios::in | std::ios::binary);
+  std::stringstream Expected;
+  Expected << InStream.rdbuf();
+
+  ASSERT_EQ(Buffer->getBuffer().str(), Expected.str());
+  ASSERT_EQ(Buffer->getName(), FileName);
+}
+
+TEST(SourceBufferTest, MissingFile)
+{
+  ASSERT_TRUE(CheffeSourceBuffer::getFile(std::string(TEST_ROOT_PATH) +
+                                          "/does-not-exist.ch") == nullptr);
+
+  CheffeSourceFile File;
+  ASSERT_EQ(CheffeFileHandler::readFile(std::string(TEST_ROOT_PATH) +
+                                            "/does-not-exist.ch",
+                                        File),
+            CheffeErrorCode::CHEFFE_ERROR);
+  ASSERT_TRUE(File.empty());
+}
+
+// Copies of a source file all refer to the one buffer.
+TEST(SourceBufferTest, CopiesShareText)
+{
+  CheffeSourceFile File;
+  ASSERT_EQ(CheffeFileHandler::readFile(
+                std::string(TEST_ROOT_PATH) + "/JITExecution/hello.ch", File),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+
+  const CheffeSourceFile Copy = File;
+  ASSERT_FALSE(Copy.empty());
+  ASSERT_EQ(Copy.getSource().data(), File.getSource().data());
+  ASSERT_EQ(Copy.size(), File.size());
+}
+
+TEST(SourceBufferTest, LineIndex)
+{
+  auto Buffer = CheffeSourceBuffer::getMemBuffer("<lines>", "ab\n\ncde\nf");
+
+  ASSERT_EQ(Buffer->getNumLines(), 4u);
+  ASSERT_EQ(Buffer->getLine(1).str(), "ab");
+  ASSERT_EQ(Buffer->getLine(2).str(), "");
+  ASSERT_EQ(Buffer->getLine(3).str(), "cde");
+  ASSERT_EQ(Buffer->getLine(4).str(), "f");
+  ASSERT_TRUE(Buffer->getLine(5).empty());
+
+  ASSERT_EQ(Buffer->getLineNumber(0), 1u);
+  ASSERT_EQ(Buffer->getLineNumber(2), 1u);
+  ASSERT_EQ(Buffer->getLineNumber(3), 2u);
+  ASSERT_EQ(Buffer->getLineNumber(4), 3u);
+  ASSERT_EQ(Buffer->getLineNumber(8), 4u);
+  ASSERT_EQ(Buffer->getLineNumber(9), 4u);
+
+  ASSERT_EQ(Buffer->getColumnNumber(0), 1u);
+  ASSERT_EQ(Buffer->getColumnNumber(6), 3u);
+  ASSERT_EQ(Buffer->getColumnNumber(8), 1u);
+}
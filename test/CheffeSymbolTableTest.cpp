@@ -0,0 +1,34 @@
+#include "gtest/gtest.h"
+
+#include "IR/CheffeSymbolTable.h"
+
+using namespace cheffe;
+
+TEST(SymbolTableTest, InternIsIdempotent)
+{
+  CheffeSymbolTable Symbols;
+
+  const CheffeSymbol Flour = Symbols.intern("flour");
+  const CheffeSymbol Sugar = Symbols.intern("caster sugar");
+
+  ASSERT_NE(Flour, Sugar);
+  ASSERT_EQ(Flour, Symbols.intern("flour"));
+  ASSERT_EQ(Sugar, Symbols.intern("caster sugar"));
+  ASSERT_EQ(Symbols.size(), 2u);
+
+  ASSERT_EQ(Symbols.getName(Flour), "flour");
+  ASSERT_EQ(Symbols.getName(Sugar), "caster sugar");
+}
+
+TEST(SymbolTableTest, LookupDoesNotIntern)
+{
+  CheffeSymbolTable Symbols;
+  const CheffeSymbol Eggs = Symbols.intern("eggs");
+
+  CheffeSymbol Found = Eggs + 1;
+  ASSERT_TRUE(Symbols.lookup("eggs", Found));
+  ASSERT_EQ(Found, Eggs);
+
+  ASSERT_FALSE(Symbols.lookup("Eggs", Found));
+  ASSERT_EQ(Symbols.size(), 1u);
+}
@@ -0,0 +1,109 @@
+#include "gtest/gtest.h"
+
+#include "CheffeWorkloadGenerator.h"
+#include "Driver/CheffeDriver.h"
+#include "IR/CheffeProgramInfo.h"
+#include "JIT/CheffeJIT.h"
+#include "Utils/CheffeFileHandler.h"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace cheffe;
+
+// Compiles and runs a generated workload, feeding it its own input, and
+// returns what it printed.
+static std::string runWorkload(const GeneratedWorkload &Workload)
+{
+  const CheffeSourceFile File(
+      CheffeSourceBuffer::getMemBuffer("<generated>", Workload.Program));
+
+  CheffeDriver Driver;
+  Driver.setSourceFile(File);
+  auto Diagnostics = std::make_shared<CheffeDiagnosticHandler>();
+  Driver.setDiagnosticHandler(Diagnostics);
+
+  auto ProgramInfo = std::unique_ptr<CheffeProgramInfo>(nullptr);
+  EXPECT_EQ(Driver.compileProgram(ProgramInfo),
+            CheffeErrorCode::CHEFFE_SUCCESS);
+  EXPECT_EQ(Diagnostics->getErrorCount(), 0u);
+  EXPECT_EQ(Diagnostics->getWarningCount(), 0u);
+  if (!ProgramInfo)
+  {
+    return std::string();
+  }
+
+  std::istringstream In(Workload.Input);
+  std::ostringstream Out;
+  std::streambuf *OldIn = std::cin.rdbuf(In.rdbuf());
+  std::streambuf *OldOut = std::cout.rdbuf(Out.rdbuf());
+
+  CheffeJIT JIT(std::move(ProgramInfo), Diagnostics);
+  const CheffeErrorCode Success = JIT.executeProgram();
+
+  std::cin.rdbuf(OldIn);
+  std::cout.rdbuf(OldOut);
+
+  EXPECT_EQ(Success, CheffeErrorCode::CHEFFE_SUCCESS);
+  // Every Take step found a number waiting for it, and nothing more.
+  EXPECT_FALSE(In >> std::ws && In.good());
+  return Out.str();
+}
+
+static unsigned long long countValues(const std::string &Output)
+{
+  std::istringstream Values(Output);
+  unsigned long long Count = 0;
+  long long Value = 0;
+  while (Values >> Value)
+  {
+    ++Count;
+  }
+  return Count;
+}
+
+TEST(WorkloadGeneratorTest, DefaultShape)
+{
+  const GeneratedWorkload Workload = generateWorkload(WorkloadShape());
+  ASSERT_TRUE(Workload.Input.empty());
+  ASSERT_EQ(countValues(runWorkload(Workload)), 16u);
+
+  // The same shape always makes the same program.
+  ASSERT_EQ(generateWorkload(WorkloadShape()).Program, Workload.Program);
+}
+
+TEST(WorkloadGeneratorTest, ShapesParseAndRun)
+{
+  for (unsigned Seed = 0; Seed < 24; ++Seed)
+  {
+    WorkloadShape Shape;
+    Shape.Seed = Seed;
+    Shape.RecipeCount = Seed % 5 + 1;
+    Shape.IngredientsPerRecipe = Seed % 7 + 1;
+    Shape.StatementsPerLoop = Seed % 4 * 4;
+    Shape.LoopDepth = Seed % 4;
+    Shape.LoopIterations = Seed % 2 + 1;
+    Shape.Serving = Seed % 2 ? ServePattern::Chain : ServePattern::FanOut;
+    Shape.RecursionDepth = Seed % 3 ? 0 : Seed;
+    Shape.BowlSpread = Seed % 13 + 1;
+    Shape.OutputValues = Seed * 7;
+    Shape.TakeCount = Seed % 3;
+
+    const GeneratedWorkload Workload = generateWorkload(Shape);
+    ASSERT_EQ(countValues(runWorkload(Workload)), Shape.OutputValues)
+        << Workload.Program;
+  }
+}
+
+TEST(WorkloadGeneratorTest, TakesMatchInput)
+{
+  WorkloadShape Shape;
+  Shape.LoopDepth = 3;
+  Shape.LoopIterations = 5;
+  Shape.TakeCount = 2;
+
+  const GeneratedWorkload Workload = generateWorkload(Shape);
+  ASSERT_EQ(countValues(Workload.Input), 2u * 5 * 5 * 5);
+  ASSERT_EQ(countValues(runWorkload(Workload)), 16u);
+}